@@ -49,6 +49,7 @@ if(Linux)
         check_lib(LIBUDEV libudev libudev.h)
     endif()
 endif()
+check_lib(ZSTD zstd zstd.h)
 
 #----------------------------------------
 #		    Use system include
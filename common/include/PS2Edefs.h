@@ -123,6 +123,13 @@ void CALLBACK GSsetGameCRC(int crc, int gameoptions);
 // controls frame skipping in the GS, if this routine isn't present, frame skipping won't be done
 void CALLBACK GSsetFrameSkip(int frameskip);
 
+// logs transfer/unswizzle throughput of the local memory paths for each format
+void CALLBACK GSBenchmark();
+
+// logs the SW rasterizer threads' throughput on a synthetic sprite stream, split by
+// scanline bands and by tiles
+void CALLBACK GSRasterizerBenchmark();
+
 // if start is 1, starts recording spu2 data, else stops
 // returns a non zero value if successful
 // for now, pData is not used
@@ -243,6 +243,16 @@ extern void MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mo
 
 extern void Munmap(void *base, size_t size);
 
+// Shared memory objects can be mapped at several host addresses at once, so that the same
+// physical pages show up in more than one place (used by the EE fastmem window).
+// CreateSharedMemory returns NULL if the host can't provide such an object.
+extern void *CreateSharedMemory(size_t size);
+extern void DestroySharedMemory(void *handle);
+
+// Maps [offset, offset+size) of the shared memory object over the reserved pages at baseaddr.
+// Use MmapResetPtr to return the pages to the reserve.
+extern bool MapSharedMemory(void *handle, size_t offset, void *baseaddr, size_t size, const PageProtectionMode &mode);
+
 template <uint size>
 void MemProtectStatic(u8 (&arr)[size], const PageProtectionMode &mode)
 {
@@ -31,9 +31,14 @@ struct PageFaultInfo
 {
     uptr addr;
 
-    PageFaultInfo(uptr address)
+    // Host instruction that caused the fault, or 0 if the platform handler can't tell.
+    // Used to backpatch recompiled fastmem accesses.
+    uptr pc;
+
+    PageFaultInfo(uptr address, uptr faultpc = 0)
     {
         addr = address;
+        pc = faultpc;
     }
 };
 
@@ -0,0 +1,73 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Kept free of wx so the GS plugin can place its rasterizer workers too.
+
+#include <vector>
+
+namespace Threading
+{
+// --------------------------------------------------------------------------------------
+//  Thread placement
+// --------------------------------------------------------------------------------------
+// EE, MTGS and MTVU each get a physical core of their own (all of its SMT siblings), GS
+// rasterizer workers are spread over the cores that are left.  Placement needs at least
+// one core for the GS workers on top of the dedicated ones; on smaller machines (and on
+// platforms without a topology reader, currently everything but Linux) it's left to the OS.
+
+enum class ThreadRole
+{
+	EE = 0,
+	MTGS,
+	MTVU,
+	GSWorker,
+};
+
+enum class ThreadPlacementMode
+{
+	Disabled = 0, // scheduling left to the OS
+	Pinned,       // threads pinned to physical cores
+	Realtime,     // pinned, and EE/MTGS/MTVU on the round-robin realtime class
+};
+
+struct CpuCore
+{
+	int package;
+	int core;
+	std::vector<int> cpus; // logical CPUs (SMT siblings) of this core
+};
+
+// Physical cores this process may run on, ordered by package and core id.
+extern const std::vector<CpuCore>& GetCpuTopology();
+
+// Threads pick up a new mode the next time they call PlaceCurrentThread.
+extern void SetThreadPlacementMode(ThreadPlacementMode mode);
+extern ThreadPlacementMode GetThreadPlacementMode();
+
+// Cheap once the current thread is placed for the current mode, so it can be called from
+// loops that run on whatever thread the frontend provides (MTGS under libretro).
+// Returns true if the thread is pinned.
+extern bool PlaceCurrentThread(ThreadRole role, int index = 0);
+
+// Gives the current thread back the affinity and scheduling policy it had before it was
+// first placed.  For threads that aren't ours, the frontend's thread under libretro.
+extern void RestoreCurrentThread();
+
+// Runs a synthetic EE -> MTGS -> GS workers frame pipeline with placement disabled and
+// pinned, and logs the mean, deviation and worst frame time of each.
+extern void ThreadPlacementBenchmark(int frames = 600);
+}
@@ -21,6 +21,7 @@
 
 #include <sys/mman.h>
 #include <signal.h>
+#include <ucontext.h>
 #include <errno.h>
 #include <unistd.h>
 
@@ -34,8 +35,22 @@ extern void SignalExit(int sig);
 
 static const uptr m_pagemask = getpagesize() - 1;
 
+static uptr GetFaultPC(void *_context)
+{
+    const ucontext_t *context = (const ucontext_t *)_context;
+#if defined(__APPLE__) && defined(__x86_64__)
+    return context->uc_mcontext->__ss.__rip;
+#elif defined(__linux__) && defined(__x86_64__)
+    return context->uc_mcontext.gregs[REG_RIP];
+#elif defined(__linux__) && defined(__i386__)
+    return context->uc_mcontext.gregs[REG_EIP];
+#else
+    return 0;
+#endif
+}
+
 // Linux implementation of SIGSEGV handler.  Bind it using sigaction().
-static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *)
+static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *_context)
 {
     // [TODO] : Add a thread ID filter to the Linux Signal handler here.
     // Rationale: On windows, the __try/__except model allows per-thread specific behavior
@@ -59,7 +74,7 @@ static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *)
     // so for now we lock this exception code unless someone can fix this better...
     Threading::ScopedLock lock(PageFault_Mutex);
 
-    Source_PageFault->Dispatch(PageFaultInfo((uptr)siginfo->si_addr & ~m_pagemask));
+    Source_PageFault->Dispatch(PageFaultInfo((uptr)siginfo->si_addr & ~m_pagemask, GetFaultPC(_context)));
 
     // resumes execution right where we left off (re-executes instruction that
     // caused the SIGSEGV).
@@ -216,6 +231,47 @@ void HostSys::Munmap(uptr base, size_t size)
     munmap((void *)base, size);
 }
 
+// The shared memory handle is the file descriptor plus one, so that NULL can mean failure.
+void *HostSys::CreateSharedMemory(size_t size)
+{
+    PageSizeAssertionTest(size);
+
+#ifdef __linux__
+    const int fd = memfd_create("pcsx2", MFD_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    return (void *)(uptr)(fd + 1);
+#else
+    return NULL;
+#endif
+}
+
+void HostSys::DestroySharedMemory(void *handle)
+{
+    if (handle)
+        close((int)(uptr)handle - 1);
+}
+
+bool HostSys::MapSharedMemory(void *handle, size_t offset, void *baseaddr, size_t size, const PageProtectionMode &mode)
+{
+    PageSizeAssertionTest(size);
+
+    uint lnxmode = PROT_NONE;
+    if (mode.CanWrite())
+        lnxmode |= PROT_WRITE;
+    if (mode.CanRead())
+        lnxmode |= PROT_READ;
+
+    void *result = mmap(baseaddr, size, lnxmode, MAP_SHARED | MAP_FIXED, (int)(uptr)handle - 1, offset);
+    return result == baseaddr;
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     if (!_memprotect(baseaddr, size, mode)) {
@@ -0,0 +1,380 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "ThreadPlacement.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace Threading;
+
+static const int DedicatedRoles = 3; // EE, MTGS, MTVU
+
+static std::mutex s_placement_lock;
+static std::atomic<int> s_placement_generation(0);
+static ThreadPlacementMode s_placement_mode = ThreadPlacementMode::Disabled;
+
+static thread_local int t_placement_generation = -1;
+static thread_local bool t_placed = false;
+static thread_local bool t_realtime = false;
+
+#if defined(__linux__)
+
+static int ReadSysfsInt(int cpu, const char* name)
+{
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+
+	FILE* fp = fopen(path, "r");
+	if (!fp)
+		return -1;
+
+	int value = -1;
+	if (fscanf(fp, "%d", &value) != 1)
+		value = -1;
+	fclose(fp);
+	return value;
+}
+
+// Built on first use, which is before anything is pinned: the affinity mask of the calling
+// thread is still the one the process was started with (taskset, cgroups).
+static std::vector<CpuCore> ReadCpuTopology()
+{
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		return {};
+
+	std::map<std::pair<int, int>, CpuCore> cores;
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (!CPU_ISSET(cpu, &allowed))
+			continue;
+
+		int package = ReadSysfsInt(cpu, "physical_package_id");
+		int core = ReadSysfsInt(cpu, "core_id");
+		if (package < 0 || core < 0)
+		{
+			// No topology (some containers and VMs): every logical CPU is a core.
+			package = 0;
+			core = cpu;
+		}
+
+		CpuCore& entry = cores[std::make_pair(package, core)];
+		entry.package = package;
+		entry.core = core;
+		entry.cpus.push_back(cpu);
+	}
+
+	std::vector<CpuCore> result;
+	for (auto& entry : cores)
+		result.push_back(std::move(entry.second));
+	return result;
+}
+
+static bool SetCurrentThreadAffinity(const std::vector<int>& cpus)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu : cpus)
+		CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+static bool SetCurrentThreadRealtime(bool realtime)
+{
+	sched_param param = {};
+	param.sched_priority = realtime ? sched_get_priority_min(SCHED_RR) : 0;
+	return pthread_setschedparam(pthread_self(), realtime ? SCHED_RR : SCHED_OTHER, &param) == 0;
+}
+
+// Affinity and scheduling of a thread from before it was first placed.
+struct SavedThreadState
+{
+	bool valid;
+	cpu_set_t affinity;
+	int policy;
+	sched_param param;
+};
+
+static thread_local SavedThreadState t_saved = {};
+
+static void SaveCurrentThreadState()
+{
+	if (t_saved.valid)
+		return;
+
+	t_saved.valid = pthread_getaffinity_np(pthread_self(), sizeof(t_saved.affinity), &t_saved.affinity) == 0 &&
+		pthread_getschedparam(pthread_self(), &t_saved.policy, &t_saved.param) == 0;
+}
+
+static bool RestoreCurrentThreadState()
+{
+	if (!t_saved.valid)
+		return false;
+
+	t_saved.valid = false;
+	const bool affinity = pthread_setaffinity_np(pthread_self(), sizeof(t_saved.affinity), &t_saved.affinity) == 0;
+	const bool sched = pthread_setschedparam(pthread_self(), t_saved.policy, &t_saved.param) == 0;
+	return affinity && sched;
+}
+
+#else
+
+static std::vector<CpuCore> ReadCpuTopology()
+{
+	return {};
+}
+
+static bool SetCurrentThreadAffinity(const std::vector<int>& cpus)
+{
+	return false;
+}
+
+static bool SetCurrentThreadRealtime(bool realtime)
+{
+	return false;
+}
+
+static void SaveCurrentThreadState()
+{
+}
+
+static bool RestoreCurrentThreadState()
+{
+	return false;
+}
+
+#endif
+
+const std::vector<CpuCore>& Threading::GetCpuTopology()
+{
+	static const std::vector<CpuCore> topology = ReadCpuTopology();
+	return topology;
+}
+
+void Threading::SetThreadPlacementMode(ThreadPlacementMode mode)
+{
+	const std::vector<CpuCore>& topology = GetCpuTopology();
+
+	{
+		std::lock_guard<std::mutex> lock(s_placement_lock);
+		if (s_placement_mode == mode)
+			return;
+		s_placement_mode = mode;
+		s_placement_generation++;
+	}
+
+	if (mode == ThreadPlacementMode::Disabled)
+		log_cb(RETRO_LOG_INFO, "Thread placement: disabled\n");
+	else if (topology.size() <= DedicatedRoles)
+		log_cb(RETRO_LOG_WARN, "Thread placement: %zu physical core(s) found, %d needed, leaving placement to the OS\n", topology.size(), DedicatedRoles + 1);
+	else
+	{
+		log_cb(RETRO_LOG_INFO, "Thread placement: %zu physical cores, EE/MTGS/MTVU on cores 0-2, GS workers on %zu core(s)%s\n",
+			topology.size(), topology.size() - DedicatedRoles, mode == ThreadPlacementMode::Realtime ? ", realtime priority" : "");
+	}
+}
+
+ThreadPlacementMode Threading::GetThreadPlacementMode()
+{
+	std::lock_guard<std::mutex> lock(s_placement_lock);
+	return s_placement_mode;
+}
+
+bool Threading::PlaceCurrentThread(ThreadRole role, int index)
+{
+	const int generation = s_placement_generation.load(std::memory_order_acquire);
+	if (t_placement_generation == generation)
+		return t_placed;
+	t_placement_generation = generation;
+
+	const ThreadPlacementMode mode = GetThreadPlacementMode();
+	const std::vector<CpuCore>& topology = GetCpuTopology();
+	const bool pin = mode != ThreadPlacementMode::Disabled && topology.size() > DedicatedRoles;
+	const bool realtime = pin && mode == ThreadPlacementMode::Realtime && role != ThreadRole::GSWorker;
+
+	if (pin || realtime)
+		SaveCurrentThreadState();
+
+	if (pin)
+	{
+		const size_t core = (role == ThreadRole::GSWorker) ?
+			DedicatedRoles + index % (topology.size() - DedicatedRoles) :
+			static_cast<size_t>(role);
+		t_placed = SetCurrentThreadAffinity(topology[core].cpus);
+	}
+	else if (t_placed)
+	{
+		// Hand a thread that used to be pinned back to every CPU the process may use.
+		std::vector<int> cpus;
+		for (const CpuCore& core : topology)
+			cpus.insert(cpus.end(), core.cpus.begin(), core.cpus.end());
+		t_placed = !SetCurrentThreadAffinity(cpus);
+	}
+
+	if (realtime != t_realtime)
+	{
+		if (SetCurrentThreadRealtime(realtime))
+			t_realtime = realtime;
+		else if (realtime)
+			log_cb(RETRO_LOG_WARN, "Thread placement: realtime priority was refused (missing CAP_SYS_NICE or RLIMIT_RTPRIO?)\n");
+	}
+
+	return t_placed;
+}
+
+void Threading::RestoreCurrentThread()
+{
+	if (!RestoreCurrentThreadState() && (t_placed || t_realtime))
+		log_cb(RETRO_LOG_WARN, "Thread placement: could not restore the thread's affinity and priority\n");
+
+	t_placement_generation = -1;
+	t_placed = false;
+	t_realtime = false;
+}
+
+// --------------------------------------------------------------------------------------
+//  ThreadPlacementBenchmark
+// --------------------------------------------------------------------------------------
+// A frame goes EE -> MTGS -> GS workers like it does in the emulator: EE runs one frame
+// ahead of MTGS, MTGS hands every frame to all workers and waits for them.  The work items
+// are fixed integer loops, so any change in frame time comes from scheduling.
+
+static u32 PlacementBenchWork(int iterations)
+{
+	u32 x = 0x9E3779B9;
+	for (int i = 0; i < iterations; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+	}
+	return x;
+}
+
+void Threading::ThreadPlacementBenchmark(int frames)
+{
+	typedef std::chrono::steady_clock clock;
+
+	static const int EEWork = 1500000;
+	static const int MTGSWork = 500000;
+	static const int WorkerWork = 1000000;
+	static const int Warmup = 10;
+
+	const ThreadPlacementMode saved = GetThreadPlacementMode();
+	const int workers = std::min<int>(std::max<int>(GetCpuTopology().size() - DedicatedRoles, 1), 8);
+	const ThreadPlacementMode modes[] = {ThreadPlacementMode::Disabled, ThreadPlacementMode::Pinned, ThreadPlacementMode::Realtime};
+	const char* names[] = {"disabled", "pinned", "realtime"};
+
+	for (int m = 0; m < 3; m++)
+	{
+		SetThreadPlacementMode(modes[m]);
+
+		std::mutex lock;
+		std::condition_variable cv;
+		int ee_done = 0, gs_issued = 0, gs_done = 0, mtgs_done = 0;
+		std::atomic<u32> sink(0);
+		std::vector<clock::time_point> finished(frames);
+
+		std::thread ee([&] {
+			PlaceCurrentThread(ThreadRole::EE);
+			for (int f = 0; f < frames; f++)
+			{
+				sink += PlacementBenchWork(EEWork);
+				std::unique_lock<std::mutex> l(lock);
+				ee_done = f + 1;
+				cv.notify_all();
+				cv.wait(l, [&] { return mtgs_done >= f; });
+			}
+		});
+
+		std::vector<std::thread> gs;
+		for (int i = 0; i < workers; i++)
+		{
+			gs.emplace_back([&, i] {
+				PlaceCurrentThread(ThreadRole::GSWorker, i);
+				for (int f = 0; f < frames; f++)
+				{
+					{
+						std::unique_lock<std::mutex> l(lock);
+						cv.wait(l, [&] { return gs_issued > f; });
+					}
+					sink += PlacementBenchWork(WorkerWork);
+					std::lock_guard<std::mutex> l(lock);
+					gs_done++;
+					cv.notify_all();
+				}
+			});
+		}
+
+		std::thread mtgs([&] {
+			PlaceCurrentThread(ThreadRole::MTGS);
+			for (int f = 0; f < frames; f++)
+			{
+				{
+					std::unique_lock<std::mutex> l(lock);
+					cv.wait(l, [&] { return ee_done > f; });
+				}
+				sink += PlacementBenchWork(MTGSWork);
+				std::unique_lock<std::mutex> l(lock);
+				gs_issued = f + 1;
+				cv.notify_all();
+				cv.wait(l, [&] { return gs_done == workers * (f + 1); });
+				finished[f] = clock::now();
+				mtgs_done = f + 1;
+				cv.notify_all();
+			}
+		});
+
+		ee.join();
+		mtgs.join();
+		for (std::thread& t : gs)
+			t.join();
+
+		std::vector<double> times;
+		for (int f = Warmup + 1; f < frames; f++)
+			times.push_back(std::chrono::duration<double, std::milli>(finished[f] - finished[f - 1]).count());
+		if (times.empty())
+			continue;
+
+		double sum = 0, worst = 0;
+		for (double t : times)
+		{
+			sum += t;
+			worst = std::max(worst, t);
+		}
+		const double mean = sum / times.size();
+		double var = 0;
+		for (double t : times)
+			var += (t - mean) * (t - mean);
+		var /= times.size();
+
+		log_cb(RETRO_LOG_INFO, "Thread placement benchmark: %-8s %zu frames, %d GS worker(s), mean %.3f ms, stddev %.3f ms (var %.4f), worst %.3f ms [%08x]\n",
+			names[m], times.size(), workers, mean, std::sqrt(var), var, worst, sink.load());
+	}
+
+	SetThreadPlacementMode(saved);
+}
@@ -28,7 +28,12 @@ static long DoSysPageFaultExceptionFilter(EXCEPTION_POINTERS *eps)
     // Source_PageFault is a global variable with its own state information
     // so for now we lock this exception code unless someone can fix this better...
     Threading::ScopedLock lock(PageFault_Mutex);
-    Source_PageFault->Dispatch(PageFaultInfo((uptr)eps->ExceptionRecord->ExceptionInformation[1]));
+#ifdef _WIN64
+    const uptr pc = eps->ContextRecord->Rip;
+#else
+    const uptr pc = eps->ContextRecord->Eip;
+#endif
+    Source_PageFault->Dispatch(PageFaultInfo((uptr)eps->ExceptionRecord->ExceptionInformation[1], pc));
     return Source_PageFault->WasHandled() ? EXCEPTION_CONTINUE_EXECUTION : EXCEPTION_CONTINUE_SEARCH;
 }
 
@@ -133,6 +138,23 @@ void HostSys::Munmap(uptr base, size_t size)
     VirtualFree((void *)base, 0, MEM_RELEASE);
 }
 
+// File mapping views can only be placed at allocation granularity (64k) boundaries, which
+// is too coarse to mirror the 4k pages of the PS2 address space.  Without a shared memory
+// object the vtlb simply runs without fastmem.
+void *HostSys::CreateSharedMemory(size_t size)
+{
+    return NULL;
+}
+
+void HostSys::DestroySharedMemory(void *handle)
+{
+}
+
+bool HostSys::MapSharedMemory(void *handle, size_t offset, void *baseaddr, size_t size, const PageProtectionMode &mode)
+{
+    return false;
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     pxAssertDev(((size & (__pagesize - 1)) == 0), pxsFmt(
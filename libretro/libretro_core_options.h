@@ -62,6 +62,18 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"disabled"},
 
+#ifdef PCSX2_ZSTD
+	{BOOL_PCSX2_OPT_CONVERT_ZSTD,
+	"System: Convert Disc Image to zstd",
+	"While the content runs, writes a seekable zstd copy (.zst) of its disc image next to it on one idle priority thread, or into the save folder if the game folder is read-only. The copy loads like any other image and is much smaller than an ISO. Nothing is written if the .zst already exists, an unfinished copy is removed when the content is closed. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled"},
+#endif
+
 	{STRING_PCSX2_OPT_MEMCARD_SLOT_1,
 	"Memory Card: Slot 1",
 	"Select the primary memory card to use. 'Legacy' points to the memory card Mcd001 in the old location system/pcsx2/memcards. (Content restart required)",
@@ -92,6 +104,16 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"Auto"},
 
+	{BOOL_PCSX2_OPT_SW_TILE_BINNING,
+	"Video: Software Renderer Tile Binning",
+	"Splits the software renderer's work between its threads by 64x64 screen tiles instead of scanline bands, which can be faster in scenes with a lot of overdraw. Only applies to the software renderer. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled" },
+
 	{INT_PCSX2_OPT_UPSCALE_MULTIPLIER,
 	"Video: Internal Resolution ",
 	NULL,
@@ -352,6 +374,82 @@ struct retro_core_option_definition option_defs[] = {
 	},
 	"2" },
 
+	{INT_PCSX2_OPT_THREAD_PLACEMENT,
+	"Emulation: Thread Placement",
+	"Pins the EE, MTGS and MTVU threads to physical cores of their own and the software renderer threads to the remaining ones, which can make frame times steadier. Needs at least 4 cores. Realtime priority needs the permission to use it. (Content restart required)",
+	{
+		{"0", "Disabled (default)"},
+		{"1", "Pinned"},
+		{"2", "Pinned + Realtime Priority"},
+		{NULL, NULL},
+	},
+	"0" },
+
+	{INT_PCSX2_OPT_FRAME_TELEMETRY,
+	"Emulation: Frame Telemetry",
+	"Logs where each frame's time went (EE, GS, MTGS wait, MTVU, SPU2, CDVD, JIT) to help report stutter. 'Summary' logs averages and the worst frame every 600 frames, 'Summary + Stutters' also logs every frame that took over 1.5x its budget. The last frames are also logged when content is closed.",
+	{
+		{"0", "Disabled (default)"},
+		{"1", "Summary"},
+		{"2", "Summary + Stutters"},
+		{NULL, NULL},
+	},
+	"0" },
+
+	{BOOL_PCSX2_OPT_RUNAHEAD_SNAPSHOTS,
+	"Emulation: Run-Ahead Snapshots",
+	"Lets the frontend's Run-Ahead save and restore the emulated machine in memory. The EE waits for the frontend at every vsync while enabled, which costs some speed. Only Run-Ahead can use these snapshots, regular savestates are not affected.",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled" },
+
+	{BOOL_PCSX2_OPT_SPU2_BLOCK_MIXING,
+	"Emulation: SPU2 Block Mixing",
+	"Mixes the SPU2 voices several samples at a time whenever the result is the same as mixing them one sample at a time. Disable to rule it out when looking into audio issues.",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"enabled" },
+
+	{BOOL_PCSX2_OPT_FASTMEM,
+	"Emulation: Fastmem",
+	"Lets EE recompiled code access main memory through a 4GB host mapping of the PS2 address space instead of looking every address up. Faster, but needs a 64-bit Linux host; elsewhere, or if the mapping can't be set up, the regular lookups are used. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"enabled", NULL},
+		{NULL, NULL},
+	},
+	"disabled" },
+
+	{STRING_PCSX2_OPT_BENCHMARK,
+	"Emulation: Benchmark",
+	"Runs a benchmark once with the content and logs its results, for checking changes to the emulator. 'Core' runs test programs on the EE, IOP and VU0 interpreters and recompilers, 'GS Local Memory' times GS memory transfers and texture reads, 'GS SW Rasterizer' draws a synthetic sprite and overdraw stream on the software renderer threads split by scanline bands and by tiles, 'Disc Image Reads' reads the loaded image mapped and through libaio (Linux), 'Disc Image Formats' writes a test image as iso, cso, gz and zst into the cache folder and reads each back, 'SPU2 Mixer' mixes synthetic voices per voice, batched and in blocks and checks they match, 'SPU2 Reverb' runs the reverb per tap and vectorized and checks they match, 'IPU' decodes a synthetic MPEG-2 stream with the C and the SIMD IDCT and checks they match, 'Patch Databases' parses every game of the widescreen and no-interlacing archives with both patch parsers and checks they match, 'Thread Placement' times a synthetic EE/MTGS/GS frame pipeline with each thread placement mode, 'EE Event Tests' times the EE's event scan against a deadline heap on synthetic events and checks they match. These run before the content boots and add a few seconds to it. 'Savestates' compresses the running game's state in memory with each codec, on one thread and on all cores, and 'Run-Ahead Snapshots' captures and restores it in memory, a while after boot. (Content restart required)",
+	{
+		{"disabled", NULL},
+		{"core", "Core"},
+		{"gs", "GS Local Memory"},
+		{"rasterizer", "GS SW Rasterizer"},
+#ifdef __linux__
+		{"disc", "Disc Image Reads"},
+#endif
+		{"readers", "Disc Image Formats"},
+		{"spu2", "SPU2 Mixer"},
+		{"reverb", "SPU2 Reverb"},
+		{"ipu", "IPU"},
+		{"patches", "Patch Databases"},
+		{"threads", "Thread Placement"},
+		{"events", "EE Event Tests"},
+		{"savestate", "Savestates"},
+		{"snapshots", "Run-Ahead Snapshots"},
+		{NULL, NULL},
+	},
+	"disabled" },
+
 	{INT_PCSX2_OPT_CLAMPING_MODE,
 	"Emulation: Clamping Mode",
 	"Clamping mode can fix some bugs on some games. Default value is fine for most games. (Content restart required)",
@@ -28,7 +28,17 @@
 #include "disk_control.h"
 #include "SPU2/Global.h"
 #include "ps2/BiosTools.h"
+#include "Patch.h"
+#include "GameDatabase.h"
+#include "x86/newVif.h"
+#include "Utilities/ThreadPlacement.h"
+#include "FrameTelemetry.h"
+#include "SaveStateSnapshot.h"
+#include "Benchmarks.h"
 #include "memcard_retro.h"
+#ifdef PCSX2_ZSTD
+#include "CDVD/ZstdFileReader.h"
+#endif
 
 
 
@@ -303,6 +313,7 @@ void retro_init(void)
 
 	// some other stuffs about pcsx2
 
+	SysMarkBootStart();
 	if (pcsx2->DetectCpuAndUserMode())
 	{
 		pcsx2->AllocateCoreStuffs();
@@ -365,6 +376,8 @@ void retro_init(void)
 		g_Conf->EmuOptions.Cpu.Recompiler.vuExtraOverflow = (clampMode >= 2);
 		g_Conf->EmuOptions.Cpu.Recompiler.vuSignOverflow = (clampMode >= 3);
 
+		g_Conf->EmuOptions.Cpu.Recompiler.EnableFastmem = option_value(BOOL_PCSX2_OPT_FASTMEM, KeyOptionBool::return_type);
+
 		SSE_RoundMode roundMode = (SSE_RoundMode)option_value(INT_PCSX2_OPT_ROUND_MODE, KeyOptionInt::return_type);;
 		g_Conf->EmuOptions.Cpu.sseMXCSR.SetRoundMode(roundMode);
 		g_Conf->EmuOptions.Cpu.sseVUMXCSR.SetRoundMode(roundMode);
@@ -399,8 +412,10 @@ void retro_deinit(void)
 	vu1Thread.WaitVU();
 	//vu1Thread.Cancel();
 
+	SysWaitBootTasks();
 	pcsx2->CleanupOnExit();
 	pcsx2->OnExit();
+	Threading::RestoreCurrentThread();
 
 	bios_files.clear();
 	custom_memcard_list_slot1.clear();
@@ -424,7 +439,11 @@ void retro_get_system_info(retro_system_info* info)
 #endif
 
 	info->library_name = "pcsx2 (alpha)";
-	info->valid_extensions = "elf|iso|ciso|chd|cso|cue|bin|m3u";
+	info->valid_extensions = "elf|iso|ciso|chd|cso|cue|bin|m3u"
+#ifdef PCSX2_ZSTD
+		"|zst"
+#endif
+		;
 	info->need_fullpath = true;
 	info->block_extract = true;
 }
@@ -455,6 +474,7 @@ void retro_get_system_av_info(retro_system_av_info* info)
 
 void retro_reset(void)
 {
+	DiscardSnapshot();
 	GetMTGS().FinishTaskInThread();
 	GetCoreThread().ResetQuick();
 	DiskControl::eject_state = false;
@@ -462,6 +482,7 @@ void retro_reset(void)
 
 static void context_reset(void)
 {
+	ScopedBootPhase phase("GS open");
 	GetMTGS().OpenGS();
 }
 
@@ -583,6 +604,28 @@ read_m3u_file(const wxFileName& m3u_file)
 	return result;
 }
 
+#ifdef PCSX2_ZSTD
+// The image goes next to the original, or into the save folder if the game folder is read-only.
+static void convert_to_zstd(const wxString& path)
+{
+	if (path.Lower().EndsWith(L".zst"))
+		return;
+
+	wxFileName dst(path);
+	dst.SetExt(L"zst");
+	if (!wxFileName::IsDirWritable(dst.GetPath()))
+		dst.SetPath(save_dir_root.GetPath());
+
+	if (dst.FileExists())
+	{
+		log_cb(RETRO_LOG_INFO, "zstd convert: '%s' already exists\n", (const char*)dst.GetFullPath());
+		return;
+	}
+
+	ZstdFileReader::ConvertInBackground(path, dst.GetFullPath());
+}
+#endif
+
 bool retro_load_game(const struct retro_game_info* game)
 {
 	if (init_failed)
@@ -591,6 +634,7 @@ bool retro_load_game(const struct retro_game_info* game)
 		return false;
 	}
 
+	SysMarkBootStart();
 	ResetContentStuffs();
 
 	const char* selected_bios = option_value(STRING_PCSX2_OPT_BIOS, KeyOptionString::return_type);
@@ -612,6 +656,26 @@ bool retro_load_game(const struct retro_game_info* game)
 	g_Conf->CurrentIRX = "";
 	g_Conf->BaseFilenames.Bios = selected_bios;
 
+	// Before the core thread starts: EE and MTVU only place themselves once.
+	Threading::SetThreadPlacementMode((Threading::ThreadPlacementMode)option_value(INT_PCSX2_OPT_THREAD_PLACEMENT, KeyOptionInt::return_type));
+	SetFrameTelemetryMode((FrameTelemetryMode)option_value(INT_PCSX2_OPT_FRAME_TELEMETRY, KeyOptionInt::return_type));
+	SetSnapshotLockstep(option_value(BOOL_PCSX2_OPT_RUNAHEAD_SNAPSHOTS, KeyOptionBool::return_type));
+	SetBenchmark(option_value(STRING_PCSX2_OPT_BENCHMARK, KeyOptionString::return_type));
+
+	// Snapshots only live as long as the process and are useless to anything but run-ahead.
+	uint64_t quirks = RETRO_SERIALIZATION_QUIRK_SINGLE_SESSION;
+	environ_cb(RETRO_ENVIRONMENT_SET_SERIALIZATION_QUIRKS, &quirks);
+
+	// None of these depend on each other or on the virtual machine, so they run alongside
+	// the core thread bringing the VM up instead of on its way to the first frame.
+	SysStartBootTask("GameDB prefetch", [] { AppHost_GetGameDatabase(); });
+	SysStartBootTask("Patch DB prefetch", [widescreen = g_Conf->EmuOptions.EnableWideScreenPatches,
+		nointerlacing = g_Conf->EmuOptions.EnableNointerlacingPatches] {
+		PreloadPatchDatabases(widescreen, nointerlacing);
+	});
+	SysStartBootTask("BIOS prefetch", [bios = g_Conf->FullpathToBios()] { PrefetchBIOS(bios); });
+	SysStartBootTask("VIF unpack prefetch", [] { VifUnpackSSE_Init(); });
+
 	DiskControl::eject_state = false;
 
 
@@ -666,6 +730,11 @@ bool retro_load_game(const struct retro_game_info* game)
 			g_Conf->CdvdSource = CDVD_SourceType::Iso;
 			g_Conf->CurrentIso = game_paths[0];
 
+#ifdef PCSX2_ZSTD
+			if (option_value(BOOL_PCSX2_OPT_CONVERT_ZSTD, KeyOptionBool::return_type))
+				convert_to_zstd(game_paths[0]);
+#endif
+
 			// set up memcard on slot 1
 			if (strcmp(option_value(STRING_PCSX2_OPT_MEMCARD_SLOT_1, KeyOptionString::return_type), "empty") == 0)
 			{
@@ -801,6 +870,18 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info* i
 
 void retro_unload_game(void)
 {
+	SysWaitBootTasks();
+
+#ifdef PCSX2_ZSTD
+	ZstdFileReader::CancelConvert();
+#endif
+
+	if (FrameTelemetryEnabled.load(std::memory_order_relaxed))
+		DumpFrameTelemetry(120);
+
+	DiscardSnapshot();
+	SetSnapshotLockstep(false);
+
 	//	GetMTGS().FinishTaskInThread();
 	//		GetMTGS().CloseGS();
 	GetMTGS().FinishTaskInThread();
@@ -811,6 +892,9 @@ void retro_unload_game(void)
 
 	while (pcsx2->HasPendingEvents())
 		pcsx2->ProcessPendingEvents();
+
+	// The MTGS pinned (and maybe raised) the frontend's thread.
+	Threading::RestoreCurrentThread();
 }
 
 
@@ -825,6 +909,9 @@ void retro_run(void)
 		SetGSConfig().FramesToSkip = option_value(INT_PCSX2_OPT_FRAMES_TO_SKIP, KeyOptionInt::return_type);
 		SetGSConfig().VsyncQueueSize = option_value(INT_PCSX2_OPT_VSYNC_MTGS_QUEUE, KeyOptionInt::return_type);
 		GSUpdateOptions();
+		SetFrameTelemetryMode((FrameTelemetryMode)option_value(INT_PCSX2_OPT_FRAME_TELEMETRY, KeyOptionInt::return_type));
+		SetSnapshotLockstep(option_value(BOOL_PCSX2_OPT_RUNAHEAD_SNAPSHOTS, KeyOptionBool::return_type));
+		BlockMixing = option_value(BOOL_PCSX2_OPT_SPU2_BLOCK_MIXING, KeyOptionBool::return_type);
 		Input::RumbleEnabled(
 			option_value(BOOL_PCSX2_OPT_GAMEPAD_RUMBLE_ENABLE, KeyOptionBool::return_type),
 			option_value(INT_PCSX2_OPT_GAMEPAD_RUMBLE_FORCE, KeyOptionInt::return_type)
@@ -833,27 +920,62 @@ void retro_run(void)
 	}
 
 	Input::Update();
+	RunFrameBenchmark();
 
 	RETRO_PERFORMANCE_INIT(pcsx2_run);
 	RETRO_PERFORMANCE_START(pcsx2_run);
 
-	GetMTGS().ExecuteTaskInThread();
+	{
+		ScopedFrameTimer gs_time(FrameTimer_GS);
+		SnapshotBeginFrame();
+		GetMTGS().ExecuteTaskInThread();
+	}
+	FrameTelemetryEndFrame();
 
 	RETRO_PERFORMANCE_STOP(pcsx2_run);
 }
 
+// Run-ahead only: the snapshot stays in the core and the frontend gets a token naming it.
+struct SnapshotToken
+{
+	u32 magic;
+	u32 pad;
+	u64 id;
+};
+
+static const u32 SnapshotTokenMagic = 0x50534E53; // "SNSP"
+
+static bool snapshot_requested(void)
+{
+	int av_enable = 0;
+	return GetSnapshotLockstep() &&
+		environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable) && (av_enable & 4);
+}
+
 size_t retro_serialize_size(void)
 {
-	return 0;
+	return GetSnapshotLockstep() ? sizeof(SnapshotToken) : 0;
 }
 
 bool retro_serialize(void* data, size_t size)
 {
-	return false;
+	if (size < sizeof(SnapshotToken) || !snapshot_requested())
+		return false;
+
+	SnapshotToken token = {SnapshotTokenMagic, 0, CaptureSnapshot()};
+	if (!token.id)
+		return false;
+	memcpy(data, &token, sizeof(token));
+	return true;
 }
 bool retro_unserialize(const void* data, size_t size)
 {
-	return false;
+	if (size < sizeof(SnapshotToken) || !snapshot_requested())
+		return false;
+
+	SnapshotToken token;
+	memcpy(&token, data, sizeof(token));
+	return token.magic == SnapshotTokenMagic && RestoreSnapshot(token.id);
 }
 
 unsigned retro_get_region(void)
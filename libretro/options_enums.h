@@ -14,12 +14,18 @@
 #define BOOL_PCSX2_OPT_USERHACK_AUTO_FLUSH	 "pcsx2_userhack_auto_flush"
 #define BOOL_PCSX2_OPT_CONSERVATIVE_BUFFER	 "pcsx2_conservative_buffer"
 #define BOOL_PCSX2_OPT_ACCURATE_DATE		 "pcsx2_accurate_date"
+#define BOOL_PCSX2_OPT_RUNAHEAD_SNAPSHOTS	 "pcsx2_runahead_snapshots"
+#define BOOL_PCSX2_OPT_SW_TILE_BINNING		 "pcsx2_sw_tile_binning"
+#define BOOL_PCSX2_OPT_CONVERT_ZSTD		 "pcsx2_convert_zstd"
+#define BOOL_PCSX2_OPT_SPU2_BLOCK_MIXING	 "pcsx2_spu2_block_mixing"
+#define BOOL_PCSX2_OPT_FASTMEM			 "pcsx2_fastmem"
 
 #define STRING_PCSX2_OPT_BIOS			 "pcsx2_bios"
 #define STRING_PCSX2_OPT_RENDERER                "pcsx2_renderer"
 #define STRING_PCSX2_OPT_SYSTEM_LANGUAGE	 "pcsx2_system_language"
 #define STRING_PCSX2_OPT_MEMCARD_SLOT_1		 "pcsx2_memcard_slot_1"
 #define STRING_PCSX2_OPT_MEMCARD_SLOT_2		 "pcsx2_memcard_slot_2"
+#define STRING_PCSX2_OPT_BENCHMARK		 "pcsx2_benchmark"
 
 
 #define INT_PCSX2_OPT_ASPECT_RATIO		 "pcsx2_aspect_ratio"
@@ -38,6 +44,8 @@
 #define INT_PCSX2_OPT_FXAA			 "pcsx2_fxaa"
 #define INT_PCSX2_OPT_TEXTURE_FILTERING		 "pcsx2_texture_filtering"
 #define INT_PCSX2_OPT_VSYNC_MTGS_QUEUE		 "pcsx2_vsync_mtgs_queue"
+#define INT_PCSX2_OPT_THREAD_PLACEMENT		 "pcsx2_thread_placement"
+#define INT_PCSX2_OPT_FRAME_TELEMETRY		 "pcsx2_frame_telemetry"
 #define INT_PCSX2_OPT_MIPMAPPING		 "pcsx2_mipmapping"
 #define INT_PCSX2_OPT_CLAMPING_MODE		 "pcsx2_clamping_mode"
 #define INT_PCSX2_OPT_ROUND_MODE		 "pcsx2_round_mode"
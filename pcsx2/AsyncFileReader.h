@@ -53,6 +53,14 @@ public:
 	virtual void SetBlockSize(uint bytes) {}
 	virtual void SetDataOffset(int bytes) {}
 
+	// Returns the sector inside a memory mapping of the image, or NULL if it has to be read.
+	// The pointer stays valid until the reader is closed.
+	virtual const u8* MapBlock(uint sector) { return NULL; }
+
+	// True if BeginRead only queues the read, false if it reads (and decompresses) the
+	// sectors before returning.
+	virtual bool IsAsync() const { return false; }
+
 	uint GetBlockSize() const { return m_blocksize; }
 
 	const wxString& GetFilename() const
@@ -76,6 +84,14 @@ class FlatFileReader : public AsyncFileReader
 #elif defined(__linux__)
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
+
+	// read-only mapping of the whole image, libaio is only used when it can't be mapped
+	u8* m_map;
+	s64 m_map_size;
+	s64 m_map_ahead; // end of the last MADV_WILLNEED window
+	bool m_map_read;
+
+	void MapAhead(s64 offset);
 #elif defined(__POSIX__)
 	int m_fd; // TODO OSX don't know if overlap as an equivalent on OSX
 	struct aiocb m_aiocb;
@@ -102,6 +118,17 @@ public:
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
 	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+	virtual bool IsAsync() const { return true; }
+
+#if defined(__linux__)
+	virtual const u8* MapBlock(uint sector);
+
+	bool IsMapped() const { return m_map != NULL; }
+
+	// Reads the image through libaio and through the mapping, cold then warm, and logs the sector throughput of each.
+	static void Benchmark(const wxString& fileName, uint blocksize = 2048);
+#endif
 };
 
 class MultipartFileReader : public AsyncFileReader
@@ -139,6 +166,8 @@ public:
 
 	virtual void SetBlockSize(uint bytes);
 
+	virtual bool IsAsync() const;
+
 	static AsyncFileReader* DetectMultipart(AsyncFileReader* reader);
 };
 
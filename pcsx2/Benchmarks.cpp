@@ -0,0 +1,422 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "Benchmarks.h"
+#include "CoreBenchmark.h"
+
+#include "PS2Edefs.h"
+#include "AppConfig.h"
+#include "AsyncFileReader.h"
+#include "CDVD/CDVDaccess.h"
+#include "CDVD/CompressedFileReader.h"
+#include "IPU/IPU.h"
+#include "Patch.h"
+#include "SaveState.h"
+#include "SaveStateSnapshot.h"
+#include "Utilities/ThreadPlacement.h"
+#include "SPU2/Global.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+enum class BenchmarkWhen
+{
+	Boot,
+	InGame,
+};
+
+struct BenchmarkEntry
+{
+	const char* name;
+	BenchmarkWhen when;
+	void (*run)();
+};
+
+#if defined(__linux__)
+// Reads the loaded image as a flat file, mapped and through libaio.
+static void DiscBenchmark()
+{
+	const wxString& iso = CDVDsys_GetFile(CDVD_SourceType::Iso);
+	if (iso.IsEmpty())
+	{
+		log_cb(RETRO_LOG_WARN, "Benchmark: no disc image loaded\n");
+		return;
+	}
+	FlatFileReader::Benchmark(iso);
+}
+#endif
+
+// Writes a synthetic image in every format to the cache folder and reads it back.
+static void ReadersBenchmark()
+{
+	g_Conf->Folders.Cache.Mkdir();
+	CompressedFileReader::Benchmark(g_Conf->Folders.Cache.ToString());
+}
+
+// --------------------------------------------------------------------------------------
+//  EventTestBenchmark
+// --------------------------------------------------------------------------------------
+// The interrupt part of the event test on a synthetic copy of the TESTINT sources, laid
+// out like _cpuTestInterrupts, against a scheduler that keeps the pending events in a
+// binary heap ordered by deadline.  The heap pays for every CPU_INT (an insertion, or a
+// move when the event was already pending), every cpuClearInt of a pending event and every
+// dispatch (a removal), and skips the test when its earliest deadline isn't due.  Events
+// due together are dispatched in TESTINT order, which the emulation depends on.
+//
+// Event tests come every 48 to 3072 cycles like IOP timeslices do.  VIF1, GIF and the SIFs
+// always have a transfer in flight that schedules itself again 1000 to 50000 cycles after
+// it's dispatched, now and then one of them starts one of the rarer events (which may be
+// pending already), and now and then a pending rare event is cancelled.  Both ways have to
+// dispatch the same events and schedule the same next event tests.
+
+// Longest the EE runs between event tests, eeWaitCycles in R5900.cpp.
+static const u32 BenchWaitCycles = 3072;
+
+static const u32 BenchCommonInts = (1 << DMAC_VIF1) | (1 << DMAC_GIF) | (1 << DMAC_SIF0) | (1 << DMAC_SIF1);
+static const u8 BenchRareInts[] = {DMAC_VIF0, DMAC_FROM_IPU, DMAC_TO_IPU, DMAC_FROM_SPR, DMAC_TO_SPR,
+	DMAC_MFIFO_VIF, DMAC_MFIFO_GIF, VIF_VU0_FINISH, VIF_VU1_FINISH};
+
+// Pending events by deadline, with the position of each event so it can be moved or removed.
+struct BenchIntHeap
+{
+	u32 deadline[32];
+	u8 heap[32];
+	u8 pos[32];
+	u32 size;
+
+	__fi bool Before(u8 a, u8 b) const
+	{
+		return (int)(deadline[a] - deadline[b]) < 0;
+	}
+
+	__fi bool Contains(u8 n) const
+	{
+		return pos[n] < size && heap[pos[n]] == n;
+	}
+
+	__fi void Place(u32 i, u8 n)
+	{
+		heap[i] = n;
+		pos[n] = i;
+	}
+
+	void Up(u32 i)
+	{
+		const u8 n = heap[i];
+		for (; i > 0 && Before(n, heap[(i - 1) / 2]); i = (i - 1) / 2)
+			Place(i, heap[(i - 1) / 2]);
+		Place(i, n);
+	}
+
+	void Down(u32 i)
+	{
+		const u8 n = heap[i];
+		for (;;)
+		{
+			u32 child = i * 2 + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && Before(heap[child + 1], heap[child]))
+				child++;
+			if (!Before(heap[child], n))
+				break;
+			Place(i, heap[child]);
+			i = child;
+		}
+		Place(i, n);
+	}
+
+	void Set(u8 n, u32 when)
+	{
+		const bool moved = Contains(n);
+		deadline[n] = when;
+		if (!moved)
+		{
+			Place(size++, n);
+			Up(size - 1);
+			return;
+		}
+		Up(pos[n]);
+		Down(pos[n]);
+	}
+
+	void Remove(u8 n)
+	{
+		const u32 i = pos[n];
+		const u8 last = heap[--size];
+		if (i == size)
+			return;
+		Place(i, last);
+		Up(i);
+		Down(pos[last]);
+	}
+};
+
+template <bool heap>
+struct BenchIntState
+{
+	u32 interrupt;
+	u32 sCycle[32];
+	u32 eCycle[32];
+	BenchIntHeap pending;
+	u32 dispatched;
+	u32 nextEvent;
+	u32 x;
+
+	u32 Random(u32 lo, u32 hi)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		return lo + x % (hi - lo + 1);
+	}
+
+	__fi void SetNextEvent(u32 start, s32 delta)
+	{
+		if ((int)(nextEvent - start) > delta)
+			nextEvent = start + delta;
+	}
+
+	// CPU_INT
+	void Schedule(int n, u32 cycle)
+	{
+		interrupt |= 1 << n;
+		sCycle[n] = cycle;
+		eCycle[n] = Random(1000, 50000);
+		if (heap)
+			pending.Set(n, cycle + eCycle[n]);
+		SetNextEvent(cycle, eCycle[n]);
+	}
+
+	// cpuClearInt
+	void Cancel(int n)
+	{
+		if (heap && pending.Contains(n))
+			pending.Remove(n);
+		interrupt &= ~(1 << n);
+	}
+
+	void Dispatch(int n, u32 cycle)
+	{
+		Cancel(n);
+		dispatched += n + 1;
+		if (BenchCommonInts & (1 << n))
+		{
+			Schedule(n, cycle);
+			if (Random(0, 7) == 0)
+				Schedule(BenchRareInts[Random(0, ArraySize(BenchRareInts) - 1)], cycle);
+		}
+	}
+
+	// TESTINT
+	__fi void Test(int n, u32 cycle)
+	{
+		if (!(interrupt & (1 << n)))
+			return;
+		if ((int)(cycle - sCycle[n]) < (s32)eCycle[n])
+		{
+			SetNextEvent(sCycle[n], eCycle[n]);
+			return;
+		}
+		Dispatch(n, cycle);
+	}
+
+	__fi void TestAll(u32 cycle)
+	{
+		Test(DMAC_VIF1, cycle);
+		Test(DMAC_GIF, cycle);
+		Test(DMAC_SIF0, cycle);
+		Test(DMAC_SIF1, cycle);
+		if (interrupt & ~BenchCommonInts)
+		{
+			for (u8 n : BenchRareInts)
+				Test(n, cycle);
+		}
+	}
+
+	// Pops everything due and dispatches it in TESTINT order.  An event that a dispatch
+	// before it scheduled again is back in the heap and no longer due.
+	__fi void TestHeap(u32 cycle)
+	{
+		u32 due = 0;
+		while (pending.size && (int)(cycle - pending.deadline[pending.heap[0]]) >= 0)
+		{
+			due |= 1 << pending.heap[0];
+			pending.Remove(pending.heap[0]);
+		}
+
+		if (due)
+		{
+			for (int n : {DMAC_VIF1, DMAC_GIF, DMAC_SIF0, DMAC_SIF1})
+			{
+				if ((due & (1 << n)) && !pending.Contains(n))
+					Dispatch(n, cycle);
+			}
+			for (u8 n : BenchRareInts)
+			{
+				if ((due & (1 << n)) && !pending.Contains(n))
+					Dispatch(n, cycle);
+			}
+		}
+
+		if (pending.size)
+			SetNextEvent(sCycle[pending.heap[0]], eCycle[pending.heap[0]]);
+	}
+};
+
+template <bool heap>
+static double EventTestBenchRun(int tests, u32& dispatched, u32& busy)
+{
+	BenchIntState<heap> st = {};
+	st.x = 0x9E3779B9;
+	for (int n = 0; n < 32; n++)
+	{
+		if (BenchCommonInts & (1 << n))
+			st.Schedule(n, 0);
+	}
+
+	u32 cycle = 0, events = 0;
+	busy = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < tests; t++)
+	{
+		cycle += st.Random(48, 3072);
+		events += st.nextEvent;
+		st.nextEvent = cycle + BenchWaitCycles;
+
+		// DMA stopped by the game: cancel the lowest pending rare event.
+		if (st.Random(0, 63) == 0)
+		{
+			for (u8 n : BenchRareInts)
+			{
+				if (st.interrupt & (1 << n))
+				{
+					st.Cancel(n);
+					break;
+				}
+			}
+		}
+
+		const u32 before = st.dispatched;
+		if (heap)
+			st.TestHeap(cycle);
+		else
+			st.TestAll(cycle);
+		busy += st.dispatched != before;
+	}
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	dispatched = st.dispatched + events;
+	return ms;
+}
+
+// Times the TESTINT scan against a deadline heap on a synthetic event load and logs both.
+static void EventTestBenchmark()
+{
+	const int tests = 10000000;
+
+	u32 scan_dispatched, heap_dispatched, busy;
+	const double scan_ms = EventTestBenchRun<false>(tests, scan_dispatched, busy);
+	const double heap_ms = EventTestBenchRun<true>(tests, heap_dispatched, busy);
+
+	log_cb(RETRO_LOG_INFO, "Event test benchmark: %d tests (%.1f%% dispatch events), TESTINT scan %.2f ns/test, deadline heap %.2f ns/test%s\n",
+		tests, 100.0 * busy / tests, scan_ms * 1e6 / tests, heap_ms * 1e6 / tests,
+		scan_dispatched == heap_dispatched ? "" : " (dispatched events differ!)");
+}
+
+// In-game benchmarks that need the machine at rest get it held at a vsync, with lockstep
+// turned on for as long as they run.
+static void RunHeld(void (*run)())
+{
+	const bool lockstep = GetSnapshotLockstep();
+	SetSnapshotLockstep(true);
+
+	if (SnapshotHoldMachine())
+		run();
+	else
+		log_cb(RETRO_LOG_WARN, "Benchmark: the machine did not stop\n");
+
+	SetSnapshotLockstep(lockstep);
+}
+
+// Names match the values of the core option.
+static const BenchmarkEntry s_benchmarks[] =
+{
+	{"core", BenchmarkWhen::Boot, [] { CoreBenchmark(); }},
+	{"gs", BenchmarkWhen::Boot, [] { GSBenchmark(); }},
+	{"rasterizer", BenchmarkWhen::Boot, [] { GSRasterizerBenchmark(); }},
+#if defined(__linux__)
+	{"disc", BenchmarkWhen::Boot, DiscBenchmark},
+#endif
+	{"readers", BenchmarkWhen::Boot, ReadersBenchmark},
+	{"spu2", BenchmarkWhen::Boot, [] { MixBenchmark(); }},
+	{"reverb", BenchmarkWhen::Boot, [] { ReverbBenchmark(); }},
+	{"ipu", BenchmarkWhen::Boot, [] { IPUBenchmark(); }},
+	{"patches", BenchmarkWhen::Boot, [] { PatchDatabaseBenchmark(); }},
+	{"threads", BenchmarkWhen::Boot, [] { Threading::ThreadPlacementBenchmark(); }},
+	{"events", BenchmarkWhen::Boot, EventTestBenchmark},
+	{"savestate", BenchmarkWhen::InGame, [] { RunHeld(SaveStateCompressionBenchmark); }},
+	{"snapshots", BenchmarkWhen::InGame, [] { RunHeld([] { SaveStateSnapshotBenchmark(); }); }},
+};
+
+static const int InGameDelay = 1200; // frames, past the BIOS and the game's boot logos
+
+static std::atomic<const BenchmarkEntry*> s_selected(NULL);
+static int s_frames = 0;
+
+void SetBenchmark(const char* name)
+{
+	const BenchmarkEntry* selected = NULL;
+	for (const BenchmarkEntry& entry : s_benchmarks)
+	{
+		if (name && strcmp(entry.name, name) == 0)
+			selected = &entry;
+	}
+
+	s_frames = 0;
+	s_selected.store(selected, std::memory_order_release);
+}
+
+static void RunBenchmark(const BenchmarkEntry& entry)
+{
+	log_cb(RETRO_LOG_INFO, "Benchmark: running \"%s\"\n", entry.name);
+	entry.run();
+	log_cb(RETRO_LOG_INFO, "Benchmark: \"%s\" done\n", entry.name);
+}
+
+bool RunBootBenchmark()
+{
+	const BenchmarkEntry* entry = s_selected.load(std::memory_order_acquire);
+	if (!entry || entry->when != BenchmarkWhen::Boot)
+		return false;
+
+	s_selected.store(NULL, std::memory_order_relaxed);
+	RunBenchmark(*entry);
+	return true;
+}
+
+void RunFrameBenchmark()
+{
+	const BenchmarkEntry* entry = s_selected.load(std::memory_order_acquire);
+	if (!entry || entry->when != BenchmarkWhen::InGame || ++s_frames < InGameDelay)
+		return;
+
+	s_selected.store(NULL, std::memory_order_relaxed);
+	RunBenchmark(*entry);
+}
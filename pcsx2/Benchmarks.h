@@ -0,0 +1,35 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// --------------------------------------------------------------------------------------
+//  Benchmarks
+// --------------------------------------------------------------------------------------
+// The subsystem benchmarks, picked by name with the "pcsx2_benchmark" core option.  They
+// log their numbers (and any output mismatch) through log_cb.  Boot benchmarks run once on
+// the core thread on a machine fresh from reset, before anything boots.  In-game ones run
+// once on the frontend (MTGS) thread after the content has been running for a while, so
+// they see a real machine.
+
+// Selects the benchmark to run with the next content, NULL or an unknown name for none.
+extern void SetBenchmark(const char* name);
+
+// Called by the core thread after it reset the machine.  Returns true if a benchmark ran,
+// the machine then has to be reset again.
+extern bool RunBootBenchmark();
+
+// Called once per frame by the frontend thread, before the MTGS runs.
+extern void RunFrameBenchmark();
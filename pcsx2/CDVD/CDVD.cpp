@@ -355,7 +355,7 @@ static __fi ElfObject* loadElf(const wxString filename)
 		log_cb(RETRO_LOG_INFO, "(LoadELF) Non-conforming version suffix detected and replaced.\n");
 
 	IsoFSCDVD isofs;
-	IsoFile file(isofs, fixedname);
+	IsoFile file(isofs, isofs.FindFile(fixedname));
 	return new ElfObject(fixedname, file);
 }
 
@@ -35,6 +35,7 @@
 
 #include "DebugTools/SymbolMap.h"
 #include "AppConfig.h"
+#include "FrameTelemetry.h"
 
 CDVD_API* CDVD = NULL;
 
@@ -72,10 +73,10 @@ static void CheckNullCDVD()
 static int CheckDiskTypeFS(int baseType)
 {
 	IsoFSCDVD isofs;
-	IsoDirectory rootdir(isofs);
+	isofs.LoadIndex();
 	try
 	{
-		IsoFile file(rootdir, L"SYSTEM.CNF;1");
+		IsoFile file(isofs, isofs.FindFile(L"SYSTEM.CNF;1"));
 
 		int size = file.getLength();
 
@@ -100,7 +101,7 @@ static int CheckDiskTypeFS(int baseType)
 
 	try
 	{
-		IsoFile file(rootdir, L"PSX.EXE;1");
+		isofs.FindFile(L"PSX.EXE;1");
 		return CDVD_TYPE_PSCD;
 	}
 	catch (Exception::FileNotFound&)
@@ -109,7 +110,7 @@ static int CheckDiskTypeFS(int baseType)
 
 	try
 	{
-		IsoFile file(rootdir, L"VIDEO_TS/VIDEO_TS.IFO;1");
+		isofs.FindFile(L"VIDEO_TS/VIDEO_TS.IFO;1");
 		return CDVD_TYPE_DVDV;
 	}
 	catch (Exception::FileNotFound&)
@@ -361,6 +362,8 @@ bool DoCDVDopen()
 
 	//TODO_CDVD check if ISO and Disc use UTF8
 
+	IsoFSCDVD::ResetIndex();
+
 	auto CurrentSourceType = enum_cast(m_CurrentSourceType);
 	int ret = CDVD->open(!m_SourceFilename[CurrentSourceType].IsEmpty() ?
 			static_cast<const char*>(m_SourceFilename[CurrentSourceType].ToUTF8()) :
@@ -386,12 +389,14 @@ void DoCDVDclose()
 
 s32 DoCDVDreadSector(u8* buffer, u32 lsn, int mode)
 {
+	ScopedFrameTimer cdvd_time(FrameTimer_CDVD);
 	CheckNullCDVD();
 	return CDVD->readSector(buffer, lsn, mode);
 }
 
 s32 DoCDVDreadTrack(u32 lsn, int mode)
 {
+	ScopedFrameTimer cdvd_time(FrameTimer_CDVD);
 	CheckNullCDVD();
 
 	// TEMP: until all the plugins use the new CDVDgetBuffer style
@@ -420,6 +425,7 @@ s32 DoCDVDreadTrack(u32 lsn, int mode)
 
 s32 DoCDVDgetBuffer(u8* buffer)
 {
+	ScopedFrameTimer cdvd_time(FrameTimer_CDVD);
 	CheckNullCDVD();
 	return CDVD->getBuffer(buffer);
 }
@@ -435,6 +441,7 @@ s32 DoCDVDdetectDiskType()
 void DoCDVDresetDiskTypeCache()
 {
 	diskTypeCached = -1;
+	IsoFSCDVD::ResetIndex();
 }
 
 ////////////////////////////////////////////////////////
@@ -19,6 +19,12 @@
 #include "ChdFileReader.h"
 #include "CsoFileReader.h"
 #include "GzippedFileReader.h"
+#include "IsoFileFormats.h"
+#ifdef PCSX2_ZSTD
+#include "ZstdFileReader.h"
+#endif
+#include <chrono>
+#include <zlib.h>
 
 // CompressedFileReader factory.
 AsyncFileReader* CompressedFileReader::GetNewReader(const wxString& fileName)
@@ -35,6 +41,217 @@ AsyncFileReader* CompressedFileReader::GetNewReader(const wxString& fileName)
 	{
 		return new CsoFileReader();
 	}
+#ifdef PCSX2_ZSTD
+	if (ZstdFileReader::CanHandle(fileName))
+	{
+		return new ZstdFileReader();
+	}
+#endif
 	// This is the one which will fail on open.
 	return NULL;
 }
+
+// Something resembling a game disc: file tables and code compress well, padding compresses
+// to nothing and streamed audio/video doesn't compress at all.
+static void BenchmarkSector(u8* dst, uint lsn)
+{
+	u32 x = lsn * 2654435761u + 1;
+
+	switch (lsn & 7)
+	{
+		case 0: case 1: case 2: case 3:
+			for (uint i = 0; i < 2048; i += 16)
+			{
+				x = x * 1103515245 + 12345;
+				memcpy(dst + i, "RECORD\0\0", 8);
+				*(u32*)(dst + i + 8) = lsn * 128 + i / 16;
+				*(u32*)(dst + i + 12) = (x >> 16) & 0xff;
+			}
+			break;
+		case 4:
+			memset(dst, 0, 2048);
+			break;
+		default:
+			for (uint i = 0; i < 2048; i += 4)
+			{
+				x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+				*(u32*)(dst + i) = x;
+			}
+			break;
+	}
+}
+
+// CSOv1 with 2048 byte frames and no index alignment, frames that don't shrink are stored.
+static bool BenchmarkWriteCso(const wxString& fileName, uint blocks)
+{
+	FILE* fp = wxFopen(fileName, L"wb");
+	if (!fp)
+		return false;
+
+	u8 header[24] = {'C', 'I', 'S', 'O', 24};
+	*(u64*)(header + 8) = (u64)blocks * 2048;
+	*(u32*)(header + 16) = 2048;
+	header[20] = 1;
+
+	std::vector<u32> index(blocks + 1);
+	u8 sector[2048], packed[4096];
+	u32 pos = sizeof(header) + (blocks + 1) * 4;
+
+	fwrite(header, 1, sizeof(header), fp);
+	fseek(fp, pos, SEEK_SET);
+
+	for (uint lsn = 0; lsn < blocks; lsn++)
+	{
+		BenchmarkSector(sector, lsn);
+
+		z_stream z = {};
+		deflateInit2(&z, 9, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+		z.next_in = sector;
+		z.avail_in = sizeof(sector);
+		z.next_out = packed;
+		z.avail_out = sizeof(packed);
+		deflate(&z, Z_FINISH);
+		deflateEnd(&z);
+
+		if (z.total_out < sizeof(sector))
+		{
+			index[lsn] = pos;
+			pos += fwrite(packed, 1, z.total_out, fp);
+		}
+		else
+		{
+			index[lsn] = pos | 0x80000000;
+			pos += fwrite(sector, 1, sizeof(sector), fp);
+		}
+	}
+	index[blocks] = pos;
+
+	fseek(fp, sizeof(header), SEEK_SET);
+	fwrite(index.data(), 4, index.size(), fp);
+	fclose(fp);
+	return true;
+}
+
+static bool BenchmarkWriteGz(const wxString& fileName, uint blocks)
+{
+	gzFile gz = gzopen(fileName.ToUTF8(), "wb6");
+	if (!gz)
+		return false;
+
+	u8 sector[2048];
+	for (uint lsn = 0; lsn < blocks; lsn++)
+	{
+		BenchmarkSector(sector, lsn);
+		gzwrite(gz, sector, sizeof(sector));
+	}
+	return gzclose(gz) == Z_OK;
+}
+
+static bool BenchmarkWriteIso(const wxString& fileName, uint blocks, int version)
+{
+	try
+	{
+		OutputIsoFile iso;
+		u8 sector[2048];
+
+		iso.Create(fileName, version, 9);
+		iso.WriteHeader(0, 2048, blocks);
+
+		for (uint lsn = 0; lsn < blocks; lsn++)
+		{
+			BenchmarkSector(sector, lsn);
+			iso.WriteSector(sector, lsn);
+		}
+		iso.Finish();
+		iso.Close();
+	}
+	catch (BaseException& ex)
+	{
+		log_cb(RETRO_LOG_ERROR, "Reader benchmark: %s\n", WX_STR(ex.FormatDiagnosticMessage()));
+		return false;
+	}
+	return true;
+}
+
+void CompressedFileReader::Benchmark(const wxString& workdir, uint blocks)
+{
+	static const uint ReadUnit = 16;
+	static const uint Seeks = 4096;
+
+	static const wxChar* formats[] = {L"iso", L"cso", L"gz",
+#ifdef PCSX2_ZSTD
+		L"zst",
+#endif
+	};
+
+	std::unique_ptr<u8[]> buffer(new u8[ReadUnit * 2048]);
+	u8 expected[2048];
+
+	for (const wxChar* format : formats)
+	{
+		wxString fileName = Path::Combine(workdir, wxString(L"reader_benchmark.") + format);
+		wxString name(format);
+
+		auto start = std::chrono::steady_clock::now();
+
+		bool written = name == L"cso" ? BenchmarkWriteCso(fileName, blocks) :
+		               name == L"gz"  ? BenchmarkWriteGz(fileName, blocks) :
+		               BenchmarkWriteIso(fileName, blocks, name == L"iso" ? OutputIsoFile::VersionPlain : OutputIsoFile::VersionZstd);
+
+		double write_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::unique_ptr<AsyncFileReader> reader(name == L"iso" ? new FlatFileReader() : GetNewReader(fileName));
+
+		start = std::chrono::steady_clock::now();
+
+		if (!written || !reader || !reader->Open(fileName))
+		{
+			log_cb(RETRO_LOG_WARN, "Reader benchmark: cannot create or open %s\n", WX_STR(fileName));
+			wxRemoveFile(fileName);
+			continue;
+		}
+
+		// gz builds (or loads) its index here
+		double open_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		reader->SetBlockSize(2048);
+
+		bool ok = reader->GetBlockCount() == blocks;
+
+		start = std::chrono::steady_clock::now();
+
+		for (uint lsn = 0; lsn < blocks && ok; lsn += ReadUnit)
+		{
+			uint count = std::min(ReadUnit, blocks - lsn);
+			ok = reader->ReadSync(buffer.get(), lsn, count) == (int)(count * 2048);
+
+			for (uint i = 0; i < count && ok; i++)
+			{
+				BenchmarkSector(expected, lsn + i);
+				ok = memcmp(buffer.get() + i * 2048, expected, 2048) == 0;
+			}
+		}
+
+		double seq_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+
+		for (uint n = 0, lsn = 0; n < Seeks && ok; n++, lsn = (lsn + 7919) % blocks)
+			ok = reader->ReadSync(buffer.get(), lsn, 1) == 2048;
+
+		double seek_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		reader->Close();
+
+		double mb = blocks * 2048.0 / (1024 * 1024);
+		double ratio = (double)Path::GetFileSize(fileName) / (blocks * 2048.0);
+
+		log_cb(ok ? RETRO_LOG_INFO : RETRO_LOG_ERROR,
+			"Reader benchmark: [%3s] %s, size %5.1f%%, write %6.1f MB/s, open %.3fs, sequential %7.1f MB/s, random %6.0f sectors/s\n",
+			WX_STR(name), ok ? "ok" : "MISMATCH", ratio * 100,
+			write_sec > 0 ? mb / write_sec : 0.0, open_sec,
+			seq_sec > 0 ? mb / seq_sec : 0.0, seek_sec > 0 ? Seeks / seek_sec : 0.0);
+
+		wxRemoveFile(fileName);
+	}
+}
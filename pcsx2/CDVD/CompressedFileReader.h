@@ -25,6 +25,10 @@ public:
 	// Open(filename) may still fail.
 	static AsyncFileReader* GetNewReader(const wxString& fileName);
 
+	// Writes the same synthetic image as flat iso, cso, gz and zst (when built with zstd) into
+	// workdir, then logs the size and read speed of each reader. The images are deleted afterwards.
+	static void Benchmark(const wxString& workdir, uint blocks = 16384);
+
 private:
 	virtual ~CompressedFileReader() = 0;
 };
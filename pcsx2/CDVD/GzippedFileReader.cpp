@@ -14,7 +14,11 @@
 */
 
 #include "PrecompiledHeader.h"
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <thread>
+#include <vector>
 #include <wx/stdpaths.h>
 #include "AppConfig.h"
 #include "ChunksCache.h"
@@ -112,6 +116,319 @@ static void WriteIndexToFile(Access* index, const wxString filename)
 	}
 }
 
+// Parallel index build
+// --------------------
+// A gzip stream compressed with full flushes (pigz --independent and similar tools) has byte
+// aligned points where the next deflate block doesn't reference anything before it. Each flush
+// ends with an empty stored block (00 00 ff ff), so those are the candidate cut points: every
+// chunk between two candidates is inflated on its own thread from an empty window. Raw inflate
+// rejects a distance that reaches before the chunk, and the chunk must end on a block boundary
+// exactly at the next candidate, checked in file order. Anything else falls back to the serial
+// build_index(). Ordinary gzip images (gzip, 7-Zip, pigz without --independent) have no full
+// flushes, so they are always indexed serially: only images recompressed with full flushes
+// get the faster first open.
+
+#define GZFILE_INDEX_SCAN_SIZE (1048576L * 4)          /* how far into a slice to look for a flush point */
+#define GZFILE_INDEX_PARALLEL_MIN (1048576L * 64)      /* smaller files are indexed serially */
+
+struct IndexChunk
+{
+	PX_off_t in_begin; // compressed offset of the first block
+	PX_off_t in_end;   // compressed offset of the next chunk, or the file size
+	PX_off_t out;      // uncompressed size
+	Access* index;     // access points, out offsets relative to the chunk
+	bool ok;
+};
+
+static PX_off_t FindFlushPoint(FILE* in, PX_off_t start, PX_off_t end)
+{
+	std::vector<unsigned char> buf((size_t)std::min<PX_off_t>(end - start, GZFILE_INDEX_SCAN_SIZE));
+
+	PX_fseeko(in, start, SEEK_SET);
+	size_t len = fread(buf.data(), 1, buf.size(), in);
+
+	for (size_t i = 0; i + 4 <= len; i++)
+	{
+		if (buf[i] == 0 && buf[i + 1] == 0 && buf[i + 2] == 0xff && buf[i + 3] == 0xff)
+			return start + i + 4;
+	}
+
+	return -1;
+}
+
+static void InflateChunk(const wxString& filename, IndexChunk& c, bool first, bool last, PX_off_t span, std::atomic<s64>& progress)
+{
+	c.ok = false;
+	c.out = 0;
+	c.index = NULL;
+
+	FILE* in = PX_fopen_rb(filename);
+	if (in == NULL)
+		return;
+
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	strm.avail_in = 0;
+	strm.next_in = Z_NULL;
+	if (inflateInit2(&strm, first ? 47 : -15) != Z_OK)
+	{
+		fclose(in);
+		return;
+	}
+
+	std::unique_ptr<unsigned char[]> input(new unsigned char[CHUNK]);
+	std::unique_ptr<unsigned char[]> window(new unsigned char[WINSIZE]());
+
+	PX_off_t totin = c.in_begin, totout = 0, lastout = 0;
+	bool done = false;
+	int ret = Z_OK;
+
+	// a raw stream doesn't stop before its first block, the chunk start is an access point with an unused window
+	if (!first && (c.index = addpoint(NULL, 0, c.in_begin, 0, 0, window.get())) == NULL)
+		goto inflate_chunk_end;
+
+	PX_fseeko(in, c.in_begin, SEEK_SET);
+	strm.avail_out = 0;
+	do
+	{
+		strm.avail_in = fread(input.get(), 1, CHUNK, in);
+		if (ferror(in) || strm.avail_in == 0)
+			goto inflate_chunk_end;
+		strm.next_in = input.get();
+		progress += strm.avail_in;
+
+		do
+		{
+			if (strm.avail_out == 0)
+			{
+				strm.avail_out = WINSIZE;
+				strm.next_out = window.get();
+			}
+
+			totin += strm.avail_in;
+			totout += strm.avail_out;
+			ret = inflate(&strm, Z_BLOCK);
+			totin -= strm.avail_in;
+			totout -= strm.avail_out;
+			if (ret == Z_NEED_DICT || ret == Z_MEM_ERROR || ret == Z_DATA_ERROR)
+				goto inflate_chunk_end;
+
+			if (ret == Z_STREAM_END)
+			{
+				done = last;
+				goto inflate_chunk_end;
+			}
+
+			if (!last && totin > c.in_end)
+				goto inflate_chunk_end; // the next candidate isn't a block boundary
+
+			if (strm.data_type & 128)
+			{
+				if (!last && totin == c.in_end)
+				{
+					done = (strm.data_type & 7) == 0;
+					goto inflate_chunk_end;
+				}
+
+				if (!(strm.data_type & 64) && ((first && totout == 0) || totout - lastout > span))
+				{
+					c.index = addpoint(c.index, strm.data_type & 7, totin, totout, strm.avail_out, window.get());
+					if (c.index == NULL)
+						goto inflate_chunk_end;
+					lastout = totout;
+				}
+			}
+		} while (strm.avail_in != 0);
+	} while (true);
+
+inflate_chunk_end:
+	(void)inflateEnd(&strm);
+	fclose(in);
+
+	c.out = totout;
+	c.ok = done && c.index != NULL;
+}
+
+// Returns false when the file has no usable flush points, or one of the chunks failed to verify.
+static bool BuildIndexParallel(const wxString& filename, PX_off_t span, Access** built)
+{
+	s64 size = fsize(filename);
+	uint threads = std::thread::hardware_concurrency();
+
+	if (threads < 2 || size < GZFILE_INDEX_PARALLEL_MIN)
+		return false;
+
+	threads = std::min(threads, 16u);
+
+	// candidate cut points, at most one per slice
+
+	FILE* in = PX_fopen_rb(filename);
+	if (in == NULL)
+		return false;
+
+	std::vector<IndexChunk> chunks;
+	chunks.push_back({0, 0, 0, NULL, false});
+
+	uint slices = threads * 4;
+	for (uint i = 1; i < slices; i++)
+	{
+		PX_off_t start = size * i / slices;
+		PX_off_t end = size * (i + 1) / slices;
+		PX_off_t at = FindFlushPoint(in, start, end);
+
+		if (at > chunks.back().in_begin && at < end)
+			chunks.push_back({at, 0, 0, NULL, false});
+	}
+
+	fclose(in);
+
+	if (chunks.size() < 2)
+	{
+		log_cb(RETRO_LOG_INFO, "gzip index: no full flush points (recompress with pigz --independent for a parallel build), indexing serially\n");
+		return false;
+	}
+
+	for (size_t i = 0; i < chunks.size(); i++)
+		chunks[i].in_end = i + 1 < chunks.size() ? chunks[i + 1].in_begin : size;
+
+	log_cb(RETRO_LOG_INFO, "gzip index: %u flush points, inflating on %u threads\n", (uint)chunks.size() - 1, threads);
+
+	std::atomic<size_t> next(0);
+	std::atomic<size_t> finished(0);
+	std::atomic<s64> progress(0);
+
+	std::vector<std::thread> workers;
+	for (uint t = 0; t < std::min<size_t>(threads, chunks.size()); t++)
+	{
+		workers.emplace_back([&]() {
+			for (size_t i = next++; i < chunks.size(); i = next++)
+			{
+				InflateChunk(filename, chunks[i], i == 0, i + 1 == chunks.size(), span, progress);
+				finished++;
+			}
+		});
+	}
+
+	for (int reported = 0; finished < chunks.size();)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+		int percent = (int)(100 * std::min<s64>(progress, size) / size);
+		if (percent / 10 != reported / 10)
+		{
+			log_cb(RETRO_LOG_INFO, "gzip index: %d%%\n", percent);
+			reported = percent;
+		}
+	}
+
+	for (std::thread& t : workers)
+		t.join();
+
+	// verify in file order and stitch the access points together
+
+	bool ok = true;
+	int have = 0;
+	for (IndexChunk& c : chunks)
+	{
+		ok = ok && c.ok;
+		have += c.index ? c.index->have : 0;
+	}
+
+	Access* index = NULL;
+	if (ok)
+	{
+		index = (Access*)malloc(sizeof(Access));
+		if (index != NULL && (index->list = (Point*)malloc(sizeof(Point) * have)) == NULL)
+		{
+			free(index);
+			index = NULL;
+		}
+	}
+
+	if (index != NULL)
+	{
+		PX_off_t out = 0;
+		index->have = 0;
+
+		for (IndexChunk& c : chunks)
+		{
+			for (int i = 0; i < c.index->have; i++)
+			{
+				Point& p = index->list[index->have++];
+				memcpy(&p, &c.index->list[i], sizeof(Point));
+				p.out += out;
+			}
+
+			out += c.out;
+		}
+
+		index->size = index->have;
+		index->span = span;
+		index->uncompressed_size = out;
+		*built = index;
+	}
+	else
+	{
+		log_cb(RETRO_LOG_WARN, "gzip index: flush points did not verify, indexing serially\n");
+	}
+
+	for (IndexChunk& c : chunks)
+		free_index(c.index);
+
+	return index != NULL;
+}
+
+// Indexes next to the image need a writable game folder, the cache folder takes the rest. The key
+// hashes the size, the head and tail of the compressed file (the tail holds the gzip trailer, the
+// CRC of the last member's data) and samples spread across the rest, so images of the same size
+// that differ in the middle (a patched translation, another revision) get their own index. A full
+// hash would cost as much as the index build itself.
+static wxString iso2cachename(const wxString& isoname)
+{
+	s64 size = fsize(isoname);
+	u64 hash = 0xcbf29ce484222325ULL; // FNV-1a
+
+	auto fnv = [&hash](const unsigned char* data, size_t len) {
+		for (size_t i = 0; i < len; i++)
+			hash = (hash ^ data[i]) * 0x100000001b3ULL;
+	};
+
+	fnv((const unsigned char*)&size, sizeof(size));
+
+	FILE* in = PX_fopen_rb(isoname);
+	if (in == NULL)
+		return L"";
+
+	std::vector<unsigned char> buf(1024 * 1024);
+
+	size_t len = fread(buf.data(), 1, buf.size(), in);
+	fnv(buf.data(), len);
+
+	if (size > (s64)buf.size() * 2)
+	{
+		static const int Samples = 256;
+		static const size_t SampleSize = 16 * 1024;
+
+		const s64 middle = size - buf.size() * 2;
+		for (int i = 0; i < Samples; i++)
+		{
+			PX_fseeko(in, buf.size() + middle * i / Samples, SEEK_SET);
+			len = fread(buf.data(), 1, std::min<s64>(SampleSize, middle), in);
+			fnv(buf.data(), len);
+		}
+
+		PX_fseeko(in, size - buf.size(), SEEK_SET);
+		len = fread(buf.data(), 1, buf.size(), in);
+		fnv(buf.data(), len);
+	}
+
+	fclose(in);
+
+	return (g_Conf->Folders.Cache + pxsFmt(L"%016llX.pindex", (unsigned long long)hash)).GetFullPath();
+}
+
 static wxString INDEX_TEMPLATE_KEY(L"$(f)");
 // template:
 // must contain one and only one instance of '$(f)' (without the quotes)
@@ -286,7 +603,18 @@ bool GzippedFileReader::OkIndex()
 	if (indexfile.length() == 0)
 		return false; // iso2indexname(...) will print errors if it can't apply the template
 
-	if (wxFileName::FileExists(indexfile) && (m_pIndex = ReadIndexFromFile(indexfile)))
+	// then from the cache folder, whose name needs the image read
+	wxString cachefile;
+
+	if (!(wxFileName::FileExists(indexfile) && (m_pIndex = ReadIndexFromFile(indexfile))))
+	{
+		cachefile = iso2cachename(m_filename);
+
+		if (!cachefile.IsEmpty() && wxFileName::FileExists(cachefile) && (m_pIndex = ReadIndexFromFile(cachefile)))
+			indexfile = cachefile;
+	}
+
+	if (m_pIndex)
 	{
 		log_cb(RETRO_LOG_INFO, "OK: Gzip quick access index read from disk: '%s'\n", WX_STR(indexfile));
 #ifndef NDEBUG
@@ -305,15 +633,31 @@ bool GzippedFileReader::OkIndex()
 	// No valid index file. Generate an index
 	log_cb(RETRO_LOG_WARN, "This may take a while (but only once). Scanning compressed file to generate a quick access index...\n");
 
-	Access* index;
-	FILE* infile = PX_fopen_rb(m_filename);
-	int len = build_index(infile, GZFILE_SPAN_DEFAULT, &index);
-	printf("\n"); // build_index prints progress without \n's
-	fclose(infile);
+	Access* index = NULL;
+	int len;
+
+	if (BuildIndexParallel(m_filename, GZFILE_SPAN_DEFAULT, &index))
+	{
+		len = index->have;
+	}
+	else
+	{
+		FILE* infile = PX_fopen_rb(m_filename);
+		len = build_index(infile, GZFILE_SPAN_DEFAULT, &index);
+		fclose(infile);
+	}
 
 	if (len >= 0)
 	{
 		m_pIndex = index;
+
+		// read-only game libraries get their index in the cache folder
+		if (!wxFileName::IsDirWritable(wxFileName(indexfile).GetPath()) && !cachefile.IsEmpty())
+		{
+			g_Conf->Folders.Cache.Mkdir();
+			indexfile = cachefile;
+		}
+
 		WriteIndexToFile((Access*)m_pIndex, indexfile);
 	}
 	else
@@ -51,9 +51,84 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 		return -1;
 	}
 
+	// the reader can't tell a synchronous read from a read-ahead still in flight
+	FinishPending();
+
 	return m_reader->ReadSync(dst + m_blockofs, lsn, 1);
 }
 
+int InputIsoFile::FinishPending()
+{
+	ReadWindow* w = m_read_pending;
+
+	if (w == NULL)
+		return 0;
+
+	m_read_pending = NULL;
+	w->pending = false;
+
+	if (w->ahead)
+		m_read_stats.ahead_waits++;
+
+	int ret = m_reader->FinishRead();
+
+	if (ret < 0)
+		w->count = 0; // read it again on the next request
+
+	return ret;
+}
+
+void InputIsoFile::ReadWindowAt(ReadWindow& w, uint lsn)
+{
+	FinishPending();
+
+	if (w.ahead)
+		m_read_stats.ahead_wasted++;
+
+	if (!w.buffer)
+		w.buffer.reset(new u8[MaxReadUnit * CD_FRAMESIZE_RAW]);
+
+	w.lsn = lsn;
+	w.count = std::min(std::max(ReadUnit, 1u), m_blocks - lsn);
+	w.ahead = false;
+	w.pending = true;
+
+	m_reader->BeginRead(w.buffer.get(), w.lsn, w.count);
+	m_read_pending = &w;
+}
+
+void InputIsoFile::ReadAhead(ReadStream& s)
+{
+	// Only streams that have been reading sequentially get a read-ahead, and only while the
+	// reader is idle: a demand read must never queue behind a speculative one.  A reader
+	// that reads in BeginRead would only move the read in front of the current sector.
+	if (ReadUnit <= 1 || s.run < 2 || m_read_pending != NULL || !m_reader->IsAsync())
+		return;
+
+	ReadWindow& cur = *m_read_window;
+	ReadWindow& next = &cur == &s.window[0] ? s.window[1] : s.window[0];
+
+	uint lsn = cur.lsn + cur.count;
+
+	if (lsn >= m_blocks || (next.count != 0 && next.lsn == lsn))
+		return;
+
+	ReadWindowAt(next, lsn);
+	next.ahead = true;
+}
+
+void InputIsoFile::LogReadStats() const
+{
+	const ReadStats& rs = m_read_stats;
+
+	if (rs.requests == 0)
+		return;
+
+	log_cb(RETRO_LOG_DEBUG, "isoFile reads: %llu requests, %.1f%% hits (%.1f%% from read-ahead), %llu misses, %llu read-ahead waits, %llu read-ahead wasted\n",
+		(unsigned long long)rs.requests, 100.0 * (rs.hits + rs.ahead_hits) / rs.requests, 100.0 * rs.ahead_hits / rs.requests,
+		(unsigned long long)rs.misses, (unsigned long long)rs.ahead_waits, (unsigned long long)rs.ahead_wasted);
+}
+
 void InputIsoFile::BeginRead2(uint lsn)
 {
 	m_current_lsn = lsn;
@@ -66,24 +141,91 @@ void InputIsoFile::BeginRead2(uint lsn)
 		return;
 	}
 
-	if (lsn >= m_read_lsn && lsn < (m_read_lsn + m_read_count))
-	{
-		// Already buffered
+	// Memory mapped images are copied straight into the caller by FinishRead3, skipping the read windows.
+	m_mapped_block = m_reader->MapBlock(lsn);
+	if (m_mapped_block)
 		return;
-	}
 
-	m_read_lsn = lsn;
-	m_read_count = 1;
+	m_read_stats.requests++;
+	m_read_tick++;
 
-	if (ReadUnit > 1)
+	ReadStream* stream = NULL;
+	ReadWindow* window = NULL;
+
+	for (uint i = 0; i < MaxStreams && window == NULL; i++)
 	{
-		//m_read_lsn   = lsn - (lsn % ReadUnit);
+		for (ReadWindow& w : m_streams[i].window)
+		{
+			if (w.count != 0 && lsn >= w.lsn && lsn < w.lsn + w.count)
+			{
+				// Already buffered, or about to be
+				stream = &m_streams[i];
+				window = &w;
+				break;
+			}
+		}
+	}
 
-		m_read_count = std::min(ReadUnit, m_blocks - m_read_lsn);
+	if (window != NULL)
+	{
+		if (window->ahead)
+		{
+			// FinishRead3 is going to block on the read-ahead
+			if (window->pending)
+				m_read_stats.ahead_waits++;
+
+			window->ahead = false;
+			m_read_stats.ahead_hits++;
+		}
+		else
+		{
+			m_read_stats.hits++;
+		}
 	}
+	else
+	{
+		// continue the stream this sector follows, otherwise start a new one over the least recently used
+
+		for (ReadStream& s : m_streams)
+		{
+			if (s.used != 0 && s.next == lsn)
+				stream = &s;
+		}
+
+		if (stream == NULL)
+		{
+			stream = &m_streams[0];
+
+			for (ReadStream& s : m_streams)
+			{
+				if (s.used < stream->used)
+					stream = &s;
+			}
+
+			stream->run = 0;
+		}
 
-	m_reader->BeginRead(m_readbuffer, m_read_lsn, m_read_count);
-	m_read_inprogress = true;
+		ReadWindow* w = stream->window;
+		window = w[0].count == 0 || (w[1].count != 0 && w[0].lsn <= w[1].lsn) ? &w[0] : &w[1];
+
+		m_read_stats.misses++;
+
+		ReadWindowAt(*window, lsn);
+	}
+
+	if (lsn == stream->next)
+		stream->run++;
+	else if (lsn + 1 != stream->next)
+		stream->run = 0;
+
+	stream->next = lsn + 1;
+	stream->used = m_read_tick;
+
+	m_read_stream = stream;
+	m_read_window = window;
+
+	if ((m_read_stats.requests & 0xffff) == 0)
+		LogReadStats();
 }
 
 int InputIsoFile::FinishRead3(u8* dst, uint mode)
@@ -99,10 +241,9 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 	int length = 0;
 	int ret = 0;
 
-	if (m_read_inprogress)
+	if (m_mapped_block == NULL && m_read_window->pending)
 	{
-		ret = m_reader->FinishRead();
-		m_read_inprogress = false;
+		ret = FinishPending();
 
 		if (ret < 0)
 			return ret;
@@ -147,8 +288,11 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 
 	length = end - _offset;
 
-	uint read_offset = (m_current_lsn - m_read_lsn) * m_blocksize;
-	memcpy(dst + diff, m_readbuffer + ndiff + read_offset, length);
+	const u8* src = m_mapped_block;
+	if (src == NULL)
+		src = m_read_window->buffer.get() + (m_current_lsn - m_read_window->lsn) * m_blocksize;
+
+	memcpy(dst + diff, src + ndiff, length);
 
 	if (m_type == ISOTYPE_CD && diff >= 12)
 	{
@@ -156,6 +300,10 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 		dst[diff - 9] = 2;
 	}
 
+	// the sector is out, let the reader work on what the stream wants next
+	if (m_mapped_block == NULL)
+		ReadAhead(*m_read_stream);
+
 	return 0;
 }
 
@@ -179,11 +327,30 @@ void InputIsoFile::_init()
 	m_blocksize = 0;
 	m_blocks = 0;
 
-	m_read_inprogress = false;
-	m_read_count = 0;
+	for (ReadStream& s : m_streams)
+	{
+		for (ReadWindow& w : s.window)
+		{
+			w.lsn = 0;
+			w.count = 0;
+			w.pending = false;
+			w.ahead = false;
+		}
+
+		s.next = 0;
+		s.run = 0;
+		s.used = 0;
+	}
+
+	m_read_pending = NULL;
+	m_read_window = NULL;
+	m_read_stream = NULL;
+	memset(&m_read_stats, 0, sizeof(m_read_stats));
+	m_read_tick = 0;
+
+	m_mapped_block = NULL;
 	ReadUnit = 0;
 	m_current_lsn = -1;
-	m_read_lsn = -1;
 	m_reader = NULL;
 }
 
@@ -286,6 +453,8 @@ bool InputIsoFile::Open(const wxString& srcfile, bool testOnly)
 
 void InputIsoFile::Close()
 {
+	LogReadStats();
+
 	delete m_reader;
 	m_reader = NULL;
 
@@ -17,8 +17,19 @@
 #include "PrecompiledHeader.h"
 
 #include "IsoFSCDVD.h"
+#include "IsoFS.h"
 #include "../CDVDaccess.h"
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// Full paths ("DIR/FILE.EXT;1", no leading separator) of every file and directory on the disc.
+static std::unordered_map<std::string, IsoFileDescriptor> s_index;
+static bool s_index_valid = false;
+static std::mutex s_index_lock;
+
 IsoFSCDVD::IsoFSCDVD()
 {
 }
@@ -35,3 +46,108 @@ int IsoFSCDVD::getNumSectors()
 
 	return td.lsn;
 }
+
+void IsoFSCDVD::ResetIndex()
+{
+	std::lock_guard<std::mutex> lock(s_index_lock);
+
+	s_index.clear();
+	s_index_valid = false;
+}
+
+void IsoFSCDVD::LoadIndex()
+{
+	std::lock_guard<std::mutex> lock(s_index_lock);
+
+	if (s_index_valid)
+		return;
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Throws when there is no root directory, leaving the index invalid.
+	IsoDirectory root(*this);
+
+	std::vector<std::pair<std::string, IsoFileDescriptor>> pending;
+	std::unordered_set<u32> visited; // directory extents, in case of a malformed tree with loops
+	uint dirs = 1;
+
+	auto add = [&](const std::string& parent, const IsoDirectory& dir) {
+		for (const IsoFileDescriptor& entry : dir.files)
+		{
+			if (entry.name == L"." || entry.name == L"..")
+				continue;
+
+			std::string path = parent + (const char*)entry.name.ToUTF8();
+			s_index.emplace(path, entry);
+
+			if (entry.IsDir() && visited.insert(entry.lba).second)
+				pending.emplace_back(path + "/", entry);
+		}
+	};
+
+	visited.insert(root.files.empty() ? 0 : root.files[0].lba);
+	add("", root);
+
+	while (!pending.empty())
+	{
+		std::pair<std::string, IsoFileDescriptor> next = std::move(pending.back());
+		pending.pop_back();
+
+		try
+		{
+			add(next.first, IsoDirectory(*this, next.second));
+			dirs++;
+		}
+		catch (Exception::BaseException&)
+		{
+			// An unreadable directory only hides its own contents.
+			log_cb(RETRO_LOG_WARN, "(IsoFS) Unable to index directory %s\n", next.first.c_str());
+		}
+	}
+
+	s_index_valid = true;
+
+	log_cb(RETRO_LOG_INFO, "(IsoFS) Indexed %u entries in %u directories (%.1f ms)\n", (uint)s_index.size(), dirs,
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+
+IsoFileDescriptor IsoFSCDVD::FindFile(const wxString& filePath)
+{
+	pxAssert(!filePath.IsEmpty());
+
+	LoadIndex();
+
+	// Same DOS-style split as IsoDirectory::FindFile, "." and ".." are resolved here since the
+	// index doesn't hold them.
+	wxFileName parts(filePath, wxPATH_DOS);
+	std::vector<std::string> path;
+
+	for (const wxString& dir : parts.GetDirs())
+	{
+		if (dir == L"..")
+		{
+			if (!path.empty())
+				path.pop_back();
+		}
+		else if (dir != L".")
+			path.push_back((const char*)dir.ToUTF8());
+	}
+
+	if (!parts.GetFullName().IsEmpty())
+		path.push_back((const char*)parts.GetFullName().ToUTF8());
+
+	if (path.empty())
+		throw Exception::FileNotFound(filePath);
+
+	std::string key = path[0];
+	for (size_t i = 1; i < path.size(); i++)
+		key += "/" + path[i];
+
+	std::lock_guard<std::mutex> lock(s_index_lock);
+
+	auto it = s_index.find(key);
+	if (it == s_index.end())
+		throw Exception::FileNotFound(filePath);
+
+	return it->second;
+}
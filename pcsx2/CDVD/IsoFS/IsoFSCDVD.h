@@ -18,6 +18,7 @@
 #include <stdio.h>
 
 #include "SectorSource.h"
+#include "IsoFileDescriptor.h"
 
 class IsoFSCDVD : public SectorSource
 {
@@ -28,4 +29,15 @@ public:
 	virtual bool readSector(unsigned char* buffer, int lba);
 
 	virtual int getNumSectors();
+
+	// Path lookups on the current disc go through an index of every directory on it, read once
+	// when the disc is first used instead of walking the directories again for each lookup.
+	// Throws Exception::FileNotFound, same as IsoDirectory::FindFile.
+	IsoFileDescriptor FindFile(const wxString& filePath);
+
+	// Builds the index if needed, throws if the disc has no ISO9660 root directory.
+	void LoadIndex();
+
+	// Drops the index, called whenever the disc is opened or closed.
+	static void ResetIndex();
 };
@@ -21,6 +21,8 @@
 #include "CompressedFileReader.h"
 #include <memory>
 
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
 enum isoType
 {
 	ISOTYPE_ILLEGAL = 0,
@@ -60,10 +62,46 @@ protected:
 	// total number of blocks in the ISO image (including all parts)
 	u32 m_blocks;
 
-	bool m_read_inprogress;
-	uint m_read_lsn;
-	uint m_read_count;
-	u8 m_readbuffer[MaxReadUnit * CD_FRAMESIZE_RAW];
+	// Sector reads are served from read windows of ReadUnit sectors. Each stream of sequential
+	// requests (FMV, audio, a file being loaded) owns two windows: the one being consumed and
+	// the read-ahead of what follows it, so interleaved streams don't evict each other.
+	static const uint MaxStreams = 4;
+
+	struct ReadWindow
+	{
+		uint lsn;
+		uint count;
+		bool pending; // BeginRead issued, FinishRead not yet called
+		bool ahead; // filled by read-ahead, not consumed yet
+		std::unique_ptr<u8[]> buffer;
+	};
+
+	struct ReadStream
+	{
+		ReadWindow window[2];
+		uint next; // sector that continues the stream
+		uint run; // sequential requests in a row
+		u64 used; // last request, for LRU replacement
+	};
+
+	struct ReadStats
+	{
+		u64 requests;
+		u64 hits; // already in a window
+		u64 ahead_hits; // in a window filled by read-ahead
+		u64 misses; // had to be read on demand
+		u64 ahead_waits; // blocked on a read-ahead still in flight
+		u64 ahead_wasted; // read-ahead windows replaced without use
+	};
+
+	ReadStream m_streams[MaxStreams];
+	ReadWindow* m_read_pending; // the only read in flight on m_reader
+	ReadWindow* m_read_window; // window holding m_current_lsn
+	ReadStream* m_read_stream;
+	ReadStats m_read_stats;
+	u64 m_read_tick;
+
+	const u8* m_mapped_block; // current sector when the reader is memory mapped, NULL otherwise
 
 public:
 	InputIsoFile();
@@ -74,6 +112,7 @@ public:
 	isoType GetType() const { return m_type; }
 	uint GetBlockCount() const { return m_blocks; }
 	int GetBlockOffset() const { return m_blockofs; }
+	uint GetBlockSize() const { return m_blocksize; }
 
 	const wxString& GetFilename() const
 	{
@@ -95,6 +134,11 @@ protected:
 
 	bool tryIsoType(u32 _size, s32 _offset, s32 _blockofs);
 	void FindParts();
+
+	int FinishPending();
+	void ReadWindowAt(ReadWindow& w, uint lsn);
+	void ReadAhead(ReadStream& s);
+	void LogReadStats() const;
 };
 
 class OutputIsoFile
@@ -118,7 +162,23 @@ protected:
 
 	std::unique_ptr<wxFileOutputStream> m_outstream;
 
+	// Seekable zstd output: sectors must arrive in order and are buffered into batches of
+	// fixed size frames, each batch is compressed by m_threads threads.
+	int m_level;
+	uint m_threads;
+	u32 m_next_lsn;
+	std::vector<u8> m_zframes;
+	std::vector<u32> m_zseek; // compressed/decompressed size pairs, one per frame written
+	std::vector<ZSTD_CCtx*> m_cctx;
+
 public:
+	enum
+	{
+		VersionPlain = 1,
+		VersionBlockdump = 2,
+		VersionZstd = 3, // requires PCSX2_ZSTD
+	};
+
 	OutputIsoFile();
 	virtual ~OutputIsoFile();
 
@@ -130,7 +190,13 @@ public:
 		return m_filename;
 	}
 
-	void Create(const wxString& filename, int mode);
+	// threads only applies to zstd output, 0 uses one thread per core.
+	void Create(const wxString& filename, int mode, int level = 0, uint threads = 0);
+
+	// Writes out what the format holds back until the end (zstd frames and seek table), and
+	// throws like the writes do.  Close never throws, so an image it closes unfinished is
+	// left incomplete.
+	void Finish();
 	void Close();
 
 	void WriteHeader(int blockofs, uint blocksize, uint blocks);
@@ -141,6 +207,9 @@ protected:
 	void _init();
 
 	void WriteBuffer(const void* src, size_t size);
+	void WriteZstdSector(const u8* src, uint lsn);
+	void FlushZstdFrames(bool final);
+	void WriteZstdSeekTable();
 
 	template <typename T>
 	void WriteValue(const T& data)
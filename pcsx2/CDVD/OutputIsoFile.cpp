@@ -19,6 +19,12 @@
 #include "IsoFileFormats.h"
 
 #include <errno.h>
+#include <thread>
+
+#ifdef PCSX2_ZSTD
+#include "ZstdFileReader.h"
+#include <zstd.h>
+#endif
 
 void pxStream_OpenCheck(const wxStreamBase& stream, const wxString& fname, const wxString& mode)
 {
@@ -48,9 +54,13 @@ void OutputIsoFile::_init()
 	m_blockofs = 0;
 	m_blocksize = 0;
 	m_blocks = 0;
+
+	m_level = 0;
+	m_threads = 1;
+	m_next_lsn = 0;
 }
 
-void OutputIsoFile::Create(const wxString& filename, int version)
+void OutputIsoFile::Create(const wxString& filename, int version, int level, uint threads)
 {
 	Close();
 	m_filename = filename;
@@ -59,6 +69,13 @@ void OutputIsoFile::Create(const wxString& filename, int version)
 	m_offset = 0;
 	m_blockofs = 24;
 	m_blocksize = 2048;
+	m_level = level;
+	m_threads = threads ? threads : std::max<uint>(std::thread::hardware_concurrency(), 1);
+
+#ifndef PCSX2_ZSTD
+	if (m_version == VersionZstd)
+		throw Exception::RuntimeError().SetDiagMsg(L"zstd output requested, but PCSX2 was built without zstd support");
+#endif
 
 	m_outstream = std::make_unique<wxFileOutputStream>(m_filename);
 	pxStream_OpenCheck(*m_outstream, m_filename, L"writing");
@@ -77,7 +94,7 @@ void OutputIsoFile::WriteHeader(int _blockofs, uint _blocksize, uint _blocks)
 	log_cb(RETRO_LOG_INFO, "blocksize   = %u\n", m_blocksize);
 	log_cb(RETRO_LOG_INFO, "blocks	     = %u\n", m_blocks);
 
-	if (m_version == 2)
+	if (m_version == VersionBlockdump)
 	{
 		WriteBuffer("BDV2", 4);
 		WriteValue(m_blocksize);
@@ -88,7 +105,13 @@ void OutputIsoFile::WriteHeader(int _blockofs, uint _blocksize, uint _blocks)
 
 void OutputIsoFile::WriteSector(const u8* src, uint lsn)
 {
-	if (m_version == 2)
+	if (m_version == VersionZstd)
+	{
+		WriteZstdSector(src + m_blockofs, lsn);
+		return;
+	}
+
+	if (m_version == VersionBlockdump)
 	{
 		// Find and ignore blocks that have already been dumped:
 		if (std::any_of(std::begin(m_dtable), std::end(m_dtable), [=](const u32 entry) { return entry == lsn; }))
@@ -108,13 +131,127 @@ void OutputIsoFile::WriteSector(const u8* src, uint lsn)
 	WriteBuffer(src + m_blockofs, m_blocksize);
 }
 
+void OutputIsoFile::Finish()
+{
+	if (m_version == VersionZstd && IsOpened())
+	{
+		FlushZstdFrames(true);
+		WriteZstdSeekTable();
+	}
+}
+
 void OutputIsoFile::Close()
 {
+#ifdef PCSX2_ZSTD
+	for (ZSTD_CCtx* cctx : m_cctx)
+		ZSTD_freeCCtx(cctx);
+#endif
+	m_cctx.clear();
+	m_zframes.clear();
+	m_zseek.clear();
 	m_dtable.clear();
+	m_outstream.reset();
 
 	_init();
 }
 
+#ifdef PCSX2_ZSTD
+
+// Seekable zstd images can't seek backwards, so sectors are written in order: gaps are
+// zero filled and sectors already written are ignored, same as blockdumps.
+void OutputIsoFile::WriteZstdSector(const u8* src, uint lsn)
+{
+	if (lsn < m_next_lsn)
+		return;
+
+	for (; m_next_lsn < lsn; m_next_lsn++)
+		m_zframes.insert(m_zframes.end(), m_blocksize, 0);
+
+	m_zframes.insert(m_zframes.end(), src, src + m_blocksize);
+	m_next_lsn++;
+
+	const size_t frame_size = ZSTD_FRAME_SECTORS * m_blocksize;
+	const size_t batch = frame_size * m_threads * 4;
+
+	if (m_zframes.size() >= batch)
+		FlushZstdFrames(false);
+}
+
+void OutputIsoFile::FlushZstdFrames(bool final)
+{
+	const size_t frame_size = ZSTD_FRAME_SECTORS * m_blocksize;
+	const size_t frames = final ? (m_zframes.size() + frame_size - 1) / frame_size : m_zframes.size() / frame_size;
+
+	if (frames == 0)
+		return;
+
+	const uint threads = std::min<size_t>(m_threads, frames);
+
+	while (m_cctx.size() < threads)
+	{
+		ZSTD_CCtx* cctx = ZSTD_createCCtx();
+		if (!cctx)
+			throw Exception::OutOfMemory(L"ZSTD_createCCtx");
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, m_level);
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 0);
+		m_cctx.push_back(cctx);
+	}
+
+	std::vector<std::vector<u8>> out(frames);
+	std::vector<size_t> result(frames);
+
+	// Frames are independent, thread i compresses frames i, i + threads, ...
+	auto compress = [&](uint t) {
+		for (size_t f = t; f < frames; f += threads)
+		{
+			const size_t size = std::min(frame_size, m_zframes.size() - f * frame_size);
+			out[f].resize(ZSTD_compressBound(size));
+			result[f] = ZSTD_compress2(m_cctx[t], out[f].data(), out[f].size(), m_zframes.data() + f * frame_size, size);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (uint t = 1; t < threads; t++)
+		workers.emplace_back(compress, t);
+	compress(0);
+	for (std::thread& t : workers)
+		t.join();
+
+	for (size_t f = 0; f < frames; f++)
+	{
+		if (ZSTD_isError(result[f]))
+			throw Exception::BadStream(m_filename).SetDiagMsg(pxsFmt(L"zstd compression failed: %s", WX_STR(fromUTF8(ZSTD_getErrorName(result[f])))));
+
+		WriteBuffer(out[f].data(), result[f]);
+		m_zseek.push_back((u32)result[f]);
+		m_zseek.push_back((u32)std::min(frame_size, m_zframes.size() - f * frame_size));
+	}
+
+	m_zframes.erase(m_zframes.begin(), m_zframes.begin() + std::min(m_zframes.size(), frames * frame_size));
+}
+
+void OutputIsoFile::WriteZstdSeekTable()
+{
+	const u32 entries = (u32)(m_zseek.size() / 2);
+
+	WriteValue<u32>(ZSTD_SKIPPABLE_SEEKTABLE);
+	WriteValue<u32>(entries * 8 + ZSTD_SEEKTABLE_FOOTER_SIZE);
+	if (entries)
+		WriteBuffer(m_zseek.data(), m_zseek.size() * sizeof(u32));
+
+	WriteValue<u32>(entries);
+	WriteValue<u8>(0); // no per frame checksums
+	WriteValue<u32>(ZSTD_SEEKABLE_MAGIC);
+}
+
+#else
+
+void OutputIsoFile::WriteZstdSector(const u8* src, uint lsn) {}
+void OutputIsoFile::FlushZstdFrames(bool final) {}
+void OutputIsoFile::WriteZstdSeekTable() {}
+
+#endif
+
 void OutputIsoFile::WriteBuffer(const void* src, size_t size)
 {
 	m_outstream->Write(src, size);
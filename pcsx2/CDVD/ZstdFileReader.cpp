@@ -0,0 +1,393 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "AsyncFileReader.h"
+#include "CompressedFileReaderUtils.h"
+#include "IsoFileFormats.h"
+#include "ZstdFileReader.h"
+#include "Pcsx2Types.h"
+#include <thread>
+#include <zstd.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+// Implementation of the zstd seekable format, based on:
+// https://github.com/facebook/zstd/blob/dev/contrib/seekable_format/zstd_seekable_compression_format.md
+//
+// [frame 0] ... [frame n-1] [skippable frame: n x {u32 compressed, u32 decompressed}, footer]
+// footer: u32 number of frames, u8 descriptor (bit 7: entries carry a checksum), u32 seekable magic
+
+bool ZstdFileReader::CanHandle(const wxString& fileName)
+{
+	bool supported = false;
+	if (wxFileName::FileExists(fileName) && fileName.Lower().EndsWith(L".zst"))
+	{
+		FILE* fp = PX_fopen_rb(fileName);
+		if (fp)
+		{
+			u8 footer[ZSTD_SEEKTABLE_FOOTER_SIZE];
+			if (PX_fseeko(fp, -(PX_off_t)sizeof(footer), SEEK_END) == 0 && fread(footer, 1, sizeof(footer), fp) == sizeof(footer))
+			{
+				supported = *(u32*)(footer + 5) == ZSTD_SEEKABLE_MAGIC;
+			}
+			fclose(fp);
+		}
+	}
+	return supported;
+}
+
+bool ZstdFileReader::Open(const wxString& fileName)
+{
+	Close();
+	m_filename = fileName;
+	m_src = PX_fopen_rb(m_filename);
+
+	bool success = false;
+	if (m_src && ReadSeekTable())
+	{
+		m_dctx = ZSTD_createDCtx();
+		success = m_dctx != NULL;
+	}
+
+	if (!success)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool ZstdFileReader::ReadSeekTable()
+{
+	u8 footer[ZSTD_SEEKTABLE_FOOTER_SIZE];
+
+	if (PX_fseeko(m_src, -(PX_off_t)sizeof(footer), SEEK_END) != 0 || fread(footer, 1, sizeof(footer), m_src) != sizeof(footer))
+	{
+		log_cb(RETRO_LOG_ERROR, "Failed to read zstd seek table footer.\n");
+		return false;
+	}
+
+	const u32 frames = *(u32*)(footer + 0);
+	const u8 descriptor = footer[4];
+	const u32 entrySize = (descriptor & 0x80) ? 12 : 8;
+
+	if (*(u32*)(footer + 5) != ZSTD_SEEKABLE_MAGIC || (descriptor & 0x7c) != 0 || frames == 0)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd file has an invalid seek table.\n");
+		return false;
+	}
+
+	// The frame count sizes every allocation below, so it has to fit in the file along with
+	// the skippable frame header (u32 magic, u32 size) in front of the table.
+	PX_off_t fileSize = PX_ftello(m_src);
+	const u64 tableSize = (u64)frames * entrySize + sizeof(footer);
+	if (fileSize < 0 || tableSize + 8 > (u64)fileSize)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd seek table is larger than the file.\n");
+		return false;
+	}
+	const u64 tableStart = (u64)fileSize - tableSize - 8;
+
+	u32 header[2];
+	std::unique_ptr<u8[]> table(new u8[(size_t)frames * entrySize]);
+	if (PX_fseeko(m_src, (PX_off_t)tableStart, SEEK_SET) != 0 || fread(header, sizeof(header), 1, m_src) != 1 ||
+		fread(table.get(), entrySize, frames, m_src) != frames)
+	{
+		log_cb(RETRO_LOG_ERROR, "Unable to read the zstd seek table.\n");
+		return false;
+	}
+
+	if (header[0] != ZSTD_SKIPPABLE_SEEKTABLE || header[1] != tableSize)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd seek table is not in a skippable frame.\n");
+		return false;
+	}
+
+	m_numFrames = frames;
+	m_frameSize = *(u32*)(table.get() + 4);
+
+	// Whole frames are decompressed per read, so a frame size from the file is only trusted
+	// up to a sane number of sectors.
+	if (m_frameSize == 0 || m_frameSize > ZSTD_MAX_FRAME_SIZE)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd frame size %u is not usable for a disc image.\n", m_frameSize);
+		return false;
+	}
+
+	m_index = new u64[frames + 1];
+	m_index[0] = 0;
+	m_totalSize = 0;
+
+	u32 maxCompressed = 0;
+	for (u32 i = 0; i < frames; i++)
+	{
+		const u32 compressed = *(u32*)(table.get() + i * entrySize + 0);
+		const u32 decompressed = *(u32*)(table.get() + i * entrySize + 4);
+
+		// Sector lookups divide by the frame size, only the last frame may be shorter.
+		if (decompressed == 0 || decompressed > m_frameSize || (decompressed != m_frameSize && i + 1 != frames))
+		{
+			log_cb(RETRO_LOG_ERROR, "zstd frames must have a fixed size to be used as a disc image.\n");
+			return false;
+		}
+
+		if (compressed == 0 || compressed > ZSTD_compressBound(m_frameSize))
+		{
+			log_cb(RETRO_LOG_ERROR, "zstd seek table entry %u is corrupt.\n", i);
+			return false;
+		}
+
+		m_index[i + 1] = m_index[i] + compressed;
+		m_totalSize += decompressed;
+		maxCompressed = std::max(maxCompressed, compressed);
+	}
+
+	// The frames have to tile the file exactly up to the seek table.
+	if (m_index[frames] != tableStart)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd seek table does not match the frames in the file.\n");
+		return false;
+	}
+
+	m_readBuffer = new u8[maxCompressed];
+	m_frameBuffer = new u8[m_frameSize];
+	m_bufferFrame = frames;
+
+	return true;
+}
+
+void ZstdFileReader::Close()
+{
+	m_filename.Empty();
+
+	if (m_src)
+	{
+		fclose(m_src);
+		m_src = NULL;
+	}
+	if (m_dctx)
+	{
+		ZSTD_freeDCtx(m_dctx);
+		m_dctx = NULL;
+	}
+
+	if (m_readBuffer)
+	{
+		delete[] m_readBuffer;
+		m_readBuffer = NULL;
+	}
+	if (m_frameBuffer)
+	{
+		delete[] m_frameBuffer;
+		m_frameBuffer = NULL;
+	}
+	if (m_index)
+	{
+		delete[] m_index;
+		m_index = NULL;
+	}
+}
+
+int ZstdFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+{
+	if (!m_src)
+	{
+		return 0;
+	}
+
+	u8* dest = (u8*)pBuffer;
+	u64 pos = (u64)sector * (u64)m_blocksize + m_dataoffset;
+	int remaining = count * m_blocksize;
+	int bytes = 0;
+
+	while (remaining > 0)
+	{
+		int readBytes = ReadFromFrame(dest + bytes, pos + bytes, remaining);
+		if (readBytes == 0)
+		{
+			// We hit EOF.
+			break;
+		}
+
+		bytes += readBytes;
+		remaining -= readBytes;
+	}
+
+	return bytes;
+}
+
+int ZstdFileReader::ReadFromFrame(u8* dest, u64 pos, int maxBytes)
+{
+	if (pos >= m_totalSize)
+	{
+		// Can't read anything passed the end.
+		return 0;
+	}
+
+	const u32 frame = (u32)(pos / m_frameSize);
+	const u32 offset = (u32)(pos - (u64)frame * m_frameSize);
+	const u32 bytes = (u32)std::min<u64>(std::min<u64>(maxBytes, m_frameSize - offset), m_totalSize - pos);
+
+	// We don't need to decompress if we already did this same frame last time.
+	if (m_bufferFrame != frame && !DecompressFrame(frame))
+	{
+		return 0;
+	}
+
+	memcpy(dest, m_frameBuffer + offset, bytes);
+
+	return bytes;
+}
+
+bool ZstdFileReader::DecompressFrame(u32 frame)
+{
+	const u64 rawSize = m_index[frame + 1] - m_index[frame];
+
+	if (PX_fseeko(m_src, m_index[frame], SEEK_SET) != 0 || fread(m_readBuffer, 1, rawSize, m_src) != rawSize)
+	{
+		log_cb(RETRO_LOG_ERROR, "Unable to read compressed zstd frame.\n");
+		m_bufferFrame = m_numFrames;
+		return false;
+	}
+
+	const size_t size = ZSTD_decompressDCtx(m_dctx, m_frameBuffer, m_frameSize, m_readBuffer, rawSize);
+	const u64 expected = std::min<u64>(m_frameSize, m_totalSize - (u64)frame * m_frameSize);
+
+	if (ZSTD_isError(size) || size != expected)
+	{
+		log_cb(RETRO_LOG_ERROR, "Unable to decompress zstd frame %u: %s\n", frame, ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch");
+		m_bufferFrame = m_numFrames;
+		return false;
+	}
+
+	// Our buffer now contains this frame.
+	m_bufferFrame = frame;
+	return true;
+}
+
+void ZstdFileReader::BeginRead(void* pBuffer, uint sector, uint count)
+{
+	// TODO: No async support yet, implement as sync.
+	m_bytesRead = ReadSync(pBuffer, sector, count);
+}
+
+int ZstdFileReader::FinishRead()
+{
+	int res = m_bytesRead;
+	m_bytesRead = -1;
+	return res;
+}
+
+void ZstdFileReader::CancelRead()
+{
+	// TODO: No async read support yet.
+}
+
+bool ZstdFileReader::Convert(const wxString& srcfile, const wxString& dstfile, int level, const std::atomic<bool>* cancel, uint threads)
+{
+	InputIsoFile src;
+	OutputIsoFile dst;
+	bool done = false;
+
+	try
+	{
+		if (!src.Open(srcfile))
+		{
+			log_cb(RETRO_LOG_ERROR, "zstd convert: unable to open '%s'\n", WX_STR(srcfile));
+			return false;
+		}
+
+		dst.Create(dstfile, OutputIsoFile::VersionZstd, level, threads);
+		dst.WriteHeader(src.GetBlockOffset(), src.GetBlockSize(), src.GetBlockCount());
+
+		std::unique_ptr<u8[]> sector(new u8[CD_FRAMESIZE_RAW * 2]);
+
+		uint lsn = 0;
+		for (; lsn < src.GetBlockCount(); lsn++)
+		{
+			if (cancel && cancel->load(std::memory_order_relaxed))
+			{
+				log_cb(RETRO_LOG_WARN, "zstd convert: '%s' cancelled\n", WX_STR(srcfile));
+				break;
+			}
+
+			if (src.ReadSync(sector.get(), lsn) < 0)
+			{
+				log_cb(RETRO_LOG_ERROR, "zstd convert: unable to read sector %u of '%s'\n", lsn, WX_STR(srcfile));
+				break;
+			}
+
+			dst.WriteSector(sector.get(), lsn);
+
+			if ((lsn & 0xffff) == 0)
+				log_cb(RETRO_LOG_INFO, "zstd convert: %u%%\n", (uint)(100ull * lsn / src.GetBlockCount()));
+		}
+
+		if (lsn == src.GetBlockCount())
+		{
+			dst.Finish();
+			done = true;
+		}
+	}
+	catch (BaseException& ex)
+	{
+		log_cb(RETRO_LOG_ERROR, "zstd convert: %s\n", WX_STR(ex.FormatDiagnosticMessage()));
+	}
+
+	dst.Close();
+
+	if (!done)
+	{
+		wxRemoveFile(dstfile);
+		return false;
+	}
+
+	log_cb(RETRO_LOG_INFO, "zstd convert: '%s' -> '%s' done\n", WX_STR(srcfile), WX_STR(dstfile));
+	return true;
+}
+
+static std::thread s_convert_thread;
+static std::atomic<bool> s_convert_cancel(false);
+
+void ZstdFileReader::ConvertInBackground(const wxString& srcfile, const wxString& dstfile)
+{
+	CancelConvert();
+
+	s_convert_cancel.store(false, std::memory_order_relaxed);
+	s_convert_thread = std::thread([srcfile, dstfile]() {
+#if defined(_WIN32)
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#elif defined(__linux__)
+		sched_param param = {};
+		pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#else
+		setpriority(PRIO_PROCESS, 0, 19);
+#endif
+		Convert(srcfile, dstfile, 9, &s_convert_cancel, 1);
+	});
+}
+
+void ZstdFileReader::CancelConvert()
+{
+	if (!s_convert_thread.joinable())
+		return;
+
+	s_convert_cancel.store(true, std::memory_order_relaxed);
+	s_convert_thread.join();
+}
@@ -0,0 +1,106 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "AsyncFileReader.h"
+
+#include <atomic>
+
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+// Sectors per frame when converting, 64KB for 2048 byte images.
+static const uint ZSTD_FRAME_SECTORS = 32;
+
+// Largest frame accepted when reading, 1024 sectors of the biggest block size (2448 bytes).
+static const u32 ZSTD_MAX_FRAME_SIZE = 1024 * 2448;
+
+static const u32 ZSTD_SEEKABLE_MAGIC = 0x8F92EAB1;
+static const u32 ZSTD_SKIPPABLE_SEEKTABLE = 0x184D2A5E;
+static const uint ZSTD_SEEKTABLE_FOOTER_SIZE = 9;
+
+// Reader for the zstd seekable format: independent zstd frames of a fixed uncompressed size,
+// followed by a seek table in a skippable frame. The file is a plain zstd stream for every
+// other tool, so `zstd -d` restores the original image.
+class ZstdFileReader : public AsyncFileReader
+{
+	DeclareNoncopyableObject(ZstdFileReader);
+
+public:
+	ZstdFileReader(void)
+		: m_frameSize(0)
+		, m_numFrames(0)
+		, m_readBuffer(0)
+		, m_frameBuffer(0)
+		, m_bufferFrame(0)
+		, m_index(0)
+		, m_totalSize(0)
+		, m_src(0)
+		, m_dctx(0)
+		, m_bytesRead(0)
+	{
+		m_blocksize = 2048;
+	};
+
+	virtual ~ZstdFileReader(void) { Close(); };
+
+	static bool CanHandle(const wxString& fileName);
+	virtual bool Open(const wxString& fileName);
+
+	virtual int ReadSync(void* pBuffer, uint sector, uint count);
+
+	virtual void BeginRead(void* pBuffer, uint sector, uint count);
+	virtual int FinishRead(void);
+	virtual void CancelRead(void);
+
+	virtual void Close(void);
+
+	virtual uint GetBlockCount(void) const
+	{
+		return (m_totalSize - m_dataoffset) / m_blocksize;
+	};
+
+	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
+	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+	// Converts anything InputIsoFile can open into the seekable zstd format, compressing on
+	// threads threads (0: all cores).  Gives up when *cancel turns true.  Incomplete output is removed.
+	static bool Convert(const wxString& srcfile, const wxString& dstfile, int level = 9, const std::atomic<bool>* cancel = NULL, uint threads = 0);
+
+	// Runs Convert next to the game on a single idle priority thread, one conversion at a time,
+	// so it only takes CPU time the emulator leaves unused.  CancelConvert stops it and waits
+	// for the thread.
+	static void ConvertInBackground(const wxString& srcfile, const wxString& dstfile);
+	static void CancelConvert();
+
+private:
+	bool ReadSeekTable();
+	int ReadFromFrame(u8* dest, u64 pos, int maxBytes);
+	bool DecompressFrame(u32 frame);
+
+	u32 m_frameSize;
+	u32 m_numFrames;
+	u8* m_readBuffer;
+	u8* m_frameBuffer;
+	u32 m_bufferFrame;
+	// Compressed offset of each frame, plus the end of the last one.
+	u64* m_index;
+	u64 m_totalSize;
+	FILE* m_src;
+	ZSTD_DCtx* m_dctx;
+
+	// The result of a read is stored here between BeginRead() and FinishRead().
+	int m_bytesRead;
+};
@@ -47,7 +47,7 @@ Comments) 1950 to 1952 in the files http://tools.ietf.org/html/rfc1950
       But they're still aligned since each member size is multiple of 4, so no perf issues.
   - extract: added state import/export for instant sequential access regardless of index
       (Thanks to Mark Adler for suggesting the approach)
-  - build_index(...) - added progress prints
+  - build_index(...) - added progress prints (through log_cb)
   - CHUNK changed from 16k to 512k
  */
 
@@ -314,7 +314,7 @@ local int build_index(FILE* in, PX_off_t span, struct access** built)
 		} while (strm.avail_in != 0);
 		if (totin / (50 * 1024 * 1024) != totPrinted / (50 * 1024 * 1024))
 		{
-			printf("%dMB ", (int)(totin / (1024 * 1024)));
+			log_cb(RETRO_LOG_INFO, "gzip index: %d MB scanned\n", (int)(totin / (1024 * 1024)));
 			totPrinted = totin;
 		}
 	} while (ret != Z_STREAM_END);
@@ -102,7 +102,8 @@ struct Pcsx2Config
 
 			bool
 				UseMicroVU0		:1,
-				UseMicroVU1		:1;
+				UseMicroVU1		:1,
+				EnableFastmem	:1;
 
 			bool
 				vuOverflow		:1,
@@ -0,0 +1,642 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "CoreBenchmark.h"
+
+#include "Elfheader.h"
+#include "IopCommon.h"
+#include "R5900Exceptions.h"
+#include "VUmicro.h"
+
+#include <chrono>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+static const uint WarmupMs = 50;			// long enough for the recompilers to compile everything
+static const u32 SliceCycles = 1 << 18;		// EE cycles between looks at the clock
+static const u32 VUSliceCycles = 1 << 16;
+
+// --------------------------------------------------------------------------------------
+//  EE and IOP test programs
+// --------------------------------------------------------------------------------------
+// Each program is an endless loop that adds one to s0 per iteration, and every iteration
+// runs the same number of instructions whichever way its branches go, so s0 times the
+// iteration length is the number of instructions run.  The IOP ones stick to MIPS I and
+// don't use a loaded register in the load's delay slot.
+
+class MipsProgramBuilder
+{
+public:
+	enum Reg : u32 { zero = 0, v0 = 2, a0 = 4, a1 = 5, t0 = 8, t1, t2, t3, t4, t5, t6, t7, s0 = 16, t8 = 24, t9 = 25, ra = 31 };
+	enum Special : u32 { SLL = 0x00, SRL = 0x02, SRA = 0x03, JR = 0x08, ADDU = 0x21, SUBU = 0x23, AND = 0x24, OR = 0x25, XOR = 0x26, SLT = 0x2a, DADDU = 0x2d };
+	enum Opcode : u32 { JAL = 0x03, BEQ = 0x04, ADDIU = 0x09, ANDI = 0x0c, LUI = 0x0f, LQ = 0x1e, SQ = 0x1f, LW = 0x23, LBU = 0x24, LHU = 0x25, SB = 0x28, SH = 0x29, SW = 0x2b, LD = 0x37, SD = 0x3f };
+	enum Cop1 : u32 { ADD_S = 0x00, SUB_S = 0x01, MUL_S = 0x02 };
+
+	const char* name;
+	u32 entry;
+	std::vector<u32> code;
+	uint iteration_length;
+
+	MipsProgramBuilder(const char* name, u32 entry)
+		: name(name)
+		, entry(entry)
+		, iteration_length(0)
+	{
+	}
+
+	uint Here() const { return code.size(); }
+
+	void Rtype(Special funct, u32 rd, u32 rs, u32 rt, u32 sa = 0) { code.push_back(rs << 21 | rt << 16 | rd << 11 | sa << 6 | funct); }
+	void Itype(Opcode op, u32 rt, u32 rs, u16 imm) { code.push_back(op << 26 | rs << 21 | rt << 16 | imm); }
+	void Cop1S(Cop1 funct, u32 fd, u32 fs, u32 ft) { code.push_back(0x46000000 | ft << 16 | fs << 11 | fd << 6 | funct); }
+	void Mtc1(u32 rt, u32 fs) { code.push_back(0x44800000 | rt << 16 | fs << 11); }
+	void Nop() { code.push_back(0); }
+
+	// Branches and calls to an instruction index; forward ones are emitted with Here() as
+	// their target and fixed up with Bind() once the target is known.
+	void Beq(u32 rs, u32 rt, uint target) { Itype(BEQ, rt, rs, (u16)(target - Here() - 1)); }
+	void Jal(uint target) { code.push_back(JAL << 26 | (((entry + target * 4) >> 2) & 0x03ffffff)); }
+	void Bind(uint at)
+	{
+		const uint target = Here();
+		if ((code[at] >> 26) == JAL)
+			code[at] = JAL << 26 | (((entry + target * 4) >> 2) & 0x03ffffff);
+		else
+			code[at] = (code[at] & 0xffff0000) | (u16)(target - at - 1);
+	}
+
+	// Closes the loop started at loop_start: the iteration counter goes in the delay slot.
+	void EndLoop(uint loop_start, uint length)
+	{
+		Beq(zero, zero, loop_start);
+		Itype(ADDIU, s0, s0, 1);
+		iteration_length = length;
+	}
+};
+
+// Dependent integer arithmetic, shifts and compares.
+static MipsProgramBuilder BuildAluProgram(u32 entry, bool iop = false)
+{
+	typedef MipsProgramBuilder B;
+	B p("alu", entry);
+
+	p.Itype(B::ADDIU, B::t0, B::zero, 1);
+	p.Itype(B::ADDIU, B::t1, B::zero, 3);
+	p.Itype(B::LUI, B::t2, B::zero, 0x1234);
+
+	const uint loop = p.Here();
+	p.Rtype(B::ADDU, B::t3, B::t0, B::t1);
+	p.Rtype(B::XOR, B::t4, B::t3, B::t2);
+	p.Rtype(B::SLL, B::t5, B::zero, B::t4, 3);
+	p.Rtype(B::SRL, B::t6, B::zero, B::t5, 1);
+	p.Rtype(B::SUBU, B::t7, B::t6, B::t0);
+	p.Rtype(B::OR, B::t0, B::t7, B::t3);
+	p.Rtype(B::AND, B::t1, B::t0, B::t4);
+	p.Rtype(B::SLT, B::t8, B::t1, B::t5);
+	p.Rtype(iop ? B::ADDU : B::DADDU, B::t9, B::t8, B::t0);
+	p.Itype(B::ADDIU, B::t1, B::t1, 7);
+	p.Rtype(B::SRA, B::t2, B::zero, B::t9, 2);
+	p.Rtype(B::XOR, B::t2, B::t2, B::t5);
+	p.EndLoop(loop, 14);
+	return p;
+}
+
+// Loads and stores of every size through a base register that moves within a page, so
+// the recompiler cannot resolve the addresses at compile time.
+static MipsProgramBuilder BuildMemoryProgram(u32 entry, u32 data)
+{
+	typedef MipsProgramBuilder B;
+	B p("memory", entry);
+
+	p.Itype(B::LUI, B::a0, B::zero, data >> 16);
+
+	const uint loop = p.Here();
+	p.Itype(B::ANDI, B::t6, B::s0, 0x3f0);
+	p.Rtype(B::ADDU, B::a1, B::a0, B::t6);
+	p.Itype(B::LW, B::t0, B::a1, 0);
+	p.Itype(B::ADDIU, B::t0, B::t0, 1);
+	p.Itype(B::SW, B::t0, B::a1, 0);
+	p.Itype(B::LD, B::t1, B::a1, 8);
+	p.Rtype(B::DADDU, B::t1, B::t1, B::t0);
+	p.Itype(B::SD, B::t1, B::a1, 8);
+	p.Itype(B::LQ, B::t2, B::a1, 16);
+	p.Itype(B::SQ, B::t2, B::a1, 32);
+	p.Itype(B::LW, B::t3, B::a1, 64);
+	p.Itype(B::LBU, B::t4, B::a1, 65);
+	p.Itype(B::SB, B::t4, B::a1, 66);
+	p.Itype(B::LHU, B::t5, B::a1, 68);
+	p.Itype(B::SH, B::t5, B::a1, 70);
+	p.Rtype(B::ADDU, B::t3, B::t3, B::t5);
+	p.Itype(B::SW, B::t3, B::a1, 64);
+	p.EndLoop(loop, 19);
+	return p;
+}
+
+// The IOP's loads and stores: words, halves and bytes, nothing wider.
+static MipsProgramBuilder BuildIopMemoryProgram(u32 entry, u32 data)
+{
+	typedef MipsProgramBuilder B;
+	B p("memory", entry);
+
+	p.Itype(B::LUI, B::a0, B::zero, data >> 16);
+
+	const uint loop = p.Here();
+	p.Itype(B::ANDI, B::t6, B::s0, 0x3f0);
+	p.Rtype(B::ADDU, B::a1, B::a0, B::t6);
+	p.Itype(B::LW, B::t0, B::a1, 0);
+	p.Itype(B::LHU, B::t5, B::a1, 68);
+	p.Itype(B::ADDIU, B::t0, B::t0, 1);
+	p.Itype(B::SW, B::t0, B::a1, 0);
+	p.Itype(B::LBU, B::t4, B::a1, 65);
+	p.Itype(B::LW, B::t3, B::a1, 64);
+	p.Itype(B::SB, B::t4, B::a1, 66);
+	p.Itype(B::SH, B::t5, B::a1, 70);
+	p.Rtype(B::ADDU, B::t3, B::t3, B::t5);
+	p.Itype(B::SW, B::t3, B::a1, 64);
+	p.EndLoop(loop, 14);
+	return p;
+}
+
+// A data dependent branch that goes either way every other iteration, and two calls to a
+// function that returns through jr (an indirect jump for the recompiler).
+static MipsProgramBuilder BuildBranchProgram(u32 entry)
+{
+	typedef MipsProgramBuilder B;
+	B p("branch", entry);
+
+	const uint loop = p.Here();
+	const uint call1 = p.Here();
+	p.Jal(call1);
+	p.Nop();
+	p.Itype(B::ANDI, B::t0, B::s0, 1);
+	const uint to_even = p.Here();
+	p.Beq(B::t0, B::zero, to_even);
+	p.Nop();
+	p.Itype(B::ADDIU, B::t1, B::t1, 1);
+	const uint to_join = p.Here();
+	p.Beq(B::zero, B::zero, to_join);
+	p.Nop();
+
+	p.Bind(to_even);
+	p.Itype(B::ADDIU, B::t2, B::t2, 1);
+	p.Itype(B::ADDIU, B::t3, B::t3, 2);
+	p.Itype(B::ADDIU, B::t4, B::t4, 3);
+
+	p.Bind(to_join);
+	const uint call2 = p.Here();
+	p.Jal(call2);
+	p.Nop();
+	p.EndLoop(loop, 18);
+
+	p.Bind(call1);
+	p.Bind(call2);
+	p.Rtype(B::ADDU, B::v0, B::v0, B::s0);
+	p.Rtype(B::JR, 0, B::ra, 0);
+	p.Nop();
+	return p;
+}
+
+// Single precision adds, subtracts and multiplies on the FPU.
+static MipsProgramBuilder BuildFpuProgram(u32 entry)
+{
+	typedef MipsProgramBuilder B;
+	B p("fpu", entry);
+
+	p.Itype(B::LUI, B::t0, B::zero, 0x3f80); // 1.0f
+	p.Mtc1(B::t0, 1);
+	p.Itype(B::LUI, B::t0, B::zero, 0x3f00); // 0.5f
+	p.Mtc1(B::t0, 2);
+	p.Mtc1(B::zero, 3);
+	p.Mtc1(B::zero, 4);
+
+	const uint loop = p.Here();
+	p.Cop1S(B::ADD_S, 3, 3, 1);
+	p.Cop1S(B::MUL_S, 5, 3, 2);
+	p.Cop1S(B::SUB_S, 6, 5, 1);
+	p.Cop1S(B::ADD_S, 4, 4, 6);
+	p.Cop1S(B::MUL_S, 7, 6, 2);
+	p.Cop1S(B::ADD_S, 8, 7, 4);
+	p.Cop1S(B::MUL_S, 9, 8, 2);
+	p.Cop1S(B::SUB_S, 10, 9, 5);
+	p.EndLoop(loop, 10);
+	return p;
+}
+
+// A single loadable segment at entry, the way a linker lays out a minimal executable.
+static std::vector<u8> BuildElfImage(const MipsProgramBuilder& program)
+{
+	ELF_HEADER header = {};
+	ELF_PHR segment = {};
+	const u32 size = program.code.size() * sizeof(u32);
+
+	header.e_ident[0] = 0x7f;
+	header.e_ident[1] = 'E';
+	header.e_ident[2] = 'L';
+	header.e_ident[3] = 'F';
+	header.e_ident[4] = 1; // 32 bit
+	header.e_ident[5] = 1; // little endian
+	header.e_ident[6] = 1; // current version
+	header.e_type = 2;
+	header.e_machine = 8;
+	header.e_version = 1;
+	header.e_entry = program.entry;
+	header.e_phoff = sizeof(ELF_HEADER);
+	header.e_ehsize = sizeof(ELF_HEADER);
+	header.e_phentsize = sizeof(ELF_PHR);
+	header.e_phnum = 1;
+
+	segment.p_type = 1;
+	segment.p_offset = sizeof(ELF_HEADER) + sizeof(ELF_PHR);
+	segment.p_vaddr = program.entry;
+	segment.p_paddr = program.entry;
+	segment.p_filesz = size;
+	segment.p_memsz = size;
+	segment.p_flags = 5; // read, execute
+	segment.p_align = 0x10;
+
+	std::vector<u8> image(segment.p_offset + size);
+	memcpy(&image[0], &header, sizeof(header));
+	memcpy(&image[sizeof(header)], &segment, sizeof(segment));
+	memcpy(&image[segment.p_offset], program.code.data(), size);
+	return image;
+}
+
+// --------------------------------------------------------------------------------------
+//  VU0 test program
+// --------------------------------------------------------------------------------------
+// A loop of dependent FMAC operations beside integer, load/store and branch lower ops,
+// ending on an E bit.  Every pair of upper and lower instructions counts as one.
+
+enum VUUpperOp : u32 { VU_ADDx = 0x00, VU_ADD = 0x28, VU_MADD = 0x29, VU_MUL = 0x2a };
+
+static const u32 VUNopUpper = 0x000002ff;
+static const u32 VUNopLower = 0x8000033c; // move.xyzw vf00, vf00
+static const u32 VUEbit = 0x40000000;
+static const u32 VUProgramLoops = 1000;
+static const u32 VUProgramLength = 1 + VUProgramLoops * 6 + 2;
+
+static constexpr u32 VUUpper(VUUpperOp op, u32 fd, u32 fs, u32 ft) { return 0x01e00000 | ft << 16 | fs << 11 | fd << 6 | op; }
+static constexpr u32 VUIaddiu(u32 it, u32 is, u32 imm) { return 0x08 << 25 | ((imm >> 11) & 0xf) << 21 | it << 16 | is << 11 | (imm & 0x7ff); }
+static constexpr u32 VUIaddi(u32 it, u32 is, s32 imm) { return 0x80000000 | it << 16 | is << 11 | (imm & 0x1f) << 6 | 0x32; }
+static constexpr u32 VULq(u32 ft, u32 is, s32 imm) { return 0x00 << 25 | 0xf << 21 | ft << 16 | is << 11 | (imm & 0x7ff); }
+static constexpr u32 VUSq(u32 fs, u32 it, s32 imm) { return 0x01 << 25 | 0xf << 21 | it << 16 | fs << 11 | (imm & 0x7ff); }
+static constexpr u32 VUIbne(u32 it, u32 is, s32 imm) { return 0x29 << 25 | it << 16 | is << 11 | (imm & 0x7ff); }
+
+// Lower word first, as in micro memory.
+static const u32 VU0Program[][2] = {
+	{VUIaddiu(1, 0, VUProgramLoops), VUNopUpper},
+	{VUIaddi(1, 1, -1), VUUpper(VU_ADD, 1, 1, 2)},	// loop:
+	{VULq(9, 0, 0), VUUpper(VU_MUL, 3, 1, 4)},
+	{VUSq(5, 0, 1), VUUpper(VU_MADD, 5, 3, 6)},
+	{VUNopLower, VUUpper(VU_ADDx, 7, 5, 2)},
+	{VUIbne(1, 0, -5), VUUpper(VU_MUL, 8, 7, 9)},	// back to loop
+	{VUNopLower, VUUpper(VU_ADD, 2, 2, 0)},
+	{VUNopLower, VUNopUpper | VUEbit},
+	{VUNopLower, VUNopUpper},
+};
+
+// --------------------------------------------------------------------------------------
+//  Host instruction counts
+// --------------------------------------------------------------------------------------
+// Instructions retired by the calling thread in user mode.  Needs hardware counters the
+// kernel lets us at (perf_event_paranoid, and not every VM has them).
+
+class HostInstructionCounter
+{
+	int m_fd;
+
+public:
+	HostInstructionCounter()
+		: m_fd(-1)
+	{
+#if defined(__linux__)
+		perf_event_attr attr = {};
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+	~HostInstructionCounter()
+	{
+#if defined(__linux__)
+		if (m_fd >= 0)
+			close(m_fd);
+#endif
+	}
+
+	bool IsAvailable() const { return m_fd >= 0; }
+
+	void Start()
+	{
+#if defined(__linux__)
+		if (m_fd < 0)
+			return;
+		ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	u64 Stop()
+	{
+		u64 count = 0;
+#if defined(__linux__)
+		if (m_fd < 0)
+			return 0;
+		ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+			count = 0;
+#endif
+		return count;
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  Runs
+// --------------------------------------------------------------------------------------
+struct BenchmarkRun
+{
+	u64 guest;	// guest instructions (VU: instruction pairs)
+	u64 ns;
+	u64 host;	// host instructions, 0 if not counted
+};
+
+class BenchmarkDeadline : public BaseR5900Exception
+{
+	DEFINE_EXCEPTION_COPYTORS(BenchmarkDeadline, BaseR5900Exception)
+
+public:
+	explicit BenchmarkDeadline()
+	{
+		_parent::Init("Core benchmark deadline");
+	}
+};
+
+static u32 s_slice_end;
+static BenchmarkClock::time_point s_deadline;
+
+// Stands in for the whole event test.  The interpreter tests events on every branch, so
+// the clock is only looked at once a slice of cycles is done.
+static void BenchmarkEventTest()
+{
+	if ((s32)(cpuRegs.cycle - s_slice_end) < 0)
+		return;
+
+	s_slice_end = cpuRegs.cycle + SliceCycles;
+	g_nextEventCycle = s_slice_end;
+	if (BenchmarkClock::now() >= s_deadline)
+		Cpu->ThrowCpuException(BenchmarkDeadline());
+}
+
+static BenchmarkRun RunEEProgram(R5900cpu& cpu, const MipsProgramBuilder& program, uint run_ms, HostInstructionCounter& counter)
+{
+	memzero(cpuRegs.GPR);
+	memzero(fpuRegs.fpr);
+	cpuRegs.pc = program.entry;
+	cpuRegs.branch = 0;
+
+	Cpu = &cpu;
+	s_slice_end = cpuRegs.cycle + SliceCycles;
+	g_nextEventCycle = s_slice_end;
+
+	const BenchmarkClock::time_point start = BenchmarkClock::now();
+	s_deadline = start + std::chrono::milliseconds(run_ms);
+	counter.Start();
+	try
+	{
+		cpu.Execute();
+	}
+	catch (BenchmarkDeadline&)
+	{
+	}
+	const u64 host = counter.Stop();
+
+	BenchmarkRun run;
+	run.guest = (u64)cpuRegs.GPR.n.s0.UL[0] * program.iteration_length;
+	run.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+	run.host = host;
+	return run;
+}
+
+// The IOP is run a slice at a time straight through its ExecuteBlock, with its interrupts
+// masked so that the counters it still updates on branches can't take it into the BIOS.
+static BenchmarkRun RunIopProgram(R3000Acpu& cpu, const MipsProgramBuilder& program, uint run_ms, HostInstructionCounter& counter)
+{
+	memzero(psxRegs.GPR);
+	psxRegs.pc = program.entry;
+	psxRegs.CP0.n.Status = 0;
+	psxRegs.interrupt = 0;
+
+	const BenchmarkClock::time_point start = BenchmarkClock::now();
+	const BenchmarkClock::time_point deadline = start + std::chrono::milliseconds(run_ms);
+	counter.Start();
+	do
+		cpu.ExecuteBlock(SliceCycles);
+	while (BenchmarkClock::now() < deadline);
+	const u64 host = counter.Stop();
+
+	BenchmarkRun run;
+	run.guest = (u64)psxRegs.GPR.n.s0 * program.iteration_length;
+	run.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+	run.host = host;
+	return run;
+}
+
+static BenchmarkRun RunVU0Program(BaseVUmicroCPU& vu, uint run_ms, HostInstructionCounter& counter)
+{
+	u64 programs = 0;
+	bool finished = true;
+
+	const BenchmarkClock::time_point start = BenchmarkClock::now();
+	const BenchmarkClock::time_point deadline = start + std::chrono::milliseconds(run_ms);
+	counter.Start();
+	do
+	{
+		VU0.VI[REG_VPU_STAT].UL |= 0x1;
+		VU0.VI[REG_TPC].UL = 0;
+		vu.SetStartPC(0);
+		do
+			vu.Execute(VUSliceCycles);
+		while ((VU0.VI[REG_VPU_STAT].UL & 0x1) && BenchmarkClock::now() < deadline);
+
+		// A run is far shorter than a slice, one still going at the deadline never ends.
+		if (VU0.VI[REG_VPU_STAT].UL & 0x1)
+		{
+			finished = false;
+			break;
+		}
+		programs++;
+	} while (BenchmarkClock::now() < deadline);
+	const u64 host = counter.Stop();
+
+	VU0.VI[REG_VPU_STAT].UL &= ~0x1;
+	if (!finished)
+		log_cb(RETRO_LOG_ERROR, "Core benchmark: VU0 program did not reach its E bit on %s\n", vu.GetShortName());
+
+	BenchmarkRun run;
+	run.guest = finished ? programs * VUProgramLength : 0;
+	run.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+	run.host = host;
+	return run;
+}
+
+static void LogRun(const char* unit, const char* program, const char* provider, const BenchmarkRun& run, bool counted)
+{
+	char host[32] = "n/a";
+	if (counted && run.guest)
+		snprintf(host, sizeof(host), "%.1f", (double)run.host / run.guest);
+
+	log_cb(RETRO_LOG_INFO, "Core benchmark: %-3s %-6s %-11s %9.2f MIPS, %8.2f ns/insn, %s host insn/insn\n",
+		unit, program, provider, run.ns ? run.guest * 1000.0 / run.ns : 0.0, run.guest ? (double)run.ns / run.guest : 0.0, host);
+}
+
+void CoreBenchmark(uint run_ms)
+{
+	static const u32 ProgramBase = 0x00100000; // one 64k block per program
+	static const u32 DataBase = 0x00200000;
+
+	SysCpuProviderPack& providers = GetCpuProviders();
+	HostInstructionCounter counter;
+
+	log_cb(RETRO_LOG_INFO, "Core benchmark: %u ms per program and CPU, host instruction counts %s\n",
+		run_ms, counter.IsAvailable() ? "from perf events" : "unavailable");
+
+	// All programs are in memory before anything is compiled from them.
+	const MipsProgramBuilder programs[] = {
+		BuildAluProgram(ProgramBase),
+		BuildMemoryProgram(ProgramBase + 0x10000, DataBase),
+		BuildBranchProgram(ProgramBase + 0x20000),
+		BuildFpuProgram(ProgramBase + 0x30000),
+	};
+	for (const MipsProgramBuilder& program : programs)
+	{
+		const std::vector<u8> image = BuildElfImage(program);
+		ElfObject elf(L"core benchmark", image.data(), image.size());
+		elf.loadSegments();
+	}
+
+	const struct
+	{
+		const char* name;
+		R5900cpu* cpu;
+	} ee_cpus[] = {
+		{"interpreter", &intCpu},
+		{"recompiler", providers.IsRecAvailable_EE() ? &recCpu : NULL},
+	};
+
+	R5900cpu* const saved_cpu = Cpu;
+	cpuEventTestHook = BenchmarkEventTest;
+	try
+	{
+		for (const auto& ee : ee_cpus)
+		{
+			if (!ee.cpu)
+			{
+				log_cb(RETRO_LOG_WARN, "Core benchmark: EE %s unavailable\n", ee.name);
+				continue;
+			}
+
+			ee.cpu->Reset();
+			for (const MipsProgramBuilder& program : programs)
+			{
+				RunEEProgram(*ee.cpu, program, WarmupMs, counter);
+				LogRun("EE ", program.name, ee.name, RunEEProgram(*ee.cpu, program, run_ms, counter), counter.IsAvailable());
+			}
+		}
+	}
+	catch (...)
+	{
+		cpuEventTestHook = NULL;
+		Cpu = saved_cpu;
+		throw;
+	}
+	cpuEventTestHook = NULL;
+	Cpu = saved_cpu;
+
+	static const u32 IopProgramBase = 0x00100000;
+	static const u32 IopDataBase = 0x00180000;
+
+	const MipsProgramBuilder iop_programs[] = {
+		BuildAluProgram(IopProgramBase, true),
+		BuildIopMemoryProgram(IopProgramBase + 0x10000, IopDataBase),
+		BuildBranchProgram(IopProgramBase + 0x20000),
+	};
+	for (const MipsProgramBuilder& program : iop_programs)
+		memcpy(iopMem->Main + (program.entry & (Ps2MemSize::IopRam - 1)), program.code.data(), program.code.size() * sizeof(u32));
+
+	const struct
+	{
+		const char* name;
+		R3000Acpu* cpu;
+	} iop_cpus[] = {
+		{"interpreter", &psxInt},
+		{"recompiler", providers.IsRecAvailable_IOP() ? &psxRec : NULL},
+	};
+
+	const psxRegisters saved_psx = psxRegs;
+	for (const auto& iop : iop_cpus)
+	{
+		if (!iop.cpu)
+		{
+			log_cb(RETRO_LOG_WARN, "Core benchmark: IOP %s unavailable\n", iop.name);
+			continue;
+		}
+
+		iop.cpu->Reset();
+		for (const MipsProgramBuilder& program : iop_programs)
+		{
+			RunIopProgram(*iop.cpu, program, WarmupMs, counter);
+			LogRun("IOP", program.name, iop.name, RunIopProgram(*iop.cpu, program, run_ms, counter), counter.IsAvailable());
+		}
+	}
+	psxRegs = saved_psx;
+
+	memcpy(VU0.Micro, VU0Program, sizeof(VU0Program));
+
+	const struct
+	{
+		const char* name;
+		BaseVUmicroCPU* vu;
+	} vu_cpus[] = {
+		{"interpreter", providers.GetInterpVU0()},
+		{"microVU", providers.IsRecAvailable_MicroVU0() ? providers.GetMicroVU0() : NULL},
+	};
+
+	for (const auto& vu : vu_cpus)
+	{
+		if (!vu.vu)
+		{
+			log_cb(RETRO_LOG_WARN, "Core benchmark: VU0 %s unavailable\n", vu.name);
+			continue;
+		}
+
+		vu.vu->Reset();
+		RunVU0Program(*vu.vu, WarmupMs, counter);
+		LogRun("VU0", "fmac", vu.name, RunVU0Program(*vu.vu, run_ms, counter), counter.IsAvailable());
+	}
+}
@@ -0,0 +1,31 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// --------------------------------------------------------------------------------------
+//  Core benchmark
+// --------------------------------------------------------------------------------------
+// Built-in EE programs, loaded through ElfObject, run on the EE interpreter and recompiler,
+// MIPS I versions of them run on the IOP interpreter and recompiler, and a VU0 microprogram
+// runs on the VU0 interpreter and microVU.  Each CPU runs alone (no EE event tests, GS or
+// SPU2, the IOP only updates its counters), so the numbers only move with the CPU
+// providers.  Logs guest MIPS, and host instructions per guest instruction where the host
+// counts them (Linux perf events).
+//
+// Runs on the EE thread on a machine that was just reset.  It overwrites EE and IOP memory,
+// VU0 and the recompiler caches, the machine has to be reset again afterwards.
+
+extern void CoreBenchmark(uint run_ms = 500);
@@ -28,6 +28,8 @@
 
 #include "GS.h"
 #include "VUmicro.h"
+#include "SaveStateSnapshot.h"
+#include "FrameTelemetry.h"
 
 #include "ps2/HwInternal.h"
 
@@ -365,6 +367,10 @@ void UpdateVSyncRate()
 		vsyncCounter.CycleT = vSyncInfo.Render;		// Amount of cycles before the counter will be updated
 
 		cpuRcntSet();
+
+		// The frontend runs a frame per vsync.
+		if (ActiveVideoMode)
+			SetFrameTelemetryRate(GetVerticalFrequency().ToFloat());
 	}
 
 	/* TODO/FIXME - MTGS has no frameskip sync logic implemented
@@ -392,6 +398,7 @@ static __fi void VSyncStart(u32 sCycle)
 {
 	GetCoreThread().VsyncInThread();
 	Cpu->CheckExecutionState();
+	cpuEventTestFrame();
 
 	CpuVU0->Vsync();
 	CpuVU1->Vsync();
@@ -512,6 +519,8 @@ __fi void rcntUpdate_vSync()
 	}
 	else	// VSYNC end / VRENDER begin
 	{
+		// Run-ahead snapshots may replace the machine state while the EE waits here.
+		SnapshotVsyncInThread();
 		VSyncStart(vsyncCounter.sCycle);
 
 		vsyncCounter.sCycle += vSyncInfo.Render;
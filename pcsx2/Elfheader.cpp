@@ -52,6 +52,19 @@ ElfObject::ElfObject( const wxString& srcfile, uint hdrsize )
 	initElfHeaders();
 }
 
+ElfObject::ElfObject( const wxString& name, const u8* image, uint size )
+	: data( size, L"ELF image" )
+	, proghead( NULL )
+	, secthead( NULL )
+	, filename( name )
+	, header( *(ELF_HEADER*)data.GetPtr() )
+{
+	isCdvd = false;
+	checkElfSize(data.GetSizeInBytes());
+	memcpy(data.GetPtr(), image, size);
+	initElfHeaders();
+}
+
 void ElfObject::initElfHeaders()
 {
 #ifndef NDEBUG
@@ -304,6 +317,29 @@ void ElfObject::loadHeaders()
 	loadSectionHeaders();
 }
 
+void ElfObject::loadSegments()
+{
+	if (proghead == NULL) return;
+
+	for( int i = 0 ; i < header.e_phnum ; i++ )
+	{
+		const ELF_PHR& segment = proghead[i];
+		if (segment.p_type != 0x1) continue;
+
+		const u32 addr = segment.p_vaddr & 0x1fffffff;
+		if (segment.p_filesz > segment.p_memsz || (u64)segment.p_offset + segment.p_filesz > (u64)data.GetSizeInBytes() ||
+			(u64)addr + segment.p_memsz > Ps2MemSize::MainRam)
+		{
+			throw Exception::BadStream(filename)
+				.SetDiagMsg(L"ELF segment does not fit in EE main memory.")
+				.SetUserMsg(GetMsg_InvalidELF());
+		}
+
+		memcpy(&eeMem->Main[addr], data.GetPtr(segment.p_offset), segment.p_filesz);
+		memset(&eeMem->Main[addr + segment.p_filesz], 0, segment.p_memsz - segment.p_filesz);
+	}
+}
+
 // return value:
 //   0 - Invalid or unknown disc.
 //   1 - PS1 CD
@@ -314,7 +350,7 @@ int GetPS2ElfName( wxString& name )
 
 	try {
 		IsoFSCDVD isofs;
-		IsoFile file( isofs, L"SYSTEM.CNF;1");
+		IsoFile file( isofs, isofs.FindFile(L"SYSTEM.CNF;1"));
 
 		int size = file.getLength();
 		if( size == 0 ) return 0;
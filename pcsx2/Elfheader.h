@@ -146,11 +146,16 @@ class ElfObject
 
 		ElfObject(const wxString& srcfile, IsoFile& isofile);
 		ElfObject( const wxString& srcfile, uint hdrsize );
+		ElfObject( const wxString& name, const u8* image, uint size );
 
 		void loadProgramHeaders();
 		void loadSectionHeaders();
 		void loadHeaders();
 
+		// Copies the loadable segments into EE memory.  The BIOS does this for games; this
+		// is for programs that run without one (CoreBenchmark).
+		void loadSegments();
+
 		bool hasProgramHeaders();
 		bool hasSectionHeaders();
 		bool hasHeaders();
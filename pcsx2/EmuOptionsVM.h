@@ -38,6 +38,7 @@ namespace PCSX2_vm
 	bool EnableVU1					= true;
 	bool UseMicroVU0				= true;
 	bool UseMicroVU1				= true;
+	bool EnableFastmem				= false;
 
 	bool vuOverflow					= true;
 	bool vuExtraOverflow			= false;
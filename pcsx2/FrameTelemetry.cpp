@@ -0,0 +1,199 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "FrameTelemetry.h"
+
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+std::atomic<bool> FrameTelemetryEnabled(false);
+std::atomic<u64> FrameTelemetryCounters[FrameTimer_Count];
+thread_local uint ScopedFrameTimer::s_depth[FrameTimer_Count];
+
+static const char* const FrameTimerNames[FrameTimer_Count] = {"EE", "GS", "MTGS wait", "MTVU", "SPU2", "CDVD", "JIT"};
+static const uint SummaryFrames = 600;
+
+static FrameTelemetryMode s_mode = FrameTelemetryMode::Disabled;
+static std::atomic<u32> s_budget_us(1000000 * 1001 / 60000); // NTSC until the game sets a mode
+
+// Single writer (FrameTelemetryEndFrame), each slot holds the number of the frame in it so
+// readers can tell when a slot was reused under them.
+static FrameTelemetryRecord s_ring[FrameTelemetryRingSize];
+static std::atomic<u64> s_written(0);
+
+static u64 s_last_end = 0;
+static u64 s_summary_us[FrameTimer_Count];
+static u64 s_summary_frame_us = 0;
+static uint s_summary_count = 0;
+static FrameTelemetryRecord s_summary_worst;
+
+// --------------------------------------------------------------------------------------
+//  EE thread CPU time
+// --------------------------------------------------------------------------------------
+// The EE never stops to wait for a frame boundary, so instead of a scope its timer is the
+// CPU time its thread used, which leaves out time it was descheduled or stalled on MTGS.
+
+static std::atomic<bool> s_ee_clock_valid(false);
+static u64 s_ee_last_ns = 0;
+#if defined(__linux__)
+static clockid_t s_ee_clock;
+#endif
+
+void FrameTelemetryRegisterEEThread()
+{
+#if defined(__linux__)
+	s_ee_clock_valid.store(false, std::memory_order_relaxed);
+	if (pthread_getcpuclockid(pthread_self(), &s_ee_clock) == 0)
+		s_ee_clock_valid.store(true, std::memory_order_release);
+#endif
+}
+
+static u64 ReadEECpuTime()
+{
+#if defined(__linux__)
+	timespec ts;
+	if (s_ee_clock_valid.load(std::memory_order_acquire) && clock_gettime(s_ee_clock, &ts) == 0)
+		return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+	return 0;
+}
+
+// --------------------------------------------------------------------------------------
+//  Frame records
+// --------------------------------------------------------------------------------------
+static void LogFrameRecord(const char* prefix, const FrameTelemetryRecord& record)
+{
+	char line[256];
+	int len = snprintf(line, sizeof(line), "%s #%llu %.2f ms:", prefix, (unsigned long long)record.frame, record.frame_us / 1000.0);
+	for (int i = 0; i < FrameTimer_Count && len < (int)sizeof(line); i++)
+		len += snprintf(line + len, sizeof(line) - len, "%s %s %.2f", i ? "," : "", FrameTimerNames[i], record.timer_us[i] / 1000.0);
+	log_cb(RETRO_LOG_INFO, "%s\n", line);
+}
+
+void SetFrameTelemetryRate(double fps)
+{
+	if (fps > 0)
+		s_budget_us.store((u32)(1000000.0 / fps), std::memory_order_relaxed);
+}
+
+void SetFrameTelemetryMode(FrameTelemetryMode mode)
+{
+	if (mode == s_mode)
+		return;
+
+	if (mode != FrameTelemetryMode::Disabled && s_mode == FrameTelemetryMode::Disabled)
+	{
+		for (std::atomic<u64>& counter : FrameTelemetryCounters)
+			counter.store(0, std::memory_order_relaxed);
+		s_last_end = 0;
+		s_ee_last_ns = ReadEECpuTime();
+		s_summary_count = 0;
+	}
+
+	s_mode = mode;
+	FrameTelemetryEnabled.store(mode != FrameTelemetryMode::Disabled, std::memory_order_relaxed);
+	log_cb(RETRO_LOG_INFO, "Frame telemetry: %s\n",
+		mode == FrameTelemetryMode::Disabled ? "disabled" : mode == FrameTelemetryMode::Summary ? "summary every 600 frames" : "summary and stutters");
+}
+
+void FrameTelemetryEndFrame()
+{
+	if (!FrameTelemetryEnabled.load(std::memory_order_relaxed))
+		return;
+
+	const u64 now = FrameTelemetryClock();
+	u64 ns[FrameTimer_Count];
+	for (int i = 0; i < FrameTimer_Count; i++)
+		ns[i] = FrameTelemetryCounters[i].exchange(0, std::memory_order_relaxed);
+
+	const u64 ee_ns = ReadEECpuTime();
+	ns[FrameTimer_EE] = ee_ns > s_ee_last_ns ? ee_ns - s_ee_last_ns : 0;
+	s_ee_last_ns = ee_ns;
+
+	// The GS timer spans the whole MTGS run, waits included.
+	ns[FrameTimer_GS] -= std::min(ns[FrameTimer_GS], ns[FrameTimer_MTGSWait]);
+
+	const u64 index = s_written.load(std::memory_order_relaxed);
+	FrameTelemetryRecord& record = s_ring[index % FrameTelemetryRingSize];
+	record.frame = index;
+	record.frame_us = s_last_end ? (u32)((now - s_last_end) / 1000) : 0;
+	for (int i = 0; i < FrameTimer_Count; i++)
+		record.timer_us[i] = (u32)(ns[i] / 1000);
+	s_written.store(index + 1, std::memory_order_release);
+	s_last_end = now;
+
+	if (!record.frame_us)
+		return;
+
+	if (s_mode == FrameTelemetryMode::Stutters && record.frame_us > s_budget_us.load(std::memory_order_relaxed) * 3 / 2)
+		LogFrameRecord("(Frame) Stutter", record);
+
+	if (s_summary_count == 0 || record.frame_us > s_summary_worst.frame_us)
+		s_summary_worst = record;
+	if (s_summary_count == 0)
+	{
+		memzero(s_summary_us);
+		s_summary_frame_us = 0;
+	}
+	for (int i = 0; i < FrameTimer_Count; i++)
+		s_summary_us[i] += record.timer_us[i];
+	s_summary_frame_us += record.frame_us;
+
+	if (++s_summary_count == SummaryFrames)
+	{
+		FrameTelemetryRecord average = {};
+		average.frame = index;
+		average.frame_us = (u32)(s_summary_frame_us / SummaryFrames);
+		for (int i = 0; i < FrameTimer_Count; i++)
+			average.timer_us[i] = (u32)(s_summary_us[i] / SummaryFrames);
+
+		LogFrameRecord("(Frame) Average of 600 until", average);
+		LogFrameRecord("(Frame) Worst", s_summary_worst);
+		s_summary_count = 0;
+	}
+}
+
+uint GetFrameTelemetry(FrameTelemetryRecord* dest, uint count)
+{
+	const u64 written = s_written.load(std::memory_order_acquire);
+	const u64 available = std::min<u64>(written, FrameTelemetryRingSize - 1);
+	const u64 first = written - std::min<u64>(count, available);
+
+	uint copied = 0;
+	for (u64 frame = first; frame < written; frame++)
+	{
+		dest[copied] = s_ring[frame % FrameTelemetryRingSize];
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// Keep the copy only if the writer did not get around to this slot meanwhile.
+		if (dest[copied].frame == frame && s_written.load(std::memory_order_relaxed) - frame < FrameTelemetryRingSize)
+			copied++;
+	}
+	return copied;
+}
+
+void DumpFrameTelemetry(uint count)
+{
+	std::vector<FrameTelemetryRecord> records(std::min(count, FrameTelemetryRingSize));
+	records.resize(GetFrameTelemetry(records.data(), records.size()));
+
+	log_cb(RETRO_LOG_INFO, "(Frame) Last %zu frames, times in ms:\n", records.size());
+	for (const FrameTelemetryRecord& record : records)
+		LogFrameRecord("(Frame)", record);
+}
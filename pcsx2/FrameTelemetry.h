@@ -0,0 +1,110 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// --------------------------------------------------------------------------------------
+//  Frame telemetry
+// --------------------------------------------------------------------------------------
+// Per-frame breakdown of where time went, for triaging stutter.  Timers add to counters
+// shared by all threads; the frontend closes a frame once per retro_run and the counters
+// become one FrameTelemetryRecord in a ring of the last FrameTelemetryRingSize frames.
+// Everything is a single branch on FrameTelemetryEnabled while telemetry is off.
+
+enum FrameTimer
+{
+	FrameTimer_EE = 0,   // CPU time of the EE thread (recompiled EE/IOP code, SPU2, CDVD...)
+	FrameTimer_GS,       // MTGS busy time: the GS plugin drawing and presenting
+	FrameTimer_MTGSWait, // MTGS waiting on the EE for ring buffer data
+	FrameTimer_MTVU,     // MTVU executing VU1 programs
+	FrameTimer_SPU2,     // SPU2 mixing (on the EE thread, also counted in EE)
+	FrameTimer_CDVD,     // CDVD reads (on the EE thread, also counted in EE)
+	FrameTimer_JIT,      // EE, IOP and microVU recompilation, on any thread
+
+	FrameTimer_Count
+};
+
+enum class FrameTelemetryMode
+{
+	Disabled = 0,
+	Summary,  // a summary every 600 frames
+	Stutters, // the summary, and every frame over 1.5x the frame budget
+};
+
+struct FrameTelemetryRecord
+{
+	u64 frame;
+	u32 frame_us; // since the previous frame was closed
+	u32 timer_us[FrameTimer_Count];
+};
+
+static const uint FrameTelemetryRingSize = 1024;
+
+extern std::atomic<bool> FrameTelemetryEnabled;
+extern std::atomic<u64> FrameTelemetryCounters[FrameTimer_Count];
+
+static __fi u64 FrameTelemetryClock()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Times the enclosing scope.  Nested timers of the same kind on one thread (a recompile
+// that compiles a branch target) only count once.
+class ScopedFrameTimer
+{
+	FrameTimer m_timer;
+	bool m_counted;
+	u64 m_start;
+
+	static thread_local uint s_depth[FrameTimer_Count];
+
+public:
+	__fi ScopedFrameTimer(FrameTimer timer, bool active = true)
+		: m_timer(timer)
+		, m_counted(active && FrameTelemetryEnabled.load(std::memory_order_relaxed))
+		, m_start(0)
+	{
+		if (m_counted && s_depth[timer]++ == 0)
+			m_start = FrameTelemetryClock();
+	}
+
+	__fi ~ScopedFrameTimer()
+	{
+		if (m_counted && --s_depth[m_timer] == 0)
+			FrameTelemetryCounters[m_timer].fetch_add(FrameTelemetryClock() - m_start, std::memory_order_relaxed);
+	}
+};
+
+extern void SetFrameTelemetryMode(FrameTelemetryMode mode);
+
+// Sets the frame budget stutters are judged against, from the vsync rate of the video mode
+// the game picked.  Called by the EE thread when the mode changes.
+extern void SetFrameTelemetryRate(double fps);
+
+// Called by the EE thread when it starts running, the EE timer reads its CPU time clock.
+extern void FrameTelemetryRegisterEEThread();
+
+// Closes the current frame.  Only ever called from one thread.
+extern void FrameTelemetryEndFrame();
+
+// Copies up to count of the most recent records, oldest first, and returns how many were
+// copied.  Safe from any thread; records overwritten while being copied are left out.
+extern uint GetFrameTelemetry(FrameTelemetryRecord* dest, uint count);
+
+// Logs the most recent records, one line per frame.
+extern void DumpFrameTelemetry(uint count);
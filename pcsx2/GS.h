@@ -354,6 +354,8 @@ public:
 	uint			m_packet_size;		// size of the packet (data only, ie. not including the 16 byte command!)
 	uint			m_packet_writepos;	// index of the data location in the ringbuffer.
 
+	bool			m_DrainOnly;		// ExecuteTaskInThread stops at the next vsync or an empty ring
+
 #ifdef RINGBUF_DEBUG_STACK
 	Threading::Mutex m_lock_Stack;
 #endif
@@ -384,6 +386,11 @@ public:
 	bool IsOpened() const { return m_Opened; }
 
 	void ExecuteTaskInThread();
+#ifdef __LIBRETRO__
+	// Processes the ring up to, but not including, the next vsync without waiting for more
+	// data, so the GS catches up with a stopped EE without presenting a frame.
+	void DrainInThread();
+#endif
 	void FinishTaskInThread();
 	void OpenGS();
 	void CloseGS();
@@ -20,6 +20,7 @@
 #include "yaml-cpp/yaml.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 
 std::string strToLower(std::string str)
 {
@@ -185,14 +186,72 @@ GameDatabaseSchema::GameEntry YamlGameDatabaseImpl::entryFromYaml(const std::str
 	return gameEntry;
 }
 
+// Case-insensitive ordering of serials, without needing lower-cased copies of the index keys.
+static int compareIndexKey(const char* key, size_t keyLength, const char* serial, size_t serialLength)
+{
+	const size_t len = std::min(keyLength, serialLength);
+	for (size_t i = 0; i < len; i++)
+	{
+		const int a = std::tolower(static_cast<unsigned char>(key[i]));
+		const int b = std::tolower(static_cast<unsigned char>(serial[i]));
+		if (a != b)
+			return a - b;
+	}
+	return (keyLength < serialLength) ? -1 : (keyLength > serialLength) ? 1 : 0;
+}
+
+const YamlGameDatabaseImpl::IndexEntry* YamlGameDatabaseImpl::findIndexEntry(const std::string& serialLower) const
+{
+	auto it = std::lower_bound(index.begin(), index.end(), serialLower,
+		[this](const IndexEntry& entry, const std::string& serial) {
+			return compareIndexKey(indexData + entry.offset, entry.keyLength, serial.data(), serial.size()) < 0;
+		});
+	if (it == index.end() || compareIndexKey(indexData + it->offset, it->keyLength, serialLower.data(), serialLower.size()) != 0)
+		return nullptr;
+	return &*it;
+}
+
+bool YamlGameDatabaseImpl::entryFromIndex(const IndexEntry& entry, const std::string& serialLower, GameDatabaseSchema::GameEntry& gameEntry)
+{
+	try
+	{
+		YAML::Node data = YAML::Load(std::string(indexData + entry.offset, entry.size));
+		const auto it = data.begin();
+		if (it == data.end())
+			return false;
+		gameEntry = entryFromYaml(serialLower, it->second);
+		return true;
+	} catch (const std::exception& e)
+	{
+		log_cb(RETRO_LOG_ERROR, "[GameDB] Invalid GameDB syntax detected on serial: '{%s}'. Error Details - {%s}\n", serialLower.c_str(), e.what());
+	}
+	return false;
+}
+
 GameDatabaseSchema::GameEntry YamlGameDatabaseImpl::findGame(const std::string serial)
 {
 	std::string serialLower = strToLower(serial);
 	log_cb(RETRO_LOG_INFO, "[GameDB] Searching for '{%s}' in GameDB\n", serialLower.c_str());
-	if (gameDb.count(serialLower) == 1)
+
+	std::lock_guard<std::mutex> lock(gameDbMutex);
+	auto cached = gameDb.find(serialLower);
+	if (cached != gameDb.end())
 	{
 		log_cb(RETRO_LOG_INFO, "[GameDB] Found '{%s}' in GameDB\n", serialLower.c_str());
-		return gameDb[serialLower];
+		return cached->second;
+	}
+
+	if (indexData)
+	{
+		if (const IndexEntry* entry = findIndexEntry(serialLower))
+		{
+			GameDatabaseSchema::GameEntry gameEntry;
+			if (entryFromIndex(*entry, serialLower, gameEntry))
+			{
+				log_cb(RETRO_LOG_INFO, "[GameDB] Found '{%s}' in GameDB\n", serialLower.c_str());
+				return gameDb.emplace(serialLower, std::move(gameEntry)).first->second;
+			}
+		}
 	}
 
 	log_cb(RETRO_LOG_ERROR, "[GameDB] Could not find '{%s}' in GameDB\n", serialLower.c_str());
@@ -203,11 +262,73 @@ GameDatabaseSchema::GameEntry YamlGameDatabaseImpl::findGame(const std::string s
 
 int YamlGameDatabaseImpl::numGames()
 {
+	if (indexData)
+		return index.size();
 	return gameDb.size();
 }
 
+bool YamlGameDatabaseImpl::initDatabase(const char* data, size_t size)
+{
+	if (!data || !size)
+	{
+		log_cb(RETRO_LOG_ERROR, "[GameDB] Unable to open GameDB file.\n");
+		return false;
+	}
+
+	// Every entry of the GameIndex is a top-level mapping key, so it starts at column zero;
+	// everything else is either indented, a comment or a document marker. Recording where
+	// each key starts is enough to hand yaml-cpp exactly one entry later on.
+	index.clear();
+	const char* const end = data + size;
+	for (const char* line = data; line < end;)
+	{
+		const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+		if (!eol)
+			eol = end;
+
+		const char c = *line;
+		if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '#' && c != '-')
+		{
+			if (const char* colon = static_cast<const char*>(std::memchr(line, ':', eol - line)))
+			{
+				const char* keyEnd = colon;
+				while (keyEnd > line && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t'))
+					keyEnd--;
+				if (!index.empty())
+					index.back().size = static_cast<u32>(line - data) - index.back().offset;
+				index.push_back({static_cast<u32>(line - data), 0, static_cast<u32>(keyEnd - line)});
+			}
+		}
+		line = eol + 1;
+	}
+	if (!index.empty())
+		index.back().size = static_cast<u32>(size) - index.back().offset;
+
+	// Stable, so the first of several case-insensitively equal serials is the one found.
+	std::stable_sort(index.begin(), index.end(), [data](const IndexEntry& a, const IndexEntry& b) {
+		return compareIndexKey(data + a.offset, a.keyLength, data + b.offset, b.keyLength) < 0;
+	});
+	for (size_t i = 1; i < index.size(); i++)
+	{
+		const IndexEntry& prev = index[i - 1];
+		const IndexEntry& cur = index[i];
+		if (compareIndexKey(data + prev.offset, prev.keyLength, data + cur.offset, cur.keyLength) == 0)
+		{
+			std::string serial = strToLower(std::string(data + cur.offset, cur.keyLength));
+			log_cb(RETRO_LOG_ERROR, "[GameDB] Duplicate serial '{%s}' found in GameDB. Skipping, Serials are case-insensitive!\n", serial.c_str());
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(gameDbMutex);
+	gameDb.clear();
+	indexData = data;
+	return true;
+}
+
 bool YamlGameDatabaseImpl::initDatabase(std::istream& stream)
 {
+	indexData = nullptr;
+	index.clear();
 	try
 	{
 		if (!stream)
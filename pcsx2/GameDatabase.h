@@ -17,6 +17,7 @@
 
 #include "yaml-cpp/yaml.h"
 
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -95,11 +96,29 @@ class YamlGameDatabaseImpl : public IGameDatabase
 {
 public:
 	bool initDatabase(std::istream& stream) override;
+	// Indexes the top-level serials of an in-memory GameIndex without parsing it. Entries are
+	// only handed to yaml-cpp when findGame() asks for them. The buffer must outlive the database.
+	bool initDatabase(const char* data, size_t size);
 	GameDatabaseSchema::GameEntry findGame(const std::string serial) override;
 	int numGames() override;
 
 private:
+	struct IndexEntry
+	{
+		u32 offset; // start of the "SERIAL:" line
+		u32 size;   // up to the next top-level key
+		u32 keyLength;
+	};
+
+	// Parsed entries; a lookup cache when an index is present, the whole database otherwise.
 	std::unordered_map<std::string, GameDatabaseSchema::GameEntry> gameDb;
+	std::mutex gameDbMutex;
+
+	const char* indexData = nullptr;
+	std::vector<IndexEntry> index; // sorted case-insensitively by serial
+
+	const IndexEntry* findIndexEntry(const std::string& serialLower) const;
+	bool entryFromIndex(const IndexEntry& entry, const std::string& serialLower, GameDatabaseSchema::GameEntry& gameEntry);
 	GameDatabaseSchema::GameEntry entryFromYaml(const std::string serial, const YAML::Node& node);
 
 	std::vector<std::string> convertMultiLineStringToVector(const std::string multiLineString);
@@ -22,9 +22,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-// [TODO] : There are modern SSE versions of idct (idct_mmx.c) in the mpeg2 libs that we
-// should probably upgrade to.  They use their own raw-style intrinsics and not the intel
-// compiler-integrated ones.
+// The SSE2/AVX2 IDCT below computes the same integer butterflies as idct_row/idct_col, 8 rows
+// or columns at a time, so it is bit-exact with them.  The C version is kept as the reference
+// and can be selected with mpeg2_idct_simd.
 
 #include "PrecompiledHeader.h"
 
@@ -155,10 +155,239 @@ static __fi void idct_col (s16 * const block)
     block[8*7] = (a0 - b0) >> 17;
 }
 
+// Disabled by IPUBenchmark to time the C IDCT.
+bool mpeg2_idct_simd = true;
+
+// 4 (SSE2) or 8 (AVX2) rows or columns of the IDCT, with 32 bit intermediates.  The inputs are
+// interleaved 16 bit coefficient pairs so that each BUTTERFLY is a single pmaddwd: since
+// tmp + (w1 - w0) * d1 == w0 * d0 + w1 * d1 there is nothing to round differently.
+struct IdctLanes4
+{
+	static const int Halves = 2;
+
+	__m128i v;
+
+	IdctLanes4() {}
+
+	IdctLanes4(__m128i src)
+		: v(src)
+	{
+	}
+
+	IdctLanes4(s32 src)
+		: v(_mm_set1_epi32(src))
+	{
+	}
+
+	// Pairs up the coefficients a and b of lanes 0-3 (half 0) or 4-7 (half 1).
+	static IdctLanes4 Pair(__m128i a, __m128i b, int half)
+	{
+		return half ? _mm_unpackhi_epi16(a, b) : _mm_unpacklo_epi16(a, b);
+	}
+
+	// w0 * a + w1 * b of a pair.
+	IdctLanes4 Madd(int w0, int w1) const
+	{
+		return _mm_madd_epi16(v, _mm_set1_epi32((u16)w0 | ((u32)(u16)w1 << 16)));
+	}
+
+	IdctLanes4 Mul181() const
+	{
+#if defined(__SSE4_1__)
+		return _mm_mullo_epi32(v, _mm_set1_epi32(181));
+#else
+		// 181 = 128 + 32 + 16 + 4 + 1
+		return _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(v, 7), _mm_slli_epi32(v, 5)),
+			_mm_add_epi32(_mm_slli_epi32(v, 4), _mm_slli_epi32(v, 2))), v);
+#endif
+	}
+
+	friend IdctLanes4 operator+(const IdctLanes4& a, const IdctLanes4& b) { return _mm_add_epi32(a.v, b.v); }
+	friend IdctLanes4 operator-(const IdctLanes4& a, const IdctLanes4& b) { return _mm_sub_epi32(a.v, b.v); }
+	friend IdctLanes4 operator>>(const IdctLanes4& a, int count) { return _mm_srai_epi32(a.v, count); }
+
+	// Truncates the results to 16 bits, as storing them to the s16 block does.
+	static __m128i Pack(const IdctLanes4 (&halves)[2])
+	{
+		return _mm_packs_epi32(
+			_mm_srai_epi32(_mm_slli_epi32(halves[0].v, 16), 16),
+			_mm_srai_epi32(_mm_slli_epi32(halves[1].v, 16), 16));
+	}
+};
+
+#if defined(__AVX2__)
+// All 8 rows or columns at once, see IdctLanes4.
+struct IdctLanes8
+{
+	static const int Halves = 1;
+
+	__m256i v;
+
+	IdctLanes8() {}
+
+	IdctLanes8(__m256i src)
+		: v(src)
+	{
+	}
+
+	IdctLanes8(s32 src)
+		: v(_mm256_set1_epi32(src))
+	{
+	}
+
+	static IdctLanes8 Pair(__m128i a, __m128i b, int half)
+	{
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(a, b)), _mm_unpackhi_epi16(a, b), 1);
+	}
+
+	IdctLanes8 Madd(int w0, int w1) const
+	{
+		return _mm256_madd_epi16(v, _mm256_set1_epi32((u16)w0 | ((u32)(u16)w1 << 16)));
+	}
+
+	IdctLanes8 Mul181() const { return _mm256_mullo_epi32(v, _mm256_set1_epi32(181)); }
+
+	friend IdctLanes8 operator+(const IdctLanes8& a, const IdctLanes8& b) { return _mm256_add_epi32(a.v, b.v); }
+	friend IdctLanes8 operator-(const IdctLanes8& a, const IdctLanes8& b) { return _mm256_sub_epi32(a.v, b.v); }
+	friend IdctLanes8 operator>>(const IdctLanes8& a, int count) { return _mm256_srai_epi32(a.v, count); }
+
+	static __m128i Pack(const IdctLanes8 (&halves)[1])
+	{
+		const __m256i v = _mm256_srai_epi32(_mm256_slli_epi32(halves[0].v, 16), 16);
+		return _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	}
+};
+
+typedef IdctLanes8 IdctLanes;
+#else
+typedef IdctLanes4 IdctLanes;
+#endif
+
+static __fi void transpose_8x8(__m128i (&v)[8])
+{
+	const __m128i a0 = _mm_unpacklo_epi16(v[0], v[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(v[0], v[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(v[2], v[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(v[2], v[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(v[4], v[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(v[4], v[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(v[6], v[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(v[6], v[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	v[0] = _mm_unpacklo_epi64(b0, b4);
+	v[1] = _mm_unpackhi_epi64(b0, b4);
+	v[2] = _mm_unpacklo_epi64(b1, b5);
+	v[3] = _mm_unpackhi_epi64(b1, b5);
+	v[4] = _mm_unpacklo_epi64(b2, b6);
+	v[5] = _mm_unpackhi_epi64(b2, b6);
+	v[6] = _mm_unpacklo_epi64(b3, b7);
+	v[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+// idct_row (Column = false) or idct_col (Column = true) of 8 rows/columns, v[i] holding their
+// coefficient i.
+template <typename L, bool Column>
+static __fi void idct_pass(__m128i (&v)[8])
+{
+	L res[8][L::Halves];
+
+	for (int h = 0; h < L::Halves; h++)
+	{
+		const L d02 = L::Pair(v[0], v[2], h);
+		const L d31 = L::Pair(v[3], v[1], h);
+		const L d74 = L::Pair(v[7], v[4], h);
+		const L d56 = L::Pair(v[5], v[6], h);
+		const L round(Column ? 65536 : 128);
+
+		const L t0 = d02.Madd(2048, 2048) + round;
+		const L t1 = d02.Madd(2048, -2048) + round;
+		const L t2 = d31.Madd(W6, W2);
+		const L t3 = d31.Madd(-W2, W6);
+		const L a0 = t0 + t2;
+		const L a1 = t1 + t3;
+		const L a2 = t1 - t3;
+		const L a3 = t0 - t2;
+
+		const L u0 = d74.Madd(W7, W1);
+		const L u1 = d74.Madd(-W1, W7);
+		const L u2 = d56.Madd(W3, W5);
+		const L u3 = d56.Madd(-W5, W3);
+		const L b0 = u0 + u2;
+		const L b3 = u1 + u3;
+
+		L b1, b2;
+		if (Column)
+		{
+			const L s0 = (u0 - u2) >> 8;
+			const L s1 = (u1 - u3) >> 8;
+			b1 = (s0 + s1).Mul181();
+			b2 = (s0 - s1).Mul181();
+		}
+		else
+		{
+			const L s0 = u0 - u2;
+			const L s1 = u1 - u3;
+			b1 = (s0 + s1).Mul181() >> 8;
+			b2 = (s0 - s1).Mul181() >> 8;
+		}
+
+		const int shift = Column ? 17 : 8;
+		res[0][h] = (a0 + b0) >> shift;
+		res[1][h] = (a1 + b1) >> shift;
+		res[2][h] = (a2 + b2) >> shift;
+		res[3][h] = (a3 + b3) >> shift;
+		res[4][h] = (a3 - b3) >> shift;
+		res[5][h] = (a2 - b2) >> shift;
+		res[6][h] = (a1 - b1) >> shift;
+		res[7][h] = (a0 - b0) >> shift;
+	}
+
+	for (int i = 0; i < 8; i++)
+		v[i] = L::Pack(res[i]);
+}
+
+// Leaves the 8 rows of the result in v, block is not modified.
+static __fi void idct_simd(const s16* block, __m128i (&v)[8])
+{
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm_load_si128((const __m128i*)(block + 8 * i));
+
+	// The rows are transformed with their coefficients transposed into lanes, then transposed
+	// back so that the columns are in lanes.
+	transpose_8x8(v);
+	idct_pass<IdctLanes, false>(v);
+	transpose_8x8(v);
+	idct_pass<IdctLanes, true>(v);
+}
+
 __ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
 {
     int i;
 
+	if (mpeg2_idct_simd)
+	{
+		__m128i v[8];
+		idct_simd(block, v);
+
+		// Saturating to 8 bits matches CLIP over the range of IDCT outputs it covers.
+		const __m128i zero = _mm_setzero_si128();
+		for (i = 0; i < 8; i++)
+		{
+			_mm_storel_epi64((__m128i*)(dest + stride * i), _mm_packus_epi16(v[i], v[i]));
+			_mm_store_si128((__m128i*)(block + 8 * i), zero);
+		}
+		return;
+	}
+
     for (i = 0; i < 8; i++)
 		idct_row (block + 8 * i);
     for (i = 0; i < 8; i++)
@@ -191,6 +420,21 @@ __ri void mpeg2_idct_add (const int last, s16 * block, s16 * dest, const int str
     if (last != 129 || (block[0] & 7) == 4)
     {
 		int i;
+
+		if (mpeg2_idct_simd)
+		{
+			__m128i v[8];
+			idct_simd(block, v);
+
+			const __m128i zero = _mm_setzero_si128();
+			for (i = 0; i < 8; i++)
+			{
+				_mm_store_si128((__m128i*)(dest + stride * i), v[i]);
+				_mm_store_si128((__m128i*)(block + 8 * i), zero);
+			}
+			return;
+		}
+
 		for (i = 0; i < 8; i++)
 			idct_row (block + 8 * i);
 		for (i = 0; i < 8; i++)
@@ -52,6 +52,75 @@ const int non_linear_quantizer_scale [] =
 const DCTtab * tab;
 int mbaCount = 0;
 
+// The DCT coefficient tables of Vlc.h are split by code length.  Looks up the entry of a 16 bit
+// code in them, for Table B-15 (intra blocks with intra_vlc_format) or B-14 (first coefficient
+// of non-intra blocks, or any other), or returns NULL for an invalid code.
+static const DCTtab* DCT_lookup(u16 code, bool first, bool b15)
+{
+	if (code >= 16384 && !b15)
+		return first ? &DCT.first[(code >> 12) - 4] : &DCT.next[(code >> 12) - 4];
+	else if (code >= 1024)
+		return b15 ? &DCT.tab0a[(code >> 8) - 4] : &DCT.tab0[(code >> 8) - 4];
+	else if (code >= 512)
+		return b15 ? &DCT.tab1a[(code >> 6) - 8] : &DCT.tab1[(code >> 6) - 8];
+	else if (code >= 256)
+		return &DCT.tab2[(code >> 4) - 16];
+	else if (code >= 128)
+		return &DCT.tab3[(code >> 3) - 16];
+	else if (code >= 64)
+		return &DCT.tab4[(code >> 2) - 16];
+	else if (code >= 32)
+		return &DCT.tab5[(code >> 1) - 16];
+	else if (code >= 16)
+		return &DCT.tab6[code - 16];
+
+	return NULL;
+}
+
+// The same tables unrolled so that a code takes a single lookup: codes of up to 10 bits (the
+// ones starting with a 1 in their first 7 bits) by their top 10 bits, longer ones by the whole
+// code, which then fits in 9 bits.
+struct DCTlutSet
+{
+	DCTtab first[1024];
+	DCTtab next[1024];
+	DCTtab next_b15[1024];
+	DCTtab tail[512];
+
+	DCTlutSet()
+		: first()
+		, next()
+		, next_b15()
+	{
+		// Entries below 8 are the codes that go to tail.
+		for (int i = 8; i < 1024; i++)
+		{
+			first[i] = *DCT_lookup(i << 6, true, false);
+			next[i] = *DCT_lookup(i << 6, false, false);
+			next_b15[i] = *DCT_lookup(i << 6, false, true);
+		}
+
+		for (int i = 0; i < 512; i++)
+		{
+			const DCTtab* entry = DCT_lookup(i, false, false);
+			tail[i] = entry ? *entry : DCTtab{0, 0, 0};
+		}
+	}
+
+	// NULL for an invalid code, which is all that is left below 16.
+	__fi const DCTtab* get(const DCTtab* table, u16 code) const
+	{
+		if (code >= 512)
+			return &table[code >> 6];
+		else if (code >= 16)
+			return &tail[code];
+
+		return NULL;
+	}
+};
+
+static const DCTlutSet DCTlut;
+
 int bitstream_init ()
 {
 	return g_BP.FillBuffer(32);
@@ -349,6 +418,7 @@ static bool get_intra_block()
 	const u8 (&quant_matrix)[64] = decoder.iq;
 	int quantizer_scale = decoder.quantizer_scale;
 	s16 * dest = decoder.DCTblock;
+	const DCTtab * vlc = (decoder.intra_vlc_format && !decoder.mpeg1) ? DCTlut.next_b15 : DCTlut.next;
 	u16 code; 
 
 	/* decode AC coefficients */
@@ -364,60 +434,9 @@ static bool get_intra_block()
 		}
 
 		code = UBITS(16);
+		tab = DCTlut.get(vlc, code);
 
-		if (code >= 16384 && (!decoder.intra_vlc_format || decoder.mpeg1))
-		{
-		  tab = &DCT.next[(code >> 12) - 4];
-		}
-		else if (code >= 1024)
-		{
-			if (decoder.intra_vlc_format && !decoder.mpeg1)
-			{
-				tab = &DCT.tab0a[(code >> 8) - 4];
-			}
-			else
-			{
-				tab = &DCT.tab0[(code >> 8) - 4];
-			}
-		}
-		else if (code >= 512)
-		{
-			if (decoder.intra_vlc_format && !decoder.mpeg1)
-			{
-				tab = &DCT.tab1a[(code >> 6) - 8];
-			}
-			else
-			{
-				tab = &DCT.tab1[(code >> 6) - 8];
-			}
-		}
-
-		// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-		// that should use a single unrolled DCT table instead of five separate tables used
-		// here.  Multiple conditional statements are very slow, while modern CPU data caches
-		// have lots of room to spare.
-
-		else if (code >= 256)
-		{
-			tab = &DCT.tab2[(code >> 4) - 16];
-		}
-		else if (code >= 128)
-		{
-			tab = &DCT.tab3[(code >> 3) - 16];
-		}
-		else if (code >= 64)
-		{
-			tab = &DCT.tab4[(code >> 2) - 16];
-		}
-		else if (code >= 32)
-		{
-			tab = &DCT.tab5[(code >> 1) - 16];
-		}
-		else if (code >= 16)
-		{
-			tab = &DCT.tab6[code - 16];
-		}
-		else
+		if (!tab)
 		{
 		  ipu_cmd.pos[4] = 0;
 		  return true;
@@ -522,53 +541,9 @@ static bool get_non_intra_block(int * last)
 			}
 
 			code = UBITS(16);
+			tab = DCTlut.get((i == 0) ? DCTlut.first : DCTlut.next, code);
 
-			if (code >= 16384)
-			{
-				if (i==0)
-				{
-					tab = &DCT.first[(code >> 12) - 4];
-				}
-				else
-				{			
-					tab = &DCT.next[(code >> 12)- 4];
-				}
-			}
-			else if (code >= 1024)
-			{
-				tab = &DCT.tab0[(code >> 8) - 4];
-			}
-			else if (code >= 512)
-			{		
-				tab = &DCT.tab1[(code >> 6) - 8];
-			}
-
-			// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-			// that should use a single unrolled DCT table instead of five separate tables used
-			// here.  Multiple conditional statements are very slow, while modern CPU data caches
-			// have lots of room to spare.
-
-			else if (code >= 256)
-			{		
-				tab = &DCT.tab2[(code >> 4) - 16];
-			}
-			else if (code >= 128)
-			{		
-				tab = &DCT.tab3[(code >> 3) - 16];
-			}
-			else if (code >= 64)
-			{		
-				tab = &DCT.tab4[(code >> 2) - 16];
-			}
-			else if (code >= 32)
-			{		
-				tab = &DCT.tab5[(code >> 1) - 16];
-			}
-			else if (code >= 16)
-			{		
-				tab = &DCT.tab6[code - 16];
-			}
-			else
+			if (!tab)
 			{
 				ipu_cmd.pos[4] = 0;
 				return true;
@@ -1210,3 +1185,101 @@ __fi bool mpeg2_slice()
 
 	return true;
 }
+
+// Builds the bitstream of an IDEC command (MPEG-2, B-14 coefficients, no dct_type, no quantizer
+// changes) made of intra macroblocks with random coefficients, for IPUBenchmark.  Coefficient
+// codes of every length are used, with small levels so that the pictures stay in range.
+void mpeg2_build_test_stream(std::vector<u8>& stream, uint macroblocks, u32 seed)
+{
+	u64 acc = 0;
+	uint accbits = 0;
+	const auto put = [&](u32 bits, uint count) {
+		for (uint i = count; i-- > 0;)
+		{
+			acc = (acc << 1) | ((bits >> i) & 1);
+			if (++accbits == 8)
+			{
+				stream.push_back((u8)acc);
+				acc = 0;
+				accbits = 0;
+			}
+		}
+	};
+	const auto random = [&seed](u32 range) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) % range;
+	};
+
+	// Emits the code of the first entry of a table that has the wanted size (DC) or run (EOB).
+	const auto put_dc_size = [&](const DCtab (&table)[32], int size) {
+		for (u32 code = 0; code < 31; code++)
+		{
+			if (table[code].size == size)
+			{
+				put(code >> (5 - table[code].len), table[code].len);
+				return;
+			}
+		}
+	};
+
+	int pred[3] = {128, 128, 128};
+
+	for (uint mb = 0; mb < macroblocks; mb++)
+	{
+		// macroblock_type: intra
+		put(1, 1);
+
+		for (int block = 0; block < 6; block++)
+		{
+			const int cc = (block < 4) ? 0 : block - 3;
+
+			// Keep the DC prediction around mid grey.
+			const int size = random(3);
+			int diff = size ? (1 << (size - 1)) + random(1 << (size - 1)) : 0;
+			if (pred[cc] > 128)
+				diff = -diff;
+			pred[cc] += diff;
+
+			put_dc_size(cc ? DCtable.chrom0 : DCtable.lum0, size);
+			if (size)
+				put(diff > 0 ? diff : diff + (1 << size) - 1, size);
+
+			uint i = 1;
+			for (uint coeffs = random(12); coeffs > 0; coeffs--)
+			{
+				for (int attempt = 0; attempt < 64; attempt++)
+				{
+					const u16 code = (u16)(random(0x10000) >> random(12));
+					const DCTtab* entry = DCT_lookup(code, false, false);
+
+					if (entry && entry->len && entry->run < 64 && entry->level <= 4 && i + entry->run < 64)
+					{
+						put(code >> (16 - entry->len), entry->len);
+						put(random(2), 1);
+						i += entry->run + 1;
+						break;
+					}
+				}
+			}
+
+			// end_of_block
+			for (u32 code = 4; code < 16; code++)
+			{
+				if (DCT.next[code - 4].run == 64)
+				{
+					put(code >> (4 - DCT.next[code - 4].len), DCT.next[code - 4].len);
+					break;
+				}
+			}
+		}
+
+		// macroblock_address_increment of 1, or the end of the slice.
+		if (mb + 1 < macroblocks)
+			put(1, 1);
+	}
+
+	// The start code that ends the slice, and enough padding for the IPU to read it.
+	put(0, (8 - accbits) & 7);
+	put(0x000001B3, 32);
+	stream.resize((stream.size() + 64) & ~15, 0);
+}
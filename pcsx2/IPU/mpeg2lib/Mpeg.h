@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <vector>
+
 // the IPU is fixed to 16 byte strides (128-bit / QWC resolution):
 static const uint decoder_stride = 16;
 
@@ -194,8 +196,10 @@ extern s32 SBITS(uint bits);
 
 extern void mpeg2_idct_copy(s16 * block, u8* dest, int stride);
 extern void mpeg2_idct_add(int last, s16 * block, s16* dest, int stride);
+extern bool mpeg2_idct_simd;
 
 extern bool mpeg2sliceIDEC();
+extern void mpeg2_build_test_stream(std::vector<u8>& stream, uint macroblocks, u32 seed);
 extern bool mpeg2_slice();
 extern int get_macroblock_address_increment();
 extern int get_macroblock_modes();
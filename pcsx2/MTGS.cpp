@@ -23,6 +23,8 @@
 #include "Gif_Unit.h"
 #include "MTVU.h"
 #include "Elfheader.h"
+#include "FrameTelemetry.h"
+#include "Utilities/ThreadPlacement.h"
 
 
 // Uncomment this to enable profiling of the GS RingBufferCopy function.
@@ -51,6 +53,7 @@ SysMtgsThread::SysMtgsThread() :
 #else
 	SysThreadBase()
 #endif
+,	m_DrainOnly(false)
 #ifdef RINGBUF_DEBUG_STACK
 ,	m_lock_Stack()
 #endif
@@ -76,6 +79,7 @@ void SysMtgsThread::OnStart()
 	m_SignalRingPosition  = 0;
 
 	m_CopyDataTally		= 0;
+	m_DrainOnly			= false;
 
 	_parent::OnStart();
 }
@@ -246,6 +250,9 @@ void SysMtgsThread::ExecuteTaskInThread()
 #ifdef __LIBRETRO__
 	pxAssert(IsSelf());
 #endif
+	// Under libretro this runs on the frontend's thread once per retro_run, which gets its
+	// placement undone by RestoreCurrentThread when the content is unloaded.
+	Threading::PlaceCurrentThread(Threading::ThreadRole::MTGS);
 
 	// Threading info: run in MTGS thread
 	// m_ReadPos is only update by the MTGS thread so it is safe to load it with a relaxed atomic
@@ -264,13 +271,17 @@ void SysMtgsThread::ExecuteTaskInThread()
 		busy.Release();
 #endif
 #ifdef __LIBRETRO__
-		while (wxTheApp->HasPendingEvents())
-			wxTheApp->ProcessPendingEvents();
-
-		while (!m_sem_event.WaitWithoutYield(wxTimeSpan::Millisecond()))
+		if (!m_DrainOnly)
 		{
 			while (wxTheApp->HasPendingEvents())
 				wxTheApp->ProcessPendingEvents();
+
+			ScopedFrameTimer wait_time(FrameTimer_MTGSWait);
+			while (!m_sem_event.WaitWithoutYield(wxTimeSpan::Millisecond()))
+			{
+				while (wxTheApp->HasPendingEvents())
+					wxTheApp->ProcessPendingEvents();
+			}
 		}
 #else
 		// Performance note: Both of these perform cancellation tests, but pthread_testcancel
@@ -298,6 +309,11 @@ void SysMtgsThread::ExecuteTaskInThread()
 			const PacketTagType& tag = (PacketTagType&)RingBuffer[local_ReadPos];
 			u32 ringposinc = 1;
 
+#ifdef __LIBRETRO__
+			if (m_DrainOnly && tag.command == GS_RINGTYPE_VSYNC)
+				return;
+#endif
+
 #ifdef RINGBUF_DEBUG_STACK
 			// pop a ringpos off the stack.  It should match this one!
 
@@ -504,9 +520,28 @@ void SysMtgsThread::ExecuteTaskInThread()
 			m_sem_Vsync.Post();
 
 		//log_cb(RETRO_LOG_WARN, "(MTGS Thread) Nothing to do!  ringpos=0x%06x\n", m_ReadPos );
+#ifdef __LIBRETRO__
+		if (m_DrainOnly)
+			return;
+#endif
 	}
 }
 
+#ifdef __LIBRETRO__
+void SysMtgsThread::DrainInThread()
+{
+	m_DrainOnly = true;
+	try {
+		ExecuteTaskInThread();
+	}
+	catch (...) {
+		m_DrainOnly = false;
+		throw;
+	}
+	m_DrainOnly = false;
+}
+#endif
+
 void SysMtgsThread::FinishTaskInThread()
 {
 	if( m_SignalRingEnable.exchange(false) )
@@ -18,6 +18,8 @@
 #include "MTVU.h"
 #include "newVif.h"
 #include "Gif_Unit.h"
+#include "FrameTelemetry.h"
+#include "Utilities/ThreadPlacement.h"
 
 __aligned16 VU_Thread vu1Thread(CpuVU1, VU1);
 
@@ -114,6 +116,8 @@ void VU_Thread::Reset()
 
 void VU_Thread::ExecuteTaskInThread()
 {
+	Threading::PlaceCurrentThread(Threading::ThreadRole::MTVU);
+
 	PCSX2_PAGEFAULT_PROTECT
 	{
 		ExecuteRingBuffer();
@@ -127,6 +131,7 @@ void VU_Thread::ExecuteRingBuffer()
 	{
 		semaEvent.WaitWithoutYield();
 		ScopedLockBool lock(mtxBusy, isBusy);
+		ScopedFrameTimer busy_time(FrameTimer_MTVU);
 		while (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos())
 		{
 			u32 tag = Read();
@@ -709,6 +709,7 @@ void memBindConditionalHandlers()
 // --------------------------------------------------------------------------------------
 eeMemoryReserve::eeMemoryReserve()
 	: _parent( L"EE Main Memory", sizeof(*eeMem) )
+	, m_shm( NULL )
 {
 }
 
@@ -720,7 +721,25 @@ void eeMemoryReserve::Reserve(VirtualMemoryManagerPtr allocator)
 
 void eeMemoryReserve::Commit()
 {
-	_parent::Commit();
+	if (!IsCommitted())
+	{
+		_parent::Commit();
+
+		// With fastmem on, back the reserve with a shared memory object so the vtlb can mirror
+		// its pages into the fastmem window.  Hosts that can't provide one run without fastmem.
+		const size_t size = m_reserve.GetCommittedBytes();
+		if (EmuConfig.Cpu.Recompiler.EnableEE && EmuConfig.Cpu.Recompiler.EnableFastmem)
+			m_shm = HostSys::CreateSharedMemory(size);
+		if (m_shm && !HostSys::MapSharedMemory(m_shm, 0, m_reserve.GetPtr(), size, PageAccess_ReadWrite()))
+		{
+			HostSys::DestroySharedMemory(m_shm);
+			m_shm = NULL;
+			_parent::Decommit();
+			_parent::Commit();
+		}
+		vtlb_SetFastmemBacking(m_shm, m_reserve.GetPtr(), size);
+	}
+
 	eeMem = (EEVM_MemoryAllocMess*)m_reserve.GetPtr();
 }
 
@@ -855,7 +874,10 @@ void eeMemoryReserve::Reset()
 
 void eeMemoryReserve::Decommit()
 {
+	vtlb_SetFastmemBacking(NULL, NULL, 0);
 	_parent::Decommit();
+	HostSys::DestroySharedMemory(m_shm);
+	m_shm = NULL;
 	eeMem = NULL;
 }
 
@@ -863,6 +885,7 @@ eeMemoryReserve::~eeMemoryReserve()
 {
 	safe_delete(mmap_faultHandler);
 	vtlb_Term();
+	HostSys::DestroySharedMemory(m_shm);
 }
 
 
@@ -955,6 +978,7 @@ void mmap_MarkCountedRamPage( u32 paddr )
 
 	m_PageProtectInfo[rampage].Mode = ProtMode_Write;
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadOnly() );
+	vtlb_UpdateFastmemProtection( rampage<<12, __pagesize, PageAccess_ReadOnly() );
 }
 
 // offset - offset of address relative to psM.
@@ -972,17 +996,40 @@ static __fi void mmap_ClearCpuBlock( uint offset )
 		"Attempted to clear a block that is already under manual protection." );
 
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
+	vtlb_UpdateFastmemProtection( rampage<<12, __pagesize, PageAccess_ReadWrite() );
 	m_PageProtectInfo[rampage].Mode = ProtMode_Manual;
 	Cpu->Clear( m_PageProtectInfo[rampage].ReverseRamMap, 0x400 );
 }
 
+// offset - offset of a ram page relative to psM.
+// For callers about to overwrite the page from outside the emulated cpus (snapshots): the
+// page is handled like a write fault would, so blocks compiled from it get cleared.
+void mmap_ClearRamPage( uint offset )
+{
+	pxAssert( eeMem );
+
+	if( m_PageProtectInfo[offset >> 12].Mode == ProtMode_Write )
+		mmap_ClearCpuBlock( offset );
+}
+
 void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& handled )
 {
 	pxAssert( eeMem );
 
 	// get bad virtual address
 	uptr offset = info.addr - (uptr)eeMem->Main;
-	if( offset >= Ps2MemSize::MainRam ) return;
+	if( offset >= Ps2MemSize::MainRam )
+	{
+		// Writes through the fastmem window's view of a protected ram page count as writes
+		// to the page itself.  Any other fault in the window is a recompiled access to memory
+		// the window doesn't mirror, which gets backpatched to the vtlb slow path.
+		if( !vtlb_GetFastmemRamOffset( info.addr, offset ) ||
+			m_PageProtectInfo[offset >> 12].Mode != ProtMode_Write )
+		{
+			handled = vtlb_BackpatchFastmem( info.pc );
+			return;
+		}
+	}
 
 	mmap_ClearCpuBlock( offset );
 	handled = true;
@@ -999,4 +1046,5 @@ void mmap_ResetBlockTracking()
 #endif
 	memzero( m_PageProtectInfo );
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
+	vtlb_UpdateFastmemProtection( 0, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
 }
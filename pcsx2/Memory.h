@@ -126,6 +126,7 @@ enum vtlb_ProtectionMode
 
 extern vtlb_ProtectionMode mmap_GetRamPageInfo( u32 paddr );
 extern void mmap_MarkCountedRamPage( u32 paddr );
+extern void mmap_ClearRamPage( uint offset );
 extern void mmap_ResetBlockTracking();
 
 #define memRead8 vtlb_memRead<mem8_t>
@@ -1,9 +1,10 @@
 #include "MemoryPatchDatabase.h"
 #include <zlib.h>
-#include <sstream>
 #include <algorithm>
 
 #define LOCAL_FILE_HEADER_SIGNATURE		0x04034b50
+#define COMPRESSION_METHOD_INDEX_OFFSET		8
+#define COMPRESSION_METHOD_STORED		0
 #define COMPRESSED_SIZE_INDEX_OFFSET		18
 #define UNCOMPRESSED_SIZE_INDEX_OFFSET  	22
 #define FILE_NAME_LENGTH_NO_EXTENSION		8
@@ -31,61 +32,58 @@ MemoryPatchDatabase::MemoryPatchDatabase(uint8_t *s, size_t len)
 	this->archive_length                   = len;
 }
 
-std::vector<std::string> MemoryPatchDatabase::GetPatchLines(std::string key)
+const MemoryPatchDatabase::Patch* MemoryPatchDatabase::FindEntry(uint32_t crc) const
 {
-	std::vector<std::string> patch_lines;
+	auto it = std::lower_bound(entries.begin(), entries.end(), crc,
+		[](const Patch& entry, uint32_t key) { return entry.crc < key; });
 
-	if (entries.count(key) == 1 && entries[key].compressed_data)
-	{
-		uint8_t uncompressed_data[MEMORY_PATCH_MAX_SIZE];
-		int result;
-
-		result = DecompressEntry(key, uncompressed_data);
-
-		if (result == Z_STREAM_END)
-		{
-			std::string patch(reinterpret_cast<const char*>(uncompressed_data), entries[key].uncompressed_size);
-			std::istringstream stream(patch);
-			std::string line;
-			while (std::getline(stream, line))
-				patch_lines.push_back(line);
-		}
-	}
-
-	return patch_lines;
+	if (it == entries.end() || it->crc != crc)
+		return nullptr;
+	return &*it;
 }
 
-int MemoryPatchDatabase::DecompressEntry(std::string key, uint8_t* dest_buffer)
+bool MemoryPatchDatabase::GetPatch(uint32_t crc, std::string& text) const
 {
-	int result = Z_ERRNO;
+	const Patch* entry = FindEntry(crc);
+	if (!entry || entry->uncompressed_size > MEMORY_PATCH_MAX_SIZE)
+		return false;
 
-	if (entries.count(key) == 1 && entries[key].compressed_data)
+	if (entry->stored)
 	{
-		z_stream stream;
-
-		// initialize the stream
-		stream.next_in = reinterpret_cast<Bytef*>(entries[key].compressed_data);
-		stream.avail_in = entries[key].compressed_size;
-		stream.zalloc = Z_NULL;
-		stream.zfree = Z_NULL;
-		stream.opaque = Z_NULL;
-		result = inflateInit2(&stream, -MAX_WBITS);
-		
-		// decompress the data into dest_buffer
-		if (result == Z_OK) {
-			stream.next_out = dest_buffer;
-			// we're assuming uncompressed_size <= 32768
-			stream.avail_out = entries[key].uncompressed_size;
-			result = inflate(&stream, Z_NO_FLUSH);
-		}
+		text.assign(reinterpret_cast<const char*>(entry->compressed_data), entry->uncompressed_size);
+		return true;
+	}
+
+	z_stream stream;
+	stream.next_in = reinterpret_cast<Bytef*>(entry->compressed_data);
+	stream.avail_in = entry->compressed_size;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+		return false;
+
+	text.resize(entry->uncompressed_size);
+	stream.next_out = reinterpret_cast<Bytef*>(&text[0]);
+	stream.avail_out = entry->uncompressed_size;
+	const int result = inflate(&stream, Z_FINISH);
+	inflateEnd(&stream);
+
+	if (result != Z_STREAM_END)
+	{
+		text.clear();
+		return false;
 	}
-	
-	return result;
+	return true;
 }
 
-void MemoryPatchDatabase::InitEntries()
+std::vector<uint32_t> MemoryPatchDatabase::GetCRCs() const
 {
-	InitEntries(this->compressed_archive_as_byte_array, this->archive_length);
+	std::vector<uint32_t> crcs;
+	crcs.reserve(entries.size());
+	for (const Patch& entry : entries)
+		crcs.push_back(entry.crc);
+	return crcs;
 }
 
 /*
@@ -100,45 +98,70 @@ the following simplifying assumptions:
 (2) In particular, encryption is not used
 (3) Extra fields are not used
 (4) Data descriptors are not used
-(5) Compression method is deflate
+(5) Compression method is deflate, or store for tiny files
 (6) All files inside the archive are filenames of the form XXXXXXX.pnach,
-	case insensitive
+	case insensitive, where XXXXXXXX is the game CRC in hex
 (7) Maximum allowed file size inside the archive is 32768 bytes
 
 If any of the above assumptions are violated, this code may NOT work, so don't
 use this as a general-purpose .ZIP reader.
+
+The entries are kept sorted by their numeric CRC, so a lookup is a binary search
+and only the one entry that is asked for is ever inflated.
 */
-void MemoryPatchDatabase::InitEntries(uint8_t* compressed_archive_as_byte_array, uint32_t archive_length)
+void MemoryPatchDatabase::InitEntries()
 {
-	uint32_t header_signature;
-	uint32_t compressed_size;
-	uint32_t uncompressed_size;
-	uint32_t total_compressed_entry_size;
-
-	if (archive_length < LOCAL_FILE_HEADER_LENGTH)
-		return; // finished processing the last entry
-	
-	header_signature = uint32_from_bytes_little_endian(compressed_archive_as_byte_array);
-	
-	if (header_signature != LOCAL_FILE_HEADER_SIGNATURE)
-		return; // finished processing the last entry
-
-	compressed_size = uint32_from_bytes_little_endian(&compressed_archive_as_byte_array[COMPRESSED_SIZE_INDEX_OFFSET]);
-	uncompressed_size = uint32_from_bytes_little_endian(&compressed_archive_as_byte_array[UNCOMPRESSED_SIZE_INDEX_OFFSET]);
-	total_compressed_entry_size = compressed_size + LOCAL_FILE_HEADER_LENGTH;
-
-	if (archive_length < total_compressed_entry_size)
-		return; // archive entry is invalid; no more valid entries to add to database
-
-	std::string file_name(reinterpret_cast<const char*>(&compressed_archive_as_byte_array[FILE_NAME_INDEX_OFFSET]),
-		FILE_NAME_LENGTH_NO_EXTENSION);
-
-	std::transform(file_name.begin(), file_name.end(), file_name.begin(), ::toupper);
-
-	entries[file_name].compressed_size = compressed_size;
-	entries[file_name].uncompressed_size = uncompressed_size;
-	entries[file_name].compressed_data = &compressed_archive_as_byte_array[LOCAL_FILE_HEADER_LENGTH];
-	
-	// processes the archive, starting from the next entry
-	InitEntries(&compressed_archive_as_byte_array[total_compressed_entry_size], archive_length - total_compressed_entry_size);
+	uint8_t* archive = compressed_archive_as_byte_array;
+	uint32_t remaining = archive_length;
+
+	entries.clear();
+
+	while (remaining >= LOCAL_FILE_HEADER_LENGTH)
+	{
+		if (uint32_from_bytes_little_endian(archive) != LOCAL_FILE_HEADER_SIGNATURE)
+			break; // finished processing the last entry
+
+		Patch entry;
+		entry.compressed_size = uint32_from_bytes_little_endian(&archive[COMPRESSED_SIZE_INDEX_OFFSET]);
+		entry.uncompressed_size = uint32_from_bytes_little_endian(&archive[UNCOMPRESSED_SIZE_INDEX_OFFSET]);
+		entry.compressed_data = &archive[LOCAL_FILE_HEADER_LENGTH];
+		entry.stored = uint16_from_bytes_little_endian(&archive[COMPRESSION_METHOD_INDEX_OFFSET]) == COMPRESSION_METHOD_STORED;
+		if (entry.stored && entry.compressed_size != entry.uncompressed_size)
+			break; // archive entry is invalid; no more valid entries to add to database
+
+		const uint32_t total_compressed_entry_size = entry.compressed_size + LOCAL_FILE_HEADER_LENGTH;
+		if (remaining < total_compressed_entry_size)
+			break; // archive entry is invalid; no more valid entries to add to database
+
+		bool valid_name = true;
+		for (int i = 0; i < FILE_NAME_LENGTH_NO_EXTENSION; i++)
+		{
+			const uint8_t c = archive[FILE_NAME_INDEX_OFFSET + i];
+			uint32_t digit;
+			if (c >= '0' && c <= '9')
+				digit = c - '0';
+			else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+				digit = (c | 0x20) - 'a' + 10;
+			else
+			{
+				valid_name = false;
+				break;
+			}
+			entry.crc = (entry.crc << 4) | digit;
+		}
+
+		if (valid_name)
+			entries.push_back(entry);
+
+		// processes the archive, starting from the next entry
+		archive += total_compressed_entry_size;
+		remaining -= total_compressed_entry_size;
+	}
+
+	// Stable, so that the last of several entries with the same CRC still replaces the others.
+	std::stable_sort(entries.begin(), entries.end(),
+		[](const Patch& a, const Patch& b) { return a.crc < b.crc; });
+	auto first = std::unique(entries.rbegin(), entries.rend(),
+		[](const Patch& a, const Patch& b) { return a.crc == b.crc; });
+	entries.erase(entries.begin(), first.base());
 }
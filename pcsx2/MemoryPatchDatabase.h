@@ -1,6 +1,5 @@
 #pragma once
 
-#include <unordered_map>
 #include <string>
 #include <vector>
 
@@ -13,18 +12,22 @@ public:
 
 	struct Patch
 	{
+		uint32_t crc = 0;
 		uint32_t compressed_size = 0;
 		uint32_t uncompressed_size = 0;
 		uint8_t* compressed_data;
+		bool stored = false;
 	};
 
-	std::vector<std::string> GetPatchLines(std::string key);
+	// Inflates the pnach text of the given game CRC, returns false if there is none.
+	bool GetPatch(uint32_t crc, std::string& text) const;
+	std::vector<uint32_t> GetCRCs() const;
 	void InitEntries();
-	void InitEntries(uint8_t* compressed_archive_as_byte_array, uint32_t archive_length);
 private:
-	int DecompressEntry(std::string key, uint8_t* dest_buffer);
+	const Patch* FindEntry(uint32_t crc) const;
 
-	std::unordered_map<std::string, Patch> entries;
+	// sorted by CRC
+	std::vector<Patch> entries;
 	uint8_t* compressed_archive_as_byte_array;
 	uint32_t archive_length;
 };
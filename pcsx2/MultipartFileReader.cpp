@@ -156,6 +156,11 @@ uint MultipartFileReader::GetFirstPart(uint lsn)
 	return 0xBAAAAAAD;
 }
 
+bool MultipartFileReader::IsAsync() const
+{
+	return m_parts[0].reader->IsAsync();
+}
+
 int MultipartFileReader::ReadSync(void* pBuffer, uint sector, uint count)
 {
 	BeginRead(pBuffer,sector,count);
@@ -22,7 +22,10 @@
 #include "GameDatabase.h"
 #include "MemoryPatchDatabase.h"
 
+#include <charconv>
+#include <chrono>
 #include <memory>
+#include <string_view>
 #include <vector>
 #include <wx/textfile.h>
 #include <wx/dir.h>
@@ -39,6 +42,9 @@ extern void _ApplyPatch(IniPatch* p);
 
 std::vector<IniPatch> Patch;
 
+// Cleared by PatchDatabaseBenchmark to keep author and comment lines out of the log.
+static bool LogPatchComments = true;
+
 struct PatchTextTable
 {
 	int				code;
@@ -201,46 +207,308 @@ static int _LoadPatchFiles(const wxDirName& folderName, wxString& fileSpec, cons
 	return Patch.size() - before;
 }
 
-int LoadWidescreenPatchesFromDatabase(std::string gameCRC)
+// The archives are indexed on first use; function-local statics so that a boot task can do
+// that ahead of time without racing the core thread.
+static MemoryPatchDatabase* GetWidescreenDatabase()
 {
-	static MemoryPatchDatabase *widescreen_database;
-	std::transform(gameCRC.begin(), gameCRC.end(), gameCRC.begin(), ::toupper);
+	static MemoryPatchDatabase* widescreen_database = [] {
+		MemoryPatchDatabase* database = new MemoryPatchDatabase(cheats_ws_zip, cheats_ws_zip_len);
+		database->InitEntries();
+		return database;
+	}();
+	return widescreen_database;
+}
 
-	int before = Patch.size();
+static MemoryPatchDatabase* GetNointerlacingDatabase()
+{
+	static MemoryPatchDatabase* nointerlacing_database = [] {
+		MemoryPatchDatabase* database = new MemoryPatchDatabase(cheats_nointerlacing_zip, cheats_nointerlacing_zip_len);
+		database->InitEntries();
+		return database;
+	}();
+	return nointerlacing_database;
+}
+
+void PreloadPatchDatabases(bool widescreen, bool nointerlacing)
+{
+	if (widescreen)
+		GetWidescreenDatabase();
+	if (nointerlacing)
+		GetNointerlacingDatabase();
+}
 
-	if (!widescreen_database)
+// string_view counterparts of the wxString parsing above, for the patch archives.  They follow
+// inifile_processString() and PatchFunc::patch() to the letter, but work on the inflated pnach
+// text in place instead of building a wxString (and a wxArrayString) for every line.
+
+static bool IsPatchSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+static std::string_view TrimPatchLeft(std::string_view str)
+{
+	while (!str.empty() && IsPatchSpace(str.front()))
+		str.remove_prefix(1);
+	return str;
+}
+
+static std::string_view TrimPatchString(std::string_view str)
+{
+	str = TrimPatchLeft(str);
+	while (!str.empty() && IsPatchSpace(str.back()))
+		str.remove_suffix(1);
+	return str;
+}
+
+// Same rules as pxParseAssignmentString().
+static bool ParsePatchAssignment(std::string_view src, std::string_view& lvalue, std::string_view& rvalue)
+{
+	if (src.substr(0, 2) == "--" || src.substr(0, 2) == "//" || src.substr(0, 1) == ";")
+		return false;
+
+	const size_t eq = src.find('=');
+	lvalue = TrimPatchString(src.substr(0, eq));
+	rvalue = (eq == std::string_view::npos) ? std::string_view() : TrimPatchString(src.substr(eq + 1));
+	return true;
+}
+
+// Same as PatchTableExecute() on an assignment string, minus calling the table's function.
+static int PatchTableLookup(std::string_view src, const PatchTextTable* Table)
+{
+	std::string_view name, value;
+	if (!ParsePatchAssignment(src, name, value))
+		name = std::string_view();
+
+	int i = 0;
+	for (; Table[i].text[0]; i++)
 	{
-		widescreen_database = new MemoryPatchDatabase(cheats_ws_zip, cheats_ws_zip_len);
-		widescreen_database->InitEntries();
+		const wxChar* text = Table[i].text;
+		size_t len = 0;
+		while (len < name.size() && text[len] == static_cast<wxChar>(static_cast<unsigned char>(name[len])))
+			len++;
+		if (len == name.size() && !text[len])
+			break;
 	}
-	std::vector<std::string> patch_lines = widescreen_database->GetPatchLines(gameCRC);
 
-	for (std::string line : patch_lines)
-		inifile_processString(line);
+	return Table[i].code;
+}
 
-	return Patch.size() - before;
+static u64 ParsePatchNumber(std::string_view str, int base)
+{
+	str = TrimPatchLeft(str);
+	if (base == 16 && str.size() >= 2 && str[0] == '0' && (str[1] | 0x20) == 'x')
+		str.remove_prefix(2);
+
+	u64 value = 0;
+	std::from_chars(str.data(), str.data() + str.size(), value, base);
+	return value;
 }
 
-int LoadNointerlacingPatchesFromDatabase(std::string gameCRC)
+static void PatchFromString(std::string_view cmd, std::string_view param)
 {
-	static MemoryPatchDatabase* nointerlacing_database;
-	std::transform(gameCRC.begin(), gameCRC.end(), gameCRC.begin(), ::toupper);
+#ifndef NDEBUG
+	log_cb(RETRO_LOG_DEBUG, "%.*s %.*s\n", (int)cmd.size(), cmd.data(), (int)param.size(), param.data());
+#endif
 
-	int before = Patch.size();
+	// The pieces are split like wxStringTokenizer does: empty ones count, a trailing one doesn't.
+	std::string_view pieces[5];
+	uint count = 0;
+	for (std::string_view rest = param; !rest.empty() && count < 5; count++)
+	{
+		const size_t comma = rest.find(',');
+		pieces[count] = rest.substr(0, comma);
+		rest = (comma == std::string_view::npos) ? std::string_view() : rest.substr(comma + 1);
+	}
 
-	if (!nointerlacing_database)
+	IniPatch iPatch = {0};
+
+	if (count < 5)
 	{
-		nointerlacing_database = new MemoryPatchDatabase(cheats_nointerlacing_zip, cheats_nointerlacing_zip_len);
-		nointerlacing_database->InitEntries();
+		log_cb(RETRO_LOG_ERROR, "Expected 5 data parameters; only found %u\n", count);
+		goto error;
 	}
-	std::vector<std::string> patch_lines = nointerlacing_database->GetPatchLines(gameCRC);
 
-	for (std::string line : patch_lines)
-		inifile_processString(line);
+	iPatch.enabled = 0;
+	iPatch.placetopatch = static_cast<u32>(ParsePatchNumber(pieces[0], 10));
+
+	if (iPatch.placetopatch >= _PPT_END_MARKER)
+	{
+		log_cb(RETRO_LOG_ERROR, "Invalid 'place' value '%.*s' (0 - once on startup, 1: continuously)\n", (int)pieces[0].size(), pieces[0].data());
+		goto error;
+	}
+
+	iPatch.cpu = (patch_cpu_type)PatchTableLookup(pieces[1], cpuCore);
+	iPatch.addr = static_cast<u32>(ParsePatchNumber(pieces[2], 16));
+	iPatch.type = (patch_data_type)PatchTableLookup(pieces[3], dataType);
+	iPatch.data = ParsePatchNumber(pieces[4], 16);
+
+	if (iPatch.cpu == 0)
+	{
+		log_cb(RETRO_LOG_ERROR, "Unrecognized CPU Target: '%.*s'\n", (int)pieces[1].size(), pieces[1].data());
+		goto error;
+	}
+
+	if (iPatch.type == 0)
+	{
+		log_cb(RETRO_LOG_ERROR, "Unrecognized Operand Size: '%.*s'\n", (int)pieces[3].size(), pieces[3].data());
+		goto error;
+	}
+
+	iPatch.enabled = 1; // omg success!!
+	Patch.push_back(iPatch);
+	return;
+
+error:
+	log_cb(RETRO_LOG_ERROR, "(Patch) Error Parsing: %.*s=%.*s\n", (int)cmd.size(), cmd.data(), (int)param.size(), param.data());
+}
+
+static void inifile_processLine(std::string_view line)
+{
+	line = TrimPatchLeft(line);
+	if (line.size() <= 1 || line.substr(0, 2) == "//")
+		return;
+	line = TrimPatchString(line);
+
+	std::string_view lvalue, rvalue;
+	if (!ParsePatchAssignment(line, lvalue, rvalue))
+		return;
+	if (rvalue.empty())
+		rvalue = lvalue;
+
+	switch (PatchTableLookup(lvalue, commands_patch))
+	{
+		case 1:
+			if (LogPatchComments)
+				log_cb(RETRO_LOG_INFO, "Author: %.*s\n", (int)rvalue.size(), rvalue.data());
+			break;
+		case 2:
+			if (LogPatchComments)
+				log_cb(RETRO_LOG_INFO, "comment: %.*s\n", (int)rvalue.size(), rvalue.data());
+			break;
+		case 3:
+			PatchFromString(lvalue, rvalue);
+			break;
+	}
+}
+
+static bool ParsePatchCRC(const std::string& gameCRC, u32& crc)
+{
+	const char* end = gameCRC.data() + gameCRC.size();
+	auto result = std::from_chars(gameCRC.data(), end, crc, 16);
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+static int LoadPatchesFromDatabase(const MemoryPatchDatabase& database, const std::string& gameCRC)
+{
+	u32 crc;
+	std::string text;
+	if (!ParsePatchCRC(gameCRC, crc) || !database.GetPatch(crc, text))
+		return 0;
+
+	int before = Patch.size();
+
+	std::string_view rest(text);
+	while (!rest.empty())
+	{
+		const size_t eol = rest.find('\n');
+		inifile_processLine(rest.substr(0, eol));
+		rest = (eol == std::string_view::npos) ? std::string_view() : rest.substr(eol + 1);
+	}
 
 	return Patch.size() - before;
 }
 
+int LoadWidescreenPatchesFromDatabase(std::string gameCRC)
+{
+	return LoadPatchesFromDatabase(*GetWidescreenDatabase(), gameCRC);
+}
+
+int LoadNointerlacingPatchesFromDatabase(std::string gameCRC)
+{
+	return LoadPatchesFromDatabase(*GetNointerlacingDatabase(), gameCRC);
+}
+
+// Loads the patches of every game in both patch archives, once through the wxString parser
+// the pnach files use and once through the string_view one, reporting the speed of each and
+// checking that they load the same patches.  Loaded patches are restored afterwards.
+void PatchDatabaseBenchmark(uint rounds)
+{
+	const std::vector<IniPatch> savedPatches(std::move(Patch));
+	LogPatchComments = false;
+
+	MemoryPatchDatabase* databases[] = {GetWidescreenDatabase(), GetNointerlacingDatabase()};
+	const char* names[] = {"widescreen", "no-interlacing"};
+
+	for (int db = 0; db < 2; db++)
+	{
+		const MemoryPatchDatabase& database = *databases[db];
+		const std::vector<u32> crcs = database.GetCRCs();
+
+		std::vector<std::string> keys;
+		for (u32 crc : crcs)
+		{
+			char key[9];
+			snprintf(key, sizeof(key), "%08X", crc);
+			keys.push_back(key);
+		}
+
+		double sec[2] = {0, 0};
+		size_t loaded[2] = {0, 0};
+		std::vector<IniPatch> results[2];
+
+		for (uint run = 0; run < rounds * 2; run++)
+		{
+			const int mode = run % 2;
+			Patch.clear();
+
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < crcs.size(); i++)
+			{
+				if (mode == 0)
+				{
+					// What loading a patch used to take: the inflated text as lines, parsed as wxStrings.
+					std::string text;
+					if (!database.GetPatch(crcs[i], text))
+						continue;
+					std::vector<std::string> lines;
+					std::istringstream stream(text);
+					std::string line;
+					while (std::getline(stream, line))
+						lines.push_back(line);
+					for (const std::string& patch_line : lines)
+						inifile_processString(patch_line);
+				}
+				else
+					LoadPatchesFromDatabase(database, keys[i]);
+			}
+			const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			if (run < 2 || elapsed < sec[mode])
+				sec[mode] = elapsed;
+			loaded[mode] = Patch.size();
+			results[mode].swap(Patch);
+		}
+
+		bool match = loaded[0] == loaded[1];
+		for (size_t i = 0; match && i < loaded[0]; i++)
+		{
+			const IniPatch& a = results[0][i];
+			const IniPatch& b = results[1][i];
+			match = a.enabled == b.enabled && a.type == b.type && a.cpu == b.cpu &&
+				a.placetopatch == b.placetopatch && a.addr == b.addr && a.data == b.data;
+		}
+
+		log_cb(RETRO_LOG_INFO, "(Patch) %s database: %zu games, %zu patches\n", names[db], crcs.size(), loaded[1]);
+		log_cb(RETRO_LOG_INFO, "(Patch)   wxString parser    : %8.3f ms\n", sec[0] * 1000.0);
+		log_cb(RETRO_LOG_INFO, "(Patch)   string_view parser : %8.3f ms (%.2fx)%s\n", sec[1] * 1000.0,
+			sec[1] > 0 ? sec[0] / sec[1] : 0.0, match ? "" : " -- MISMATCH");
+	}
+
+	LogPatchComments = true;
+	Patch = savedPatches;
+}
+
 
 // This routine loads patches from *.pnach files
 // Returns number of patches loaded
@@ -286,12 +554,14 @@ namespace PatchFunc
 {
 	void comment(const wxString& text1, const wxString& text2)
 	{
-		log_cb(RETRO_LOG_INFO, "comment: %s\n", WX_STR(text2));
+		if (LogPatchComments)
+			log_cb(RETRO_LOG_INFO, "comment: %s\n", WX_STR(text2));
 	}
 
 	void author(const wxString& text1, const wxString& text2)
 	{
-		log_cb(RETRO_LOG_INFO, "Author: %s\n", WX_STR(text2));
+		if (LogPatchComments)
+			log_cb(RETRO_LOG_INFO, "Author: %s\n", WX_STR(text2));
 	}
 
 	struct PatchPieces
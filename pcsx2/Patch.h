@@ -106,6 +106,8 @@ extern int LoadPatchesFromGamesDB(const wxString& crc, const GameDatabaseSchema:
 extern int LoadPatchesFromDir(wxString name, const wxDirName& folderName, const wxString& friendlyName);
 extern int LoadWidescreenPatchesFromDatabase(std::string gameCRC);
 extern int LoadNointerlacingPatchesFromDatabase(std::string gameCRC);
+extern void PreloadPatchDatabases(bool widescreen, bool nointerlacing);
+extern void PatchDatabaseBenchmark(uint rounds = 8);
 
 // Patches the emulation memory by applying all the loaded patches with a specific place value.
 // Note: unless you know better, there's no need to check whether or not different patch sources
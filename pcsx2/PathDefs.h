@@ -32,6 +32,7 @@ enum FoldersEnum_t
 
 	FolderId_Cheats,
 	FolderId_CheatsWS,
+	FolderId_Cache,
 
 	FolderId_COUNT
 };
@@ -55,6 +56,7 @@ namespace PathDefs
 	extern wxDirName GetSettings();
 	extern wxDirName GetCheats();
 	extern wxDirName GetCheatsWS();
+	extern wxDirName GetCache();
 
 	extern wxDirName Get( FoldersEnum_t folderidx );
 
@@ -67,6 +69,7 @@ namespace PathDefs
 		extern const wxDirName& Settings();
 		extern const wxDirName& Cheats();
 		extern const wxDirName& CheatsWS();
+		extern const wxDirName& Cache();
 	}
 }
 
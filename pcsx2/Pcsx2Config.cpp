@@ -91,6 +91,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 	UseMicroVU0	= true;
 	UseMicroVU1	= true;
 
+	EnableFastmem = false;
+
 	// vu and fpu clamping default to standard overflow.
 	vuOverflow	= true;
 	//vuExtraOverflow = false;
@@ -144,6 +146,7 @@ void Pcsx2Config::RecompilerOptions::LoadSave()
 
 	UseMicroVU0 = PCSX2_vm::UseMicroVU0;
 	UseMicroVU1 = PCSX2_vm::UseMicroVU1;
+	EnableFastmem = PCSX2_vm::EnableFastmem;
 
 	vuOverflow = PCSX2_vm::vuOverflow;
 	vuExtraOverflow = PCSX2_vm::vuExtraOverflow;
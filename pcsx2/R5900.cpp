@@ -37,6 +37,7 @@
 
 #include "../DebugTools/Breakpoints.h"
 #include "R5900OpcodeTables.h"
+#include "FrameTelemetry.h"
 
 using namespace R5900;	// for R5900 disasm tools
 
@@ -75,7 +76,10 @@ void cpuReset()
 	if (GetMTGS().IsOpen())
 		GetMTGS().WaitGS();		// GS better be done processing before we reset the EE, just in case.
 
-	GetVmMemory().ResetAll();
+	{
+		ScopedBootPhase phase("VM memory reset");
+		GetVmMemory().ResetAll();
+	}
 
 	memzero(cpuRegs);
 	memzero(fpuRegs);
@@ -270,12 +274,15 @@ __fi void cpuClearInt( uint i )
 	cpuRegs.interrupt &= ~(1 << i);
 }
 
+static EventTestStats s_eventTestStats = {};
+
 static __fi void TESTINT( u8 n, void (*callback)() )
 {
 	if( !(cpuRegs.interrupt & (1 << n)) ) return;
 
 	if( cpuTestCycle( cpuRegs.sCycle[n], cpuRegs.eCycle[n] ) )
 	{
+		s_eventTestStats.intDispatches++;
 		cpuClearInt( n );
 		callback();
 	}
@@ -295,6 +302,9 @@ static __fi void _cpuTestInterrupts()
 	/* These are 'pcsx2 interrupts', they handle asynchronous stuff
 	   that depends on the cycle timings */
 
+	if (cpuRegs.interrupt)
+		s_eventTestStats.intScans++;
+
 	TESTINT(DMAC_VIF1,		vif1Interrupt);	
 	TESTINT(DMAC_GIF,		gifInterrupt);
 	TESTINT(DMAC_SIF0,		EEsif0Interrupt);
@@ -367,13 +377,21 @@ static bool cpuIntsEnabled(int Interrupt)
 
 // if cpuRegs.cycle is greater than this cycle, should check cpuEventTest for updates
 u32 g_nextEventCycle = 0;
+void (*cpuEventTestHook)() = NULL;
 
 // Shared portion of the branch test, called from both the Interpreter
 // and the recompiler.  (moved here to help alleviate redundant code)
 __fi void _cpuEventTest_Shared()
 {
+	if (cpuEventTestHook)
+	{
+		cpuEventTestHook();
+		return;
+	}
+
 	ScopedBool etest(eeEventTestIsActive);
 	g_nextEventCycle = cpuRegs.cycle + eeWaitCycles;
+	s_eventTestStats.tests++;
 
 	// ---- INTC / DMAC (CPU-level Exceptions) -----------------
 	// Done first because exceptions raised during event tests need to be postponed a few
@@ -534,6 +552,44 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 	cpuSetNextEventDelta( cpuRegs.eCycle[n] );
 }
 
+// Called by the EE at every vsync.  With frame telemetry on, the averages and the busiest
+// frame are logged every 600 frames.
+EventTestStats cpuEventTestFrame()
+{
+	static const uint SummaryFrames = 600;
+	static EventTestStats total, worst;
+	static uint frames = 0;
+
+	const EventTestStats frame = s_eventTestStats;
+	s_eventTestStats = {};
+
+	if (!FrameTelemetryEnabled.load(std::memory_order_relaxed))
+	{
+		frames = 0;
+		return frame;
+	}
+
+	if (frames == 0)
+	{
+		total = {};
+		worst = {};
+	}
+	total.tests += frame.tests;
+	total.intScans += frame.intScans;
+	total.intDispatches += frame.intDispatches;
+	if (frame.tests > worst.tests)
+		worst = frame;
+
+	if (++frames == SummaryFrames)
+	{
+		log_cb(RETRO_LOG_INFO, "(Frame) EE event tests per frame: %u, with DMA events pending %u, events dispatched %u (busiest frame: %u, %u, %u)\n",
+			total.tests / SummaryFrames, total.intScans / SummaryFrames, total.intDispatches / SummaryFrames,
+			worst.tests, worst.intScans, worst.intDispatches);
+		frames = 0;
+	}
+	return frame;
+}
+
 // Called from recompilers; __fastcall define is mandatory.
 void __fastcall eeGameStarting()
 {
@@ -542,6 +598,7 @@ void __fastcall eeGameStarting()
 		//log_cb(RETRO_LOG_INFO, "(R5900) ELF Entry point! [addr=0x%08X]\n", ElfEntry );
 		g_GameStarted = true;
 		g_GameLoading = false;
+		SysLogBootTime("Game entry point", true);
 		GetCoreThread().GameStartingInThread();
 
 		// GameStartingInThread may issue a reset of the cpu and/or recompilers.  Check for and
@@ -446,8 +446,23 @@ extern void cpuSetNextEventDelta( s32 delta );
 extern int  cpuTestCycle( u32 startCycle, s32 delta );
 extern void cpuSetEvent();
 
+// Event test counts of a frame.
+struct EventTestStats
+{
+	u32 tests;			// event tests run (the slow path of the recompiler's branch test)
+	u32 intScans;		// of those, the ones with DMA events pending to test
+	u32 intDispatches;	// DMA events dispatched
+};
+
+// Returns the counts since the previous call, the EE calls it every vsync.
+extern EventTestStats cpuEventTestFrame();
+
 extern void _cpuEventTest_Shared();		// for internal use by the Dynarecs and Ints inside R5900:
 
+// Called in place of the event test while set, to run EE code with nothing else of the
+// machine behind it (CoreBenchmark).  It has to set g_nextEventCycle itself.
+extern void (*cpuEventTestHook)();
+
 extern void cpuTestINTCInts();
 extern void cpuTestDMACInts();
 extern void cpuTestTIMRInts();
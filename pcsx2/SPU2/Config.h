@@ -28,5 +28,7 @@ extern float VolumeAdjustSLdb;
 extern float VolumeAdjustSRdb;
 extern float VolumeAdjustLFEdb;
 extern bool postprocess_filter_dealias;
+// Mix voices several ticks at a time when it can't be told apart from per-tick mixing.
+extern bool BlockMixing;
 
 extern int dplLevel;
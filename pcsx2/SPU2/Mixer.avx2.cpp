@@ -0,0 +1,90 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// AVX2 build of the batched voice mixing kernels, see MixerBatch.h.  Only used when x86caps
+// reports AVX2.
+
+#include "MixerBatch.h"
+
+#include <immintrin.h>
+
+// Anonymous so the lane operators can't be merged with another object's inline copies.
+namespace
+{
+
+// 8 voice lanes, see MixVoiceBatch.
+struct VoiceLanes8
+{
+	static const uint Count = 8;
+
+	__m256i v;
+
+	VoiceLanes8(__m256i src)
+		: v(src)
+	{
+	}
+
+	VoiceLanes8(s32 src)
+		: v(_mm256_set1_epi32(src))
+	{
+	}
+
+	static VoiceLanes8 Load(const s32* src) { return _mm256_load_si256((const __m256i*)src); }
+	void Store(s32* dest) const { _mm256_store_si256((__m256i*)dest, v); }
+
+	friend VoiceLanes8 operator+(const VoiceLanes8& a, const VoiceLanes8& b) { return _mm256_add_epi32(a.v, b.v); }
+	friend VoiceLanes8 operator-(const VoiceLanes8& a, const VoiceLanes8& b) { return _mm256_sub_epi32(a.v, b.v); }
+	friend VoiceLanes8 operator-(const VoiceLanes8& a) { return _mm256_sub_epi32(_mm256_setzero_si256(), a.v); }
+	friend VoiceLanes8 operator*(const VoiceLanes8& a, const VoiceLanes8& b) { return _mm256_mullo_epi32(a.v, b.v); }
+	friend VoiceLanes8 operator&(const VoiceLanes8& a, const VoiceLanes8& b) { return _mm256_and_si256(a.v, b.v); }
+	friend VoiceLanes8 operator<<(const VoiceLanes8& a, int count) { return _mm256_slli_epi32(a.v, count); }
+	friend VoiceLanes8 operator>>(const VoiceLanes8& a, int count) { return _mm256_srai_epi32(a.v, count); }
+
+	static VoiceLanes8 Select(const VoiceLanes8& mask, const VoiceLanes8& a, const VoiceLanes8& b)
+	{
+		return _mm256_blendv_epi8(b.v, a.v, mask.v);
+	}
+
+	static VoiceLanes8 MulShr32(const VoiceLanes8& a, const VoiceLanes8& b)
+	{
+		const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a.v, b.v), 32);
+		const __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a.v, 32), _mm256_srli_epi64(b.v, 32));
+		return _mm256_blend_epi32(even, odd, 0xAA);
+	}
+
+	s32 Sum() const
+	{
+		__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(sum);
+	}
+};
+
+} // namespace
+
+template <int InterpType>
+static void MixVoiceBatchKernel(VoiceBatch& batch, VoiceBatchMix& mix)
+{
+	MixVoiceBatch<InterpType, VoiceLanes8>(batch, mix);
+}
+
+const MixVoiceBatchFn MixVoiceBatchAVX2[5] = {
+	MixVoiceBatchKernel<0>,
+	MixVoiceBatchKernel<1>,
+	MixVoiceBatchKernel<2>,
+	MixVoiceBatchKernel<3>,
+	MixVoiceBatchKernel<4>,
+};
@@ -15,6 +15,10 @@
 
 #include "PrecompiledHeader.h"
 #include "Global.h"
+#include "MixerBatch.h"
+
+#include <algorithm>
+#include <chrono>
 
 /* Forward declaration */
 extern retro_audio_sample_t sample_cb;
@@ -77,30 +81,50 @@ __forceinline
 static void __forceinline XA_decode_block(s16* buffer, const s16* block, s32& prev1, s32& prev2)
 {
 	const s32 header = *block;
-	const s32 shift = (header & 0xF) + 16;
 	const int id = header >> 4 & 0xF;
 	const s32 pred1 = tbl_XA_Factor[id][0];
 	const s32 pred2 = tbl_XA_Factor[id][1];
 
-	const s8* blockbytes = (s8*)&block[1];
-	const s8* blockend = &blockbytes[13];
+	// Expand the 28 nibbles to shifted 16 bit samples all at once: each data byte holds the
+	// even sample in its low nibble.  Header and data are exactly 16 bytes, so a single load
+	// covers the block and lanes 28-31 are left as padding.
+	const __m128i shift = _mm_cvtsi32_si128(header & 0xF);
+	const __m128i data = _mm_srli_si128(_mm_loadu_si128((const __m128i*)block), 2);
+	const __m128i bytes[2] = {
+		_mm_unpacklo_epi8(data, _mm_setzero_si128()),
+		_mm_unpackhi_epi8(data, _mm_setzero_si128())};
 
-	for (; blockbytes <= blockend; ++blockbytes)
+	__aligned16 s16 nibbles[32];
+	for (int i = 0; i < 2; i++)
 	{
-		s32 data = ((*blockbytes) << 28) & 0xF0000000;
-		s32 pcm = (data >> shift) + (((pred1 * prev1) + (pred2 * prev2) + 32) >> 6);
+		const __m128i lo = _mm_slli_epi16(bytes[i], 12);
+		const __m128i hi = _mm_and_si128(_mm_slli_epi16(bytes[i], 8), _mm_set1_epi16((s16)0xF000));
+		_mm_store_si128((__m128i*)&nibbles[i * 16 + 0], _mm_sra_epi16(_mm_unpacklo_epi16(lo, hi), shift));
+		_mm_store_si128((__m128i*)&nibbles[i * 16 + 8], _mm_sra_epi16(_mm_unpackhi_epi16(lo, hi), shift));
+	}
 
-		Clampify(pcm, -0x8000, 0x7fff);
-		*(buffer++) = pcm;
+	// Filter 0 (and the undefined 5-15) has no prediction, the block is the raw data.
+	if (pred1 == 0 && pred2 == 0)
+	{
+		_mm_storeu_si128((__m128i*)&buffer[0], _mm_load_si128((__m128i*)&nibbles[0]));
+		_mm_storeu_si128((__m128i*)&buffer[8], _mm_load_si128((__m128i*)&nibbles[8]));
+		_mm_storeu_si128((__m128i*)&buffer[16], _mm_load_si128((__m128i*)&nibbles[16]));
+		_mm_storel_epi64((__m128i*)&buffer[24], _mm_load_si128((__m128i*)&nibbles[24]));
 
-		data = ((*blockbytes) << 24) & 0xF0000000;
-		s32 pcm2 = (data >> shift) + (((pred1 * pcm) + (pred2 * prev1) + 32) >> 6);
+		prev2 = nibbles[26];
+		prev1 = nibbles[27];
+		return;
+	}
 
-		Clampify(pcm2, -0x8000, 0x7fff);
-		*(buffer++) = pcm2;
+	for (int i = 0; i < 28; i++)
+	{
+		s32 pcm = nibbles[i] + (((pred1 * prev1) + (pred2 * prev2) + 32) >> 6);
 
-		prev2 = pcm;
-		prev1 = pcm2;
+		Clampify(pcm, -0x8000, 0x7fff);
+		buffer[i] = pcm;
+
+		prev2 = prev1;
+		prev1 = pcm;
 	}
 }
 
@@ -282,9 +306,9 @@ static __forceinline StereoOut32 ApplyVolume(const StereoOut32& data, const V_Vo
 		ApplyVolume(data.Right, volume.Right.Value));
 }
 
-static void __forceinline UpdatePitch(uint coreidx, uint voiceidx)
+// modulator is the previous voice's OutX for the same tick.
+static void __forceinline UpdatePitch(V_Voice& vc, uint voiceidx, s32 modulator)
 {
-	V_Voice& vc(Cores[coreidx].Voices[voiceidx]);
 	s32 pitch;
 
 	// [Air] : re-ordered comparisons: Modulated is much more likely to be zero than voice,
@@ -294,11 +318,17 @@ static void __forceinline UpdatePitch(uint coreidx, uint voiceidx)
 	if ((vc.Modulated == 0) || (voiceidx == 0))
 		pitch = vc.Pitch;
 	else
-		pitch = GetClamped((vc.Pitch * (32768 + Cores[coreidx].Voices[voiceidx - 1].OutX)) >> 15, 0, 0x3fff);
+		pitch = GetClamped((vc.Pitch * (32768 + modulator)) >> 15, 0, 0x3fff);
 
 	vc.SP += pitch;
 }
 
+static void __forceinline UpdatePitch(uint coreidx, uint voiceidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	UpdatePitch(thiscore.Voices[voiceidx], voiceidx, voiceidx ? thiscore.Voices[voiceidx - 1].OutX : 0);
+}
+
 
 static __forceinline void CalculateADSR(V_Core& thiscore, uint voiceidx)
 {
@@ -310,88 +340,20 @@ static __forceinline void CalculateADSR(V_Core& thiscore, uint voiceidx)
 		return;
 	}
 
+	// Infinite sustain (rate 0x7f) holds the envelope, the steady state of most voices.
+	if (vc.ADSR.Phase == 3 && vc.ADSR.SustainRate == 0x7f && !vc.ADSR.Releasing)
+		return;
+
 	if (!vc.ADSR.Calculate())
 		vc.Stop();
 
 	pxAssume(vc.ADSR.Value >= 0); // ADSR should never be negative...
 }
 
-/*
-   Tension: 65535 is high, 32768 is normal, 0 is low
-*/
-template <s32 i_tension>
-__forceinline static s32 HermiteInterpolate(
-	s32 y0, // 16.0
-	s32 y1, // 16.0
-	s32 y2, // 16.0
-	s32 y3, // 16.0
-	s32 mu  //  0.12
-)
-{
-	s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
-	s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
-	s32 m0 = m00 + m01;
-
-	s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
-	s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
-	s32 m1 = m10 + m11;
-
-	s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
-	val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
-	val = ((val + m0) * mu) >> 11;                            // 16.0
-
-	return (val + (y1 << 1));
-}
-
-__forceinline static s32 CatmullRomInterpolate(
-	s32 y0, // 16.0
-	s32 y1, // 16.0
-	s32 y2, // 16.0
-	s32 y3, // 16.0
-	s32 mu  //  0.12
-)
-{
-	//q(t) = 0.5 *(    	(2 * P1) +
-	//	(-P0 + P2) * t +
-	//	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
-	//	(-P0 + 3*P1- 3*P2 + P3) * t3)
-
-	s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
-	s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
-	s32 a1 = (-y0 + y2);
-	s32 a0 = (2 * y1);
-
-	s32 val = ((a3)*mu) >> 12;
-	val = ((a2 + val) * mu) >> 12;
-	val = ((a1 + val) * mu) >> 12;
-
-	return (a0 + val);
-}
-
-__forceinline static s32 CubicInterpolate(
-	s32 y0, // 16.0
-	s32 y1, // 16.0
-	s32 y2, // 16.0
-	s32 y3, // 16.0
-	s32 mu  //  0.12
-)
-{
-	const s32 a0 = y3 - y2 - y0 + y1;
-	const s32 a1 = y0 - y1 - a0;
-	const s32 a2 = y2 - y0;
-
-	s32 val = ((a0)*mu) >> 12;
-	val = ((val + a1) * mu) >> 12;
-	val = ((val + a2) * mu) >> 11;
-
-	return (val + (y1 << 1));
-}
-
-// Returns a 16 bit result in Value.
-// Uses standard template-style optimization techniques to statically generate five different
-// versions of this function (one for each type of interpolation).
+// Steps the voice's sample pointer, shifting newly decoded samples into the interpolation
+// history.  Only the history needed by the interpolation type is kept up to date.
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+static __forceinline void FetchVoiceValues(V_Core& thiscore, uint voiceidx)
 {
 	V_Voice& vc(thiscore.Voices[voiceidx]);
 
@@ -406,27 +368,19 @@ static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
 		vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
 		vc.SP -= 4096;
 	}
+}
 
-	const s32 mu = vc.SP + 4096;
-
-	switch (InterpType)
-	{
-		case 0:
-			return vc.PV1 << 1;
-		case 1:
-			return (vc.PV1 << 1) - (((vc.PV2 - vc.PV1) * vc.SP) >> 11);
-
-		case 2:
-			return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-		case 3:
-			return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-		case 4:
-			return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+// Returns a 16 bit result in Value.
+// Uses standard template-style optimization techniques to statically generate five different
+// versions of this function (one for each type of interpolation).
+template <int InterpType>
+static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+{
+	V_Voice& vc(thiscore.Voices[voiceidx]);
 
-			jNO_DEFAULT;
-	}
+	FetchVoiceValues<InterpType>(thiscore, voiceidx);
 
-	return 0; // technically unreachable!
+	return InterpolateVoice<InterpType>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, vc.SP);
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -477,7 +431,10 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+// modulator and outpos are given by the caller so that blocks can mix a voice several ticks
+// ahead, see MixBlock.
+template <int InterpType>
+static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx, s32 modulator, u32 outpos)
 {
 	V_Core& thiscore(Cores[coreidx]);
 	V_Voice& vc(thiscore.Voices[voiceidx]);
@@ -496,7 +453,7 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 	// have to run through all the motions of updating the voice regardless of it's
 	// audible status.  Otherwise IRQs might not trigger and emulation might fail.
 
-	UpdatePitch(coreidx, voiceidx);
+	UpdatePitch(vc, voiceidx, modulator);
 
 	StereoOut32 voiceOut(0, 0);
 	s32 Value = 0;
@@ -506,31 +463,7 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 		if (vc.Noise)
 			Value = GetNoiseValues(thiscore, voiceidx);
 		else
-		{
-			// Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-			// turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-			switch (Interpolation)
-			{
-				case 0:
-					Value = GetVoiceValues<0>(thiscore, voiceidx);
-					break;
-				case 1:
-					Value = GetVoiceValues<1>(thiscore, voiceidx);
-					break;
-				case 2:
-					Value = GetVoiceValues<2>(thiscore, voiceidx);
-					break;
-				case 3:
-					Value = GetVoiceValues<3>(thiscore, voiceidx);
-					break;
-				case 4:
-					Value = GetVoiceValues<4>(thiscore, voiceidx);
-					break;
-
-					jNO_DEFAULT;
-			}
-		}
+			Value = GetVoiceValues<InterpType>(thiscore, voiceidx);
 
 		// Update and Apply ADSR  (applies to normal and noise sources)
 		//
@@ -554,16 +487,44 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
 	// Write-back of raw voice data (post ADSR applied)
 	if (voiceidx == 1)
-		spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, Value);
+		spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + outpos, Value);
 	else if (voiceidx == 3)
-		spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, Value);
+		spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + outpos, Value);
 
 	return voiceOut;
 }
 
+static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+{
+	const s32 modulator = voiceidx ? Cores[coreidx].Voices[voiceidx - 1].OutX : 0;
+
+	// Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+	// turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
+
+	switch (Interpolation)
+	{
+		case 0:
+			return MixVoice<0>(coreidx, voiceidx, modulator, OutPos);
+		case 1:
+			return MixVoice<1>(coreidx, voiceidx, modulator, OutPos);
+		case 2:
+			return MixVoice<2>(coreidx, voiceidx, modulator, OutPos);
+		case 3:
+			return MixVoice<3>(coreidx, voiceidx, modulator, OutPos);
+		case 4:
+			return MixVoice<4>(coreidx, voiceidx, modulator, OutPos);
+
+			jNO_DEFAULT;
+	}
+
+	return StereoOut32(); // technically unreachable!
+}
+
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
-static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+// Mixes the core's voices one at a time.  Required for pitch modulation, which makes a voice
+// depend on the output of the previous one.
+static __forceinline void MixCoreVoicesSerial(VoiceMixSet& dest, const uint coreidx)
 {
 	V_Core& thiscore(Cores[coreidx]);
 
@@ -580,6 +541,339 @@ static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
 	}
 }
 
+// Disabled by MixBenchmark to time the per-voice path.
+static bool MixBatchedVoices = true;
+
+// --------------------------------------------------------------------------------------
+//  Batched voice mixing
+// --------------------------------------------------------------------------------------
+// The voices are stepped (pitch, ADPCM fetch, ADSR) one at a time since those have side
+// effects on SPU2 memory and IRQs, the results are then gathered in a structure-of-arrays
+// layout and interpolation, envelope and volume are computed for 8 (AVX2) or 4 (SSE4.1)
+// voices at once by the kernels of MixerBatch.h.
+
+static_assert(VoiceBatch::NumVoices == V_Core::NumVoices, "VoiceBatch holds one core's voices");
+
+// The batched kernels for this cpu, NULL without SSE4.1.
+static __forceinline const MixVoiceBatchFn* GetMixVoiceBatch()
+{
+	if (x86caps.hasAVX2)
+		return MixVoiceBatchAVX2;
+	if (x86caps.hasStreamingSIMD4Extensions)
+		return MixVoiceBatchSSE41;
+	return NULL;
+}
+
+template <int InterpType>
+static __forceinline void MixCoreVoicesBatched(VoiceMixSet& dest, const uint coreidx, MixVoiceBatchFn kernel)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	VoiceBatch batch;
+	u32 active = 0;
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		V_Voice& vc(thiscore.Voices[voiceidx]);
+
+		// Same steps, in the same order, as MixVoice.
+		pxAssertMsg((vc.SCurrent <= 28) && (vc.SCurrent != 0), "Current sample should always range from 1->28");
+
+		vc.Volume.Update();
+		UpdatePitch(coreidx, voiceidx);
+
+		if (vc.ADSR.Phase > 0)
+		{
+			active |= 1 << voiceidx;
+
+			if (vc.Noise)
+			{
+				batch.Direct[voiceidx] = GetNoiseValues(thiscore, voiceidx);
+				batch.DirectMask[voiceidx] = -1;
+			}
+			else
+			{
+				FetchVoiceValues<InterpType>(thiscore, voiceidx);
+				batch.DirectMask[voiceidx] = 0;
+			}
+
+			CalculateADSR(thiscore, voiceidx);
+			batch.Envelope[voiceidx] = vc.ADSR.Value;
+		}
+		else
+		{
+			while (vc.SP > 0)
+				GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+
+			batch.Direct[voiceidx] = 0;
+			batch.DirectMask[voiceidx] = -1;
+			batch.Envelope[voiceidx] = 0;
+		}
+
+		batch.PV4[voiceidx] = vc.PV4;
+		batch.PV3[voiceidx] = vc.PV3;
+		batch.PV2[voiceidx] = vc.PV2;
+		batch.PV1[voiceidx] = vc.PV1;
+		batch.SP[voiceidx] = vc.SP;
+
+		batch.VolL[voiceidx] = vc.Volume.Left.Value;
+		batch.VolR[voiceidx] = vc.Volume.Right.Value;
+
+		batch.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+		batch.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+		batch.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+		batch.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
+		// Write-back of raw voice data (post ADSR applied).  It has to land before the next
+		// voice fetches, which may read it back, so these two are computed here as well.
+		if (voiceidx == 1 || voiceidx == 3)
+		{
+			s32 value = batch.DirectMask[voiceidx] ? batch.Direct[voiceidx] : InterpolateVoice<InterpType>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, vc.SP);
+			value = MulShr32(value, batch.Envelope[voiceidx]);
+
+			if (voiceidx == 1)
+				spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, value);
+			else
+				spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, value);
+		}
+	}
+
+	VoiceBatchMix mix;
+	kernel(batch, mix);
+
+	dest.Dry.Left += mix.DryL;
+	dest.Dry.Right += mix.DryR;
+	dest.Wet.Left += mix.WetL;
+	dest.Wet.Right += mix.WetR;
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		if (active & (1 << voiceidx))
+			thiscore.Voices[voiceidx].OutX = batch.Value[voiceidx];
+	}
+}
+
+static __forceinline bool IsPitchModulated(const V_Core& thiscore)
+{
+	// Voice 0 has nothing to modulate from, UpdatePitch ignores its flag.
+	for (uint voiceidx = 1; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		if (thiscore.Voices[voiceidx].Modulated)
+			return true;
+	}
+	return false;
+}
+
+static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+{
+	const MixVoiceBatchFn* kernels = GetMixVoiceBatch();
+
+	if (kernels && MixBatchedVoices && !IsPitchModulated(Cores[coreidx]))
+	{
+		const MixVoiceBatchFn kernel = kernels[Interpolation];
+
+		switch (Interpolation)
+		{
+			case 0:
+				MixCoreVoicesBatched<0>(dest, coreidx, kernel);
+				break;
+			case 1:
+				MixCoreVoicesBatched<1>(dest, coreidx, kernel);
+				break;
+			case 2:
+				MixCoreVoicesBatched<2>(dest, coreidx, kernel);
+				break;
+			case 3:
+				MixCoreVoicesBatched<3>(dest, coreidx, kernel);
+				break;
+			case 4:
+				MixCoreVoicesBatched<4>(dest, coreidx, kernel);
+				break;
+
+				jNO_DEFAULT;
+		}
+		return;
+	}
+
+	MixCoreVoicesSerial(dest, coreidx);
+}
+
+// --------------------------------------------------------------------------------------
+//  Block mixing
+// --------------------------------------------------------------------------------------
+// TimeUpdate has the voices of several ticks mixed at once, voice by voice instead of tick
+// by tick, whenever nothing else in those ticks can tell the difference.  Core mixing, reverb,
+// input and output still run once per tick from Mix(), which picks up the block's voice data.
+//
+// Voices only interact with the rest of the SPU2 through:
+//  * the voice 1/3 output at 0x400-0x7ff, which can be read back by DMA (TimeUpdate ends
+//    the block before a DMA read completes) or by reverb (checked here);
+//  * reads of SPU2 RAM that is written per tick: everything below SPU2_DYN_MEMLINE and the
+//    reverb work areas (checked here against the furthest a voice can get in the block);
+//  * IRQs, which are recorded with their tick and raised when Mix() reaches it.
+
+static const uint MixBlockSize = 64;
+
+static VoiceMixSet BlockVoices[MixBlockSize][2];
+static uint BlockPos = 0;
+static uint BlockLength = 0;
+
+// Tick being mixed ahead, -1 outside of MixBlock.
+static int BlockTick = -1;
+// First tick of the block at which each core's IRQ is raised by a voice.
+static uint BlockIrqTick[2];
+
+bool MixBlockIrq(int core)
+{
+	if (BlockTick < 0)
+		return false;
+
+	BlockIrqTick[core] = std::min(BlockIrqTick[core], (uint)BlockTick);
+	return true;
+}
+
+static __forceinline bool RangesOverlap(u32 start, u32 end, u32 otherStart, u32 otherEnd)
+{
+	return start < otherEnd && otherStart < end;
+}
+
+static bool CanMixBlock(uint ticks)
+{
+	for (uint coreidx = 0; coreidx < 2; ++coreidx)
+	{
+		const V_Core& thiscore(Cores[coreidx]);
+		if (thiscore.EffectsBufferSize > 0 && RangesOverlap(thiscore.EffectsStartA, thiscore.EffectsEndA + 1, 0x400, 0x800))
+			return false;
+	}
+
+	for (uint coreidx = 0; coreidx < 2; ++coreidx)
+	{
+		for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+		{
+			const V_Voice& vc(Cores[coreidx].Voices[voiceidx]);
+
+			// Samples fetched in the block, rounded up to whole blocks plus the partial ones at
+			// both ends.  A loop can only start at a block the voice went through, so twice that
+			// from the current and loop addresses covers everything it can read.
+			const u32 pitch = (vc.Modulated && voiceidx) ? 0x3fff : vc.Pitch;
+			const u32 samples = (std::max(vc.SP, 0) + ticks * pitch) / 4096 + 1;
+			const u32 span = (samples / 28 + 2) * pcm_WordsPerBlock * 2;
+
+			const u32 starts[2] = {vc.NextA & 0xFFFF8, vc.LoopStartA & 0xFFFF8};
+			for (u32 start : starts)
+			{
+				const u32 end = start + span;
+				if (end > 0x100000 || RangesOverlap(start, end, 0, SPU2_DYN_MEMLINE))
+					return false;
+
+				for (int i = 0; i < 2; i++)
+				{
+					if (Cores[i].EffectsBufferSize > 0 && RangesOverlap(start, end, Cores[i].EffectsStartA, Cores[i].EffectsEndA + 1))
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+template <int InterpType>
+static void MixBlockVoices(uint ticks)
+{
+	for (uint coreidx = 0; coreidx < 2; ++coreidx)
+	{
+		V_Core& thiscore(Cores[coreidx]);
+
+		// OutX of the previous voice after each tick, for pitch modulation.
+		s32 modulators[MixBlockSize] = {0};
+
+		for (uint tick = 0; tick < ticks; ++tick)
+			BlockVoices[tick][coreidx] = VoiceMixSet::Empty;
+
+		for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+		{
+			const V_VoiceGates& gates(thiscore.VoiceGates[voiceidx]);
+
+			for (uint tick = 0; tick < ticks; ++tick)
+			{
+				BlockTick = tick;
+
+				StereoOut32 VVal(MixVoice<InterpType>(coreidx, voiceidx, modulators[tick], (OutPos + tick) & 0x1ff));
+
+				VoiceMixSet& dest(BlockVoices[tick][coreidx]);
+				dest.Dry.Left += VVal.Left & gates.DryL;
+				dest.Dry.Right += VVal.Right & gates.DryR;
+				dest.Wet.Left += VVal.Left & gates.WetL;
+				dest.Wet.Right += VVal.Right & gates.WetR;
+
+				modulators[tick] = thiscore.Voices[voiceidx].OutX;
+			}
+		}
+	}
+
+	BlockTick = -1;
+}
+
+// Mixes the voices of up to the given number of ticks ahead, starting with the current one.
+// Does nothing if the previous block hasn't been used up or the voices can't be mixed ahead.
+void MixBlock(uint ticks)
+{
+	if (BlockPos < BlockLength)
+		return;
+
+	BlockPos = BlockLength = 0;
+	ticks = std::min(ticks, MixBlockSize);
+
+	if (ticks < 2 || !CanMixBlock(ticks))
+		return;
+
+	BlockIrqTick[0] = BlockIrqTick[1] = MixBlockSize;
+
+	switch (Interpolation)
+	{
+		case 0:
+			MixBlockVoices<0>(ticks);
+			break;
+		case 1:
+			MixBlockVoices<1>(ticks);
+			break;
+		case 2:
+			MixBlockVoices<2>(ticks);
+			break;
+		case 3:
+			MixBlockVoices<3>(ticks);
+			break;
+		case 4:
+			MixBlockVoices<4>(ticks);
+			break;
+
+			jNO_DEFAULT;
+	}
+
+	BlockLength = ticks;
+}
+
+// Gets the mixed voices of both cores for the current tick.
+static __forceinline void MixVoices(VoiceMixSet (&VoiceData)[2])
+{
+	if (BlockPos < BlockLength)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			if (BlockIrqTick[i] == BlockPos)
+				SetIrqCall(i);
+		}
+
+		VoiceData[0] = BlockVoices[BlockPos][0];
+		VoiceData[1] = BlockVoices[BlockPos][1];
+		BlockPos++;
+		return;
+	}
+
+	MixCoreVoices(VoiceData[0], 0);
+	MixCoreVoices(VoiceData[1], 1);
+}
+
 StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext)
 {
 	MasterVol.Update();
@@ -760,8 +1054,7 @@ __forceinline
 
 	// Todo: Replace me with memzero initializer!
 	VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-	MixCoreVoices(VoiceData[0], 0);
-	MixCoreVoices(VoiceData[1], 1);
+	MixVoices(VoiceData);
 
 	StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32(0, 0)));
 
@@ -820,3 +1113,161 @@ __forceinline
 	if (OutPos >= 0x200)
 		OutPos = 0;
 }
+
+// Compares the voice state that mixing advances.
+static bool SameVoiceState(const V_Core* a, const V_Core* b)
+{
+	for (uint core = 0; core < 2; core++)
+	{
+		for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; voiceidx++)
+		{
+			const V_Voice& va(a[core].Voices[voiceidx]);
+			const V_Voice& vb(b[core].Voices[voiceidx]);
+
+			if (va.NextA != vb.NextA || va.SCurrent != vb.SCurrent || va.SP != vb.SP ||
+				va.Prev1 != vb.Prev1 || va.Prev2 != vb.Prev2 ||
+				va.PV1 != vb.PV1 || va.PV2 != vb.PV2 || va.PV3 != vb.PV3 || va.PV4 != vb.PV4 ||
+				va.OutX != vb.OutX || va.ADSR.Value != vb.ADSR.Value || va.ADSR.Phase != vb.ADSR.Phase ||
+				va.Volume.Left.Value != vb.Volume.Left.Value || va.Volume.Right.Value != vb.Volume.Right.Value)
+				return false;
+		}
+	}
+	return true;
+}
+
+// Mixes a set of synthetic voices with the per-voice, the batched and the block mixer for
+// every interpolation mode, reporting the speed of each and checking that they all give the
+// same output.  The SPU2 must not be running, its state is restored afterwards.
+void MixBenchmark(uint samples)
+{
+	const size_t memSize = 0x200000;
+	const size_t cacheSize = pcm_BlockCount * sizeof(PcmCacheEntry);
+
+	std::unique_ptr<V_Core[]> savedCores(new V_Core[2]);
+	std::unique_ptr<u8[]> savedMem(new u8[memSize]);
+	std::unique_ptr<u8[]> savedCache(new u8[cacheSize]);
+	std::unique_ptr<V_Core[]> startCores(new V_Core[2]);
+	std::unique_ptr<V_Core[]> endCores(new V_Core[2]);
+
+	std::copy(Cores, Cores + 2, savedCores.get());
+	memcpy(savedMem.get(), _spu2mem, memSize);
+	memcpy(savedCache.get(), pcm_cache_data, cacheSize);
+	const s16 savedOutPos = OutPos;
+	const int savedInterpolation = Interpolation;
+	const bool savedBatched = MixBatchedVoices;
+
+	// Every voice loops over its own 0x800 words of random ADPCM, using all the filters.
+	u32 seed = 0x12345678;
+	for (uint core = 0; core < 2; core++)
+	{
+		V_Core& thiscore(Cores[core]);
+		thiscore.IRQEnable = false;
+		thiscore.EffectsBufferSize = 0;
+
+		for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; voiceidx++)
+		{
+			const u32 start = SPU2_DYN_MEMLINE + (core * V_Core::NumVoices + voiceidx) * 0x800;
+
+			for (u32 block = 0; block < 0x800; block += pcm_WordsPerBlock)
+			{
+				seed = seed * 1103515245 + 12345;
+				u32 flags = 0;
+				if (block == 0)
+					flags = XAFLAG_LOOP_START;
+				else if (block + pcm_WordsPerBlock == 0x800)
+					flags = XAFLAG_LOOP_END | XAFLAG_LOOP;
+
+				s16* memptr = GetMemPtr(start + block);
+				memptr[0] = (s16)((flags << 8) | ((seed >> 16) % 5) << 4 | ((seed >> 24) % 12));
+				for (int i = 1; i < pcm_WordsPerBlock; i++)
+				{
+					seed = seed * 1103515245 + 12345;
+					memptr[i] = (s16)(seed >> 16);
+				}
+			}
+
+			V_Voice& vc(thiscore.Voices[voiceidx]);
+			vc.StartA = start;
+			vc.Pitch = 0x400 + voiceidx * 0x100;
+			vc.Modulated = false;
+			vc.Noise = false;
+			vc.Volume = V_VolumeSlideLR(0x3fff, 0x7fffffff >> (voiceidx & 3));
+			vc.ADSR.regADSR1 = 0x000f | (voiceidx << 8);
+			vc.ADSR.regADSR2 = 0x1fc0;
+			vc.Start();
+
+			// Leave a few voices off, they still step through their data.
+			if (voiceidx % 8 == 7)
+				vc.Stop();
+
+			thiscore.VoiceGates[voiceidx].DryL = -1;
+			thiscore.VoiceGates[voiceidx].DryR = (voiceidx & 1) ? -1 : 0;
+			thiscore.VoiceGates[voiceidx].WetL = (voiceidx & 2) ? -1 : 0;
+			thiscore.VoiceGates[voiceidx].WetR = -1;
+		}
+	}
+	std::copy(Cores, Cores + 2, startCores.get());
+
+	const MixVoiceBatchFn* kernels = GetMixVoiceBatch();
+	const char* batchedIsa = kernels == MixVoiceBatchAVX2 ? "AVX2" : kernels ? "SSE4.1" : "no SSE4.1, per-voice";
+
+	for (int interp = 0; interp < 5; interp++)
+	{
+		Interpolation = interp;
+
+		double sec[3] = {0, 0, 0};
+		s32 checksum[3];
+		bool match = true;
+
+		// Alternate the paths and keep the best of a few runs each.
+		for (int run = 0; run < 9; run++)
+		{
+			const int mode = run % 3;
+
+			std::copy(startCores.get(), startCores.get() + 2, Cores);
+			for (int i = 0; i < pcm_BlockCount; i++)
+				pcm_cache_data[i].Validated = false;
+			OutPos = 0;
+			MixBatchedVoices = mode == 1;
+
+			s32 sum = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (uint i = 0; i < samples; i++)
+			{
+				if (mode == 2)
+					MixBlock(samples - i);
+
+				VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty};
+				MixVoices(VoiceData);
+
+				sum = sum * 31 + VoiceData[0].Dry.Left + VoiceData[0].Dry.Right + VoiceData[0].Wet.Left + VoiceData[0].Wet.Right;
+				sum = sum * 31 + VoiceData[1].Dry.Left + VoiceData[1].Dry.Right + VoiceData[1].Wet.Left + VoiceData[1].Wet.Right;
+
+				OutPos++;
+				if (OutPos >= 0x200)
+					OutPos = 0;
+			}
+			const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			if (run < 3 || elapsed < sec[mode])
+				sec[mode] = elapsed;
+			checksum[mode] = sum;
+
+			if (run == 0)
+				std::copy(Cores, Cores + 2, endCores.get());
+			else if (checksum[mode] != checksum[0] || !SameVoiceState(endCores.get(), Cores))
+				match = false;
+		}
+
+		log_cb(match ? RETRO_LOG_INFO : RETRO_LOG_ERROR,
+			"Mixer benchmark: interpolation %d: per-voice %.1fx realtime, batched (%s) %.1fx realtime, block %.1fx realtime%s\n",
+			interp, samples / 48000.0 / sec[0], batchedIsa, samples / 48000.0 / sec[1], samples / 48000.0 / sec[2], match ? "" : " (output MISMATCH)");
+	}
+
+	std::copy(savedCores.get(), savedCores.get() + 2, Cores);
+	memcpy(_spu2mem, savedMem.get(), memSize);
+	memcpy(pcm_cache_data, savedCache.get(), cacheSize);
+	OutPos = savedOutPos;
+	Interpolation = savedInterpolation;
+	MixBatchedVoices = savedBatched;
+}
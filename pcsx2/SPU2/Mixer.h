@@ -127,6 +127,10 @@ struct FrequencyResponseFilter
 };
 
 extern void Mix();
+extern void MixBlock(uint ticks);
+extern bool MixBlockIrq(int core);
+extern void MixBenchmark(uint samples = 48000 * 4);
+extern void ReverbBenchmark(uint samples = 48000 * 4);
 extern s32 clamp_mix(s32 x, u8 bitshift = 0);
 
 extern StereoOut32 clamp_mix(const StereoOut32& sample, u8 bitshift = 0);
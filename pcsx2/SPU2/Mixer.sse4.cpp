@@ -0,0 +1,90 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// SSE4.1 build of the batched voice mixing kernels, see MixerBatch.h.  Only used when x86caps
+// reports SSE4.1.
+
+#include "MixerBatch.h"
+
+#include <immintrin.h>
+
+// Anonymous so the lane operators can't be merged with another object's inline copies.
+namespace
+{
+
+// 4 voice lanes, see MixVoiceBatch.
+struct VoiceLanes4
+{
+	static const uint Count = 4;
+
+	__m128i v;
+
+	VoiceLanes4(__m128i src)
+		: v(src)
+	{
+	}
+
+	VoiceLanes4(s32 src)
+		: v(_mm_set1_epi32(src))
+	{
+	}
+
+	static VoiceLanes4 Load(const s32* src) { return _mm_load_si128((const __m128i*)src); }
+	void Store(s32* dest) const { _mm_store_si128((__m128i*)dest, v); }
+
+	friend VoiceLanes4 operator+(const VoiceLanes4& a, const VoiceLanes4& b) { return _mm_add_epi32(a.v, b.v); }
+	friend VoiceLanes4 operator-(const VoiceLanes4& a, const VoiceLanes4& b) { return _mm_sub_epi32(a.v, b.v); }
+	friend VoiceLanes4 operator-(const VoiceLanes4& a) { return _mm_sub_epi32(_mm_setzero_si128(), a.v); }
+	friend VoiceLanes4 operator*(const VoiceLanes4& a, const VoiceLanes4& b) { return _mm_mullo_epi32(a.v, b.v); }
+	friend VoiceLanes4 operator&(const VoiceLanes4& a, const VoiceLanes4& b) { return _mm_and_si128(a.v, b.v); }
+	friend VoiceLanes4 operator<<(const VoiceLanes4& a, int count) { return _mm_slli_epi32(a.v, count); }
+	friend VoiceLanes4 operator>>(const VoiceLanes4& a, int count) { return _mm_srai_epi32(a.v, count); }
+
+	// Lanes of a where mask is set, b elsewhere.
+	static VoiceLanes4 Select(const VoiceLanes4& mask, const VoiceLanes4& a, const VoiceLanes4& b)
+	{
+		return _mm_blendv_epi8(b.v, a.v, mask.v);
+	}
+
+	static VoiceLanes4 MulShr32(const VoiceLanes4& a, const VoiceLanes4& b)
+	{
+		const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a.v, b.v), 32);
+		const __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+		return _mm_blend_epi16(even, odd, 0xCC);
+	}
+
+	s32 Sum() const
+	{
+		__m128i sum = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(sum);
+	}
+};
+
+} // namespace
+
+template <int InterpType>
+static void MixVoiceBatchKernel(VoiceBatch& batch, VoiceBatchMix& mix)
+{
+	MixVoiceBatch<InterpType, VoiceLanes4>(batch, mix);
+}
+
+const MixVoiceBatchFn MixVoiceBatchSSE41[5] = {
+	MixVoiceBatchKernel<0>,
+	MixVoiceBatchKernel<1>,
+	MixVoiceBatchKernel<2>,
+	MixVoiceBatchKernel<3>,
+	MixVoiceBatchKernel<4>,
+};
@@ -0,0 +1,200 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Voice interpolation and the SIMD half of batched voice mixing.  Mixer.cpp gathers the state
+// of a core's voices into a VoiceBatch, the kernels in Mixer.sse4.cpp and Mixer.avx2.cpp are
+// built with SSE4.1 and AVX2 enabled and Mixer.cpp picks one at runtime from x86caps.  This
+// header is kept free of anything but the basic types so that those two objects don't carry
+// their own copies of inline functions shared with the rest of the core.
+
+#include "Pcsx2Defs.h"
+
+/*
+   Tension: 65535 is high, 32768 is normal, 0 is low
+*/
+template <s32 i_tension, typename T>
+__forceinline static T HermiteInterpolate(
+	T y0, // 16.0
+	T y1, // 16.0
+	T y2, // 16.0
+	T y3, // 16.0
+	T mu  //  0.12
+)
+{
+	T m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
+	T m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
+	T m0 = m00 + m01;
+
+	T m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
+	T m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
+	T m1 = m10 + m11;
+
+	T val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
+	val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
+	val = ((val + m0) * mu) >> 11;                            // 16.0
+
+	return (val + (y1 << 1));
+}
+
+template <typename T>
+__forceinline static T CatmullRomInterpolate(
+	T y0, // 16.0
+	T y1, // 16.0
+	T y2, // 16.0
+	T y3, // 16.0
+	T mu  //  0.12
+)
+{
+	//q(t) = 0.5 *(    	(2 * P1) +
+	//	(-P0 + P2) * t +
+	//	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
+	//	(-P0 + 3*P1- 3*P2 + P3) * t3)
+
+	T a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
+	T a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
+	T a1 = (-y0 + y2);
+	T a0 = (2 * y1);
+
+	T val = ((a3)*mu) >> 12;
+	val = ((a2 + val) * mu) >> 12;
+	val = ((a1 + val) * mu) >> 12;
+
+	return (a0 + val);
+}
+
+template <typename T>
+__forceinline static T CubicInterpolate(
+	T y0, // 16.0
+	T y1, // 16.0
+	T y2, // 16.0
+	T y3, // 16.0
+	T mu  //  0.12
+)
+{
+	const T a0 = y3 - y2 - y0 + y1;
+	const T a1 = y0 - y1 - a0;
+	const T a2 = y2 - y0;
+
+	T val = ((a0)*mu) >> 12;
+	val = ((val + a1) * mu) >> 12;
+	val = ((val + a2) * mu) >> 11;
+
+	return (val + (y1 << 1));
+}
+
+// Returns a 16 bit result, T is either a single s32 or a set of voice lanes (see MixVoiceBatch).
+template <int InterpType, typename T>
+static __forceinline T InterpolateVoice(T PV4, T PV3, T PV2, T PV1, T SP)
+{
+	const T mu = SP + 4096;
+
+	switch (InterpType)
+	{
+		case 0:
+			return PV1 << 1;
+		case 1:
+			return (PV1 << 1) - (((PV2 - PV1) * SP) >> 11);
+
+		case 2:
+			return CubicInterpolate(PV4, PV3, PV2, PV1, mu);
+		case 3:
+			return HermiteInterpolate<16384>(PV4, PV3, PV2, PV1, mu);
+		case 4:
+			return CatmullRomInterpolate(PV4, PV3, PV2, PV1, mu);
+
+		default:
+			break;
+	}
+
+	return 0; // technically unreachable!
+}
+
+// Per-sample state of one core's voices, one array entry per voice.
+struct __aligned32 VoiceBatch
+{
+	static const uint NumVoices = 24;
+
+	s32 PV4[NumVoices];
+	s32 PV3[NumVoices];
+	s32 PV2[NumVoices];
+	s32 PV1[NumVoices];
+	s32 SP[NumVoices];
+
+	// Replaces the interpolated value where DirectMask is set: noise, or 0 for a silent voice.
+	s32 Direct[NumVoices];
+	s32 DirectMask[NumVoices];
+
+	s32 Envelope[NumVoices];
+	s32 VolL[NumVoices];
+	s32 VolR[NumVoices];
+
+	s32 DryL[NumVoices];
+	s32 DryR[NumVoices];
+	s32 WetL[NumVoices];
+	s32 WetR[NumVoices];
+
+	// Result: the voice value with ADSR applied (what MixVoice stores to OutX).
+	s32 Value[NumVoices];
+};
+
+// Gated sums of the batch's voices after volume.
+struct VoiceBatchMix
+{
+	s32 DryL;
+	s32 DryR;
+	s32 WetL;
+	s32 WetR;
+};
+
+// Interpolation, envelope and volume for T::Count voices at a time.  T is a set of s32 lanes
+// with the integer operators used by the interpolators, plus Load/Store, Select (lanes of a
+// where mask is set), MulShr32 and Sum.  All the arithmetic gives the same result as MixVoice.
+template <int InterpType, typename T>
+static __forceinline void MixVoiceBatch(VoiceBatch& batch, VoiceBatchMix& mix)
+{
+	T dryL(0), dryR(0), wetL(0), wetR(0);
+
+	for (uint i = 0; i < VoiceBatch::NumVoices; i += T::Count)
+	{
+		T value = InterpolateVoice<InterpType>(
+			T::Load(&batch.PV4[i]), T::Load(&batch.PV3[i]), T::Load(&batch.PV2[i]), T::Load(&batch.PV1[i]), T::Load(&batch.SP[i]));
+
+		value = T::Select(T::Load(&batch.DirectMask[i]), T::Load(&batch.Direct[i]), value);
+		value = T::MulShr32(value, T::Load(&batch.Envelope[i]));
+		value.Store(&batch.Value[i]);
+
+		// ApplyVolume
+		const T left = T::MulShr32(value << 1, T::Load(&batch.VolL[i]));
+		const T right = T::MulShr32(value << 1, T::Load(&batch.VolR[i]));
+
+		dryL = dryL + (left & T::Load(&batch.DryL[i]));
+		dryR = dryR + (right & T::Load(&batch.DryR[i]));
+		wetL = wetL + (left & T::Load(&batch.WetL[i]));
+		wetR = wetR + (right & T::Load(&batch.WetR[i]));
+	}
+
+	mix.DryL = dryL.Sum();
+	mix.DryR = dryR.Sum();
+	mix.WetL = wetL.Sum();
+	mix.WetR = wetR.Sum();
+}
+
+typedef void (*MixVoiceBatchFn)(VoiceBatch& batch, VoiceBatchMix& mix);
+
+// Kernels indexed by interpolation type.
+extern const MixVoiceBatchFn MixVoiceBatchSSE41[5];
+extern const MixVoiceBatchFn MixVoiceBatchAVX2[5];
@@ -15,6 +15,8 @@
 
 #include "PrecompiledHeader.h"
 #include "Global.h"
+#include <algorithm>
+#include <chrono>
 
 __forceinline s32 V_Core::RevbGetIndexer(s32 offset)
 {
@@ -48,7 +50,18 @@ void V_Core::Reverb_AdvanceBuffer()
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
+// Disabled by ReverbBenchmark to time the per-tap path.
+static bool VectorReverb = true;
+
 StereoOut32 V_Core::DoReverb(const StereoOut32& Input)
+{
+	// DoReverbVector is built with SSE4.1 in Reverb.sse4.cpp.
+	if (VectorReverb && x86caps.hasStreamingSIMD4Extensions)
+		return DoReverbVector(Input);
+	return DoReverbSerial(Input);
+}
+
+StereoOut32 V_Core::DoReverbSerial(const StereoOut32& Input)
 {
 	if (EffectsBufferSize <= 0)
 	{
@@ -137,3 +150,120 @@ StereoOut32 V_Core::DoReverb(const StereoOut32& Input)
 
 	return LastEffect;
 }
+
+// Runs both cores' reverb over the current SPU2 RAM with the per-tap and the vector path,
+// reporting the speed of each and checking that they give the same output and leave the same
+// effects buffers behind.  A core without a usable effects area gets a random preset.  The
+// SPU2 must not be running, its state is restored afterwards.
+void ReverbBenchmark(uint samples)
+{
+	const size_t memSize = 0x200000;
+
+	std::unique_ptr<V_Core[]> savedCores(new V_Core[2]);
+	std::unique_ptr<u8[]> savedMem(new u8[memSize]);
+	std::unique_ptr<V_Core[]> startCores(new V_Core[2]);
+	std::unique_ptr<u8[]> startMem(new u8[memSize]);
+	std::unique_ptr<u8[]> endMem(new u8[memSize]);
+
+	std::copy(Cores, Cores + 2, savedCores.get());
+	memcpy(savedMem.get(), _spu2mem, memSize);
+	const u32 savedCycles = Cycles;
+	const bool savedVector = VectorReverb;
+
+	u32 seed = 0x12345678;
+	auto random = [&seed](u32 range) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) % range;
+	};
+
+	for (uint core = 0; core < 2; core++)
+	{
+		V_Core& thiscore(Cores[core]);
+		thiscore.IRQEnable = false;
+		thiscore.FxEnable = true;
+
+		if (thiscore.EffectsEndA >= 0x100000 || thiscore.EffectsStartA >= thiscore.EffectsEndA)
+		{
+			const u32 size = 0x8000;
+			thiscore.EffectsStartA = 0xE8000 + core * 0x10000;
+			thiscore.EffectsEndA = thiscore.EffectsStartA + size - 1;
+
+			V_Reverb& revb(thiscore.Revb);
+			u32* const taps[] = {
+				&revb.SAME_L_SRC, &revb.SAME_R_SRC, &revb.DIFF_L_SRC, &revb.DIFF_R_SRC,
+				&revb.SAME_L_DST, &revb.SAME_R_DST, &revb.DIFF_L_DST, &revb.DIFF_R_DST,
+				&revb.COMB1_L_SRC, &revb.COMB1_R_SRC, &revb.COMB2_L_SRC, &revb.COMB2_R_SRC,
+				&revb.COMB3_L_SRC, &revb.COMB3_R_SRC, &revb.COMB4_L_SRC, &revb.COMB4_R_SRC,
+				&revb.APF1_L_DST, &revb.APF1_R_DST, &revb.APF2_L_DST, &revb.APF2_R_DST};
+			for (u32* tap : taps)
+				*tap = random(size);
+			revb.APF1_SIZE = random(0x1000);
+			revb.APF2_SIZE = random(0x1000);
+
+			s16* const vols[] = {
+				&revb.IN_COEF_L, &revb.IN_COEF_R, &revb.IIR_VOL, &revb.WALL_VOL,
+				&revb.COMB1_VOL, &revb.COMB2_VOL, &revb.COMB3_VOL, &revb.COMB4_VOL,
+				&revb.APF1_VOL, &revb.APF2_VOL};
+			for (s16* vol : vols)
+				*vol = (s16)random(0x10000);
+
+			for (u32 i = 0; i < size; i++)
+				_spu2mem[thiscore.EffectsStartA + i] = (s16)random(0x10000);
+		}
+
+		thiscore.ReverbX = 0;
+		thiscore.RevBuffers.NeedsUpdated = true;
+	}
+	std::copy(Cores, Cores + 2, startCores.get());
+	memcpy(startMem.get(), _spu2mem, memSize);
+
+	double sec[2] = {0, 0};
+	s32 checksum[2];
+	bool match = true;
+
+	// Alternate the paths and keep the best of a few runs each.
+	for (int run = 0; run < 6; run++)
+	{
+		const int mode = run % 2;
+
+		std::copy(startCores.get(), startCores.get() + 2, Cores);
+		memcpy(_spu2mem, startMem.get(), memSize);
+		Cycles = 0;
+		VectorReverb = mode == 1;
+
+		s32 sum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (uint i = 0; i < samples; i++)
+		{
+			const s32 input = (s32)(i * 2654435761u) >> 14;
+
+			for (uint core = 0; core < 2; core++)
+			{
+				Cores[core].Reverb_AdvanceBuffer();
+				const StereoOut32 RV = Cores[core].DoReverb(StereoOut32(input, -input));
+				sum = sum * 31 + RV.Left + RV.Right;
+			}
+			Cycles++;
+		}
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (run < 2 || elapsed < sec[mode])
+			sec[mode] = elapsed;
+		checksum[mode] = sum;
+
+		if (run == 0)
+			memcpy(endMem.get(), _spu2mem, memSize);
+		else if (checksum[mode] != checksum[0] || memcmp(endMem.get(), _spu2mem, memSize) != 0)
+			match = false;
+	}
+
+	log_cb(match ? RETRO_LOG_INFO : RETRO_LOG_ERROR,
+		"Reverb benchmark: per-tap %.1fx realtime, vector %.1fx realtime%s%s\n",
+		samples / 48000.0 / sec[0], samples / 48000.0 / sec[1], x86caps.hasStreamingSIMD4Extensions ? "" : " (no SSE4.1, both per-tap)",
+		match ? "" : " (output MISMATCH)");
+
+	std::copy(savedCores.get(), savedCores.get() + 2, Cores);
+	memcpy(_spu2mem, savedMem.get(), memSize);
+	Cycles = savedCycles;
+	VectorReverb = savedVector;
+}
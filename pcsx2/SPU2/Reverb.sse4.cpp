@@ -0,0 +1,131 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// SSE4.1 build of V_Core::DoReverbVector, only called when x86caps reports SSE4.1.
+
+#include "PrecompiledHeader.h"
+#include "Global.h"
+
+#define MUL(x, y) ((x) * (y) >> 15)
+
+// The tap addresses of V_ReverbBuffers are declared in left/right pairs, so the taps of one
+// channel are every other field starting at SAME_L_SRC + R.  The diff source reads from the
+// opposite channel, which is why DIFF_R_SRC is declared before DIFF_L_SRC.
+static_assert(offsetof(V_ReverbBuffers, DIFF_L_SRC) == 3 * sizeof(s32), "Reverb taps are not paired");
+static_assert(offsetof(V_ReverbBuffers, APF2_R_SRC) == 27 * sizeof(s32), "Reverb taps are not paired");
+static_assert(sizeof(V_ReverbBuffers) >= 29 * sizeof(s32), "The last tap load reads one field past APF2_R_SRC");
+
+// Same as DoReverbSerial, with the 14 tap addresses computed and wrapped 4 at a time, the IRQ
+// test done against all of them at once, and the IIR and comb filters evaluated in SIMD lanes.
+StereoOut32 V_Core::DoReverbVector(const StereoOut32& Input)
+{
+	if (EffectsBufferSize <= 0)
+	{
+		return StereoOut32(0, 0);
+	}
+
+	const bool R = Cycles & 1;
+
+	// Tap order, 4 per vector (the last two are repeated to fill the vector):
+	//   same_src diff_src same_dst diff_dst | comb1_src comb2_src comb3_src comb4_src |
+	//   apf1_dst apf2_dst same_prv diff_prv | apf1_src apf2_src apf1_src apf2_src
+	enum
+	{
+		SameSrc, DiffSrc, SameDst, DiffDst,
+		Comb1Src, Comb2Src, Comb3Src, Comb4Src,
+		Apf1Dst, Apf2Dst, SamePrv, DiffPrv,
+		Apf1Src, Apf2Src,
+	};
+
+	const float* pairs = (const float*)&RevBuffers.SAME_L_SRC + R;
+	__m128i taps[4];
+	for (int i = 0; i < 4; i++)
+	{
+		const __m128 lo = _mm_loadu_ps(pairs + i * 8);
+		const __m128 hi = (i < 3) ? _mm_loadu_ps(pairs + i * 8 + 4) : lo;
+		taps[i] = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	// Single step wrapping of every tap, as in RevbGetIndexer.  The compare is unsigned.
+	const __m128i bias = _mm_set1_epi32(0x80000000);
+	const __m128i pos = _mm_set1_epi32(ReverbX);
+	const __m128i end = _mm_set1_epi32(EffectsEndA ^ 0x80000000);
+	const __m128i size = _mm_set1_epi32(EffectsEndA + 1 - EffectsStartA);
+
+	__aligned16 u32 addr[16];
+	for (int i = 0; i < 4; i++)
+	{
+		taps[i] = _mm_add_epi32(taps[i], pos);
+		const __m128i wrap = _mm_cmpgt_epi32(_mm_xor_si128(taps[i], bias), end);
+		taps[i] = _mm_sub_epi32(taps[i], _mm_and_si128(wrap, size));
+		_mm_store_si128((__m128i*)&addr[i * 4], taps[i]);
+	}
+
+	// See DoReverbSerial for the effects area shortcut.
+	for (int i = 0; i < 2; i++)
+	{
+		if (Cores[i].IRQEnable && ((Cores[i].IRQA >= EffectsStartA) && (Cores[i].IRQA <= EffectsEndA)))
+		{
+			const __m128i irqa = _mm_set1_epi32(Cores[i].IRQA);
+			const __m128i hit = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi32(taps[0], irqa), _mm_cmpeq_epi32(taps[1], irqa)),
+				_mm_or_si128(_mm_cmpeq_epi32(taps[2], irqa), _mm_cmpeq_epi32(taps[3], irqa)));
+
+			if (_mm_movemask_epi8(hit))
+				SetIrqCall(i);
+		}
+	}
+
+	const s32 in = MUL(R ? Revb.IN_COEF_R : Revb.IN_COEF_L, R ? Input.Right : Input.Left);
+
+	// The same and diff IIR filters, in lanes 0 and 1.
+	const __m128i src = _mm_setr_epi32(_spu2mem[addr[SameSrc]], _spu2mem[addr[DiffSrc]], 0, 0);
+	const __m128i prv = _mm_setr_epi32(_spu2mem[addr[SamePrv]], _spu2mem[addr[DiffPrv]], 0, 0);
+	__m128i iir = _mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(Revb.WALL_VOL), src), 15);
+	iir = _mm_sub_epi32(_mm_add_epi32(_mm_set1_epi32(in), iir), prv);
+	iir = _mm_add_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(Revb.IIR_VOL), iir), 15), prv);
+
+	const __m128i comb = _mm_setr_epi32(_spu2mem[addr[Comb1Src]], _spu2mem[addr[Comb2Src]], _spu2mem[addr[Comb3Src]], _spu2mem[addr[Comb4Src]]);
+	const __m128i combVol = _mm_setr_epi32(Revb.COMB1_VOL, Revb.COMB2_VOL, Revb.COMB3_VOL, Revb.COMB4_VOL);
+	__m128i sum = _mm_srai_epi32(_mm_mullo_epi32(comb, combVol), 15);
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	s32 out = _mm_cvtsi128_si32(sum);
+
+	// The all-pass filters depend on each other.
+	const s32 apf1_in = _spu2mem[addr[Apf1Src]];
+	const s32 apf2_in = _spu2mem[addr[Apf2Src]];
+	const s32 apf1 = out - MUL(Revb.APF1_VOL, apf1_in);
+	out = apf1_in + MUL(Revb.APF1_VOL, apf1);
+	const s32 apf2 = out - MUL(Revb.APF2_VOL, apf2_in);
+	out = apf2_in + MUL(Revb.APF2_VOL, apf2);
+
+	if (FxEnable)
+	{
+		// Saturating to 16 bits is clamp_mix.
+		__aligned16 s16 result[8];
+		_mm_store_si128((__m128i*)result, _mm_packs_epi32(_mm_unpacklo_epi64(iir, _mm_setr_epi32(apf1, apf2, 0, 0)), _mm_setzero_si128()));
+
+		_spu2mem[addr[SameDst]] = result[0];
+		_spu2mem[addr[DiffDst]] = result[1];
+		_spu2mem[addr[Apf1Dst]] = result[2];
+		_spu2mem[addr[Apf2Dst]] = result[3];
+	}
+
+	(R ? LastEffect.Right : LastEffect.Left) = -clamp_mix(out);
+
+	return LastEffect;
+}
+
@@ -47,6 +47,11 @@ struct V_VolumeLR
 	}
 };
 
+#define VOLFLAG_REVERSE_PHASE (1ul << 0)
+#define VOLFLAG_DECREMENT (1ul << 1)
+#define VOLFLAG_EXPONENTIAL (1ul << 2)
+#define VOLFLAG_SLIDE_ENABLE (1ul << 3)
+
 struct V_VolumeSlide
 {
 	// Holds the "original" value of the volume for this voice, prior to slides.
@@ -88,8 +93,12 @@ public:
 
 	void Update()
 	{
-		Left.Update();
-		Right.Update();
+		// Most games don't use volume slides, skip the calls in the common case.
+		if ((Left.Mode | Right.Mode) & VOLFLAG_SLIDE_ENABLE)
+		{
+			Left.Update();
+			Right.Update();
+		}
 	}
 };
 
@@ -448,6 +457,8 @@ struct V_Core
 	StereoOut32 Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext);
 	void Reverb_AdvanceBuffer();
 	StereoOut32 DoReverb(const StereoOut32& Input);
+	StereoOut32 DoReverbSerial(const StereoOut32& Input);
+	StereoOut32 DoReverbVector(const StereoOut32& Input);
 	s32 RevbGetIndexer(s32 offset);
 
 	StereoOut32 ReadInput();
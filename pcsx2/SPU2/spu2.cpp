@@ -21,6 +21,7 @@
 #include "R3000A.h"
 #include "Utilities/pxStreams.h"
 #include "AppCoreThread.h"
+#include "options_tools.h"
 
 using namespace Threading;
 
@@ -31,6 +32,7 @@ extern retro_audio_sample_t sample_cb;
 int Interpolation = 4;
 bool EffectsDisabled = false;
 bool postprocess_filter_dealias = false;
+bool BlockMixing = true;
 unsigned int delayCycles = 4;
 
 int SampleRate = 48000;
@@ -162,6 +164,7 @@ void ReadSettings()
    Interpolation = 4;
 	EffectsDisabled = false;
 	postprocess_filter_dealias = false;
+	BlockMixing = option_value(BOOL_PCSX2_OPT_SPU2_BLOCK_MIXING, KeyOptionBool::return_type);
 	VolumeAdjustCdb = 0;
 	VolumeAdjustFLdb = 0;
 	VolumeAdjustFRdb = 0;
@@ -25,6 +25,7 @@
 #include "Dma.h"
 #include "IopDma.h"
 
+#include "FrameTelemetry.h"
 #include "spu2.h" // needed until I figure out a nice solution for irqcallback dependencies.
 
 s16* spu2regs = nullptr;
@@ -49,6 +50,9 @@ void SetIrqCall(int core)
 	// test programs that bizarrely only fired one interrupt
 	if (Spdif.Info & 4 << core)
 		return;
+	// Voices mixed ahead raise their IRQ once Mix() gets to that tick.
+	if (MixBlockIrq(core))
+		return;
 	Spdif.Info |= 4 << core;
 	has_to_call_irq = true;
 }
@@ -363,6 +367,9 @@ __forceinline void TimeUpdate(u32 cClocks)
 		dClocks = TickInterval * SanityInterval;
 		lClocks = cClocks - dClocks;
 	}
+
+	ScopedFrameTimer mix_time(FrameTimer_SPU2, dClocks >= TickInterval);
+
 	//Update Mixing Progress
 	while (dClocks >= TickInterval)
 	{
@@ -417,6 +424,19 @@ __forceinline void TimeUpdate(u32 cClocks)
 		lClocks += TickInterval;
 		Cycles++;
 
+		if (BlockMixing)
+		{
+			// The block has to end before a DMA read completes, it could read voice output
+			// that was mixed ahead.
+			uint ticks = dClocks / TickInterval + 1;
+			for (int i = 0; i < 2; i++)
+			{
+				if (Cores[i].DMAICounter > 0 && Cores[i].IsDMARead)
+					ticks = std::min<uint>(ticks, (Cores[i].DMAICounter + TickInterval - 1) / TickInterval);
+			}
+			MixBlock(ticks);
+		}
+
 		// Note: IOP does not use MMX regs, so no need to save them.
 		//SaveMMXRegs();
 		Mix();
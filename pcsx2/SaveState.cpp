@@ -177,7 +177,7 @@ SaveStateBase& SaveStateBase::FreezeInternals()
 		log_cb(RETRO_LOG_WARN, "MTVU speedhack is enabled, saved states may not be stable\n");
 #endif
 	
-	if (IsLoading()) PreLoadPrep();
+	if (IsLoading() && !IsSnapshot()) PreLoadPrep();
 
 	// Second Block - Various CPU Registers and States
 	// -----------------------------------------------
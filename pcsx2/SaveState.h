@@ -126,6 +126,10 @@ public:
 	// Returns true if this object is a StateSaving type object.
 	virtual bool IsSaving() const=0;
 
+	// Returns true for in-process snapshots, which are loaded into the running machine and
+	// invalidate recompiled code themselves instead of resetting the recompilers.
+	virtual bool IsSnapshot() const { return false; }
+
 public:
 	// note: gsFreeze() needs to be public because of the GSState recorder.
 	void gsFreeze();
@@ -204,3 +208,6 @@ public:
 	bool IsFinished() const { return m_idx >= m_memory->GetSizeInBytes(); }
 };
 
+// Compresses and decompresses the running state in memory with each codec the build has,
+// logging sizes and times.  The machine must be held (SnapshotHoldMachine).
+extern void SaveStateCompressionBenchmark();
@@ -0,0 +1,258 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "IopCommon.h"
+#include "SaveState.h"
+
+#include "GS.h"
+#include "VUmicro.h"
+#include "MTVU.h"
+#include "SPU2/spu2.h"
+
+#include "Utilities/SafeArray.inl"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <zlib.h>
+#ifdef PCSX2_ZSTD
+#include <zstd.h>
+#endif
+
+// Measures what compressing a savestate costs: the running state is split into 1MB chunks
+// that are compressed and decompressed independently, on one thread and on all cores, in
+// memory.  Nothing is written, the libretro frontend owns savestate files.
+
+static const size_t StateChunkSize = _1mb;
+
+enum class StateCodec
+{
+	Deflate, // zlib at its fastest level
+	Zstd,    // level 1, only in PCSX2_ZSTD builds
+};
+
+struct StateSection
+{
+	const char* name;
+	const u8* data;
+	size_t size;
+};
+
+// Freezing the internals has WaitGS sync the MTGS copy of the GS registers from the EE's,
+// which would show up on screen before the next vsync mails them in (see CaptureSnapshot).
+class ScopedRingRegs
+{
+	u8 m_regs[sizeof(RingBuffer.Regs)];
+
+public:
+	ScopedRingRegs() { memcpy(m_regs, RingBuffer.Regs, sizeof(m_regs)); }
+	~ScopedRingRegs() { memcpy(RingBuffer.Regs, m_regs, sizeof(m_regs)); }
+};
+
+// Runs func(t) for t in [0, threads) with thread 0 being the caller.
+template <typename Func>
+static void StateParallel(uint threads, const Func& func)
+{
+	std::vector<std::thread> workers;
+	for (uint t = 1; t < threads; t++)
+		workers.emplace_back(func, t);
+	func(0);
+	for (std::thread& t : workers)
+		t.join();
+}
+
+// Compresses every chunk of the sections, then decompresses them again and compares.
+// Returns false if a chunk failed either way or didn't come back the same.
+static bool RunStateCodec(StateCodec codec, uint threads, const std::vector<StateSection>& sections,
+	u64& packed, double& pack_ms, double& unpack_ms)
+{
+	typedef std::chrono::steady_clock clock;
+
+	struct Chunk
+	{
+		const u8* src;
+		size_t size;
+		std::vector<u8> packed;
+		std::vector<u8> unpacked;
+		bool ok;
+	};
+
+	std::vector<Chunk> chunks;
+	for (const StateSection& section : sections)
+	{
+		for (size_t offset = 0; offset < section.size; offset += StateChunkSize)
+			chunks.push_back({section.data + offset, std::min(StateChunkSize, section.size - offset), {}, {}, true});
+	}
+
+	// Chunks are independent, thread t handles chunks t, t + threads, ...
+	auto start = clock::now();
+	StateParallel(threads, [&](uint t) {
+#ifdef PCSX2_ZSTD
+		ZSTD_CCtx* cctx = codec == StateCodec::Zstd ? ZSTD_createCCtx() : nullptr;
+		if (cctx)
+			ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, 1);
+#endif
+		for (size_t i = t; i < chunks.size(); i += threads)
+		{
+			Chunk& chunk = chunks[i];
+			if (codec == StateCodec::Deflate)
+			{
+				uLongf len = compressBound(chunk.size);
+				chunk.packed.resize(len);
+				chunk.ok = compress2(chunk.packed.data(), &len, chunk.src, chunk.size, Z_BEST_SPEED) == Z_OK;
+				chunk.packed.resize(len);
+			}
+#ifdef PCSX2_ZSTD
+			else
+			{
+				chunk.packed.resize(ZSTD_compressBound(chunk.size));
+				const size_t len = cctx ? ZSTD_compress2(cctx, chunk.packed.data(), chunk.packed.size(), chunk.src, chunk.size) : 0;
+				chunk.ok = cctx && !ZSTD_isError(len);
+				chunk.packed.resize(chunk.ok ? len : 0);
+			}
+		}
+		ZSTD_freeCCtx(cctx);
+#else
+		}
+#endif
+	});
+	pack_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	start = clock::now();
+	StateParallel(threads, [&](uint t) {
+#ifdef PCSX2_ZSTD
+		ZSTD_DCtx* dctx = codec == StateCodec::Zstd ? ZSTD_createDCtx() : nullptr;
+#endif
+		for (size_t i = t; i < chunks.size(); i += threads)
+		{
+			Chunk& chunk = chunks[i];
+			chunk.unpacked.resize(chunk.size);
+			if (codec == StateCodec::Deflate)
+			{
+				uLongf len = chunk.size;
+				chunk.ok &= uncompress(chunk.unpacked.data(), &len, chunk.packed.data(), chunk.packed.size()) == Z_OK && len == chunk.size;
+			}
+#ifdef PCSX2_ZSTD
+			else
+			{
+				chunk.ok &= dctx && ZSTD_decompressDCtx(dctx, chunk.unpacked.data(), chunk.size, chunk.packed.data(), chunk.packed.size()) == chunk.size;
+			}
+		}
+		ZSTD_freeDCtx(dctx);
+#else
+		}
+#endif
+	});
+	unpack_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	bool ok = true;
+	packed = 0;
+	for (const Chunk& chunk : chunks)
+	{
+		ok &= chunk.ok && memcmp(chunk.unpacked.data(), chunk.src, chunk.size) == 0;
+		packed += chunk.packed.size();
+	}
+	return ok;
+}
+
+// Runs on the frontend (MTGS) thread with the machine held at a vsync (SnapshotHoldMachine).
+void SaveStateCompressionBenchmark()
+{
+	typedef std::chrono::steady_clock clock;
+	auto ms = [](clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+
+	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+
+	// Emulated memory is compressed where it lives, CPU and subsystem state is frozen into a
+	// memory blob first, the GS (with VRAM) and SPU2 (with its RAM) through their freeze calls.
+	std::vector<StateSection> sections = {
+		{"ee.ram", eeMem->Main, Ps2MemSize::MainRam},
+		{"ee.scratch", eeMem->Scratch, Ps2MemSize::Scratch},
+		{"ee.hw", eeHw, Ps2MemSize::Hardware},
+		{"iop.ram", iopMem->Main, Ps2MemSize::IopRam},
+		{"iop.hw", iopHw, Ps2MemSize::IopHardware},
+		{"vu0.micro", vuRegs[0].Micro, VU0_PROGSIZE},
+		{"vu0.mem", vuRegs[0].Mem, VU0_MEMSIZE},
+		{"vu1.micro", vuRegs[1].Micro, VU1_PROGSIZE},
+		{"vu1.mem", vuRegs[1].Mem, VU1_MEMSIZE},
+	};
+
+	auto start = clock::now();
+
+	ScopedRingRegs regs;
+	VmStateBuffer internals(L"Savestate benchmark");
+	memSavingState state(internals);
+	state.MakeRoomForData();
+	state.FreezeBios();
+	state.FreezeInternals();
+	sections.push_back({"internals", internals.GetPtr(), (size_t)state.GetCurrentPos()});
+
+	// The MTGS is this thread, the GS is frozen directly instead of through the ring.
+	std::vector<s8> gs;
+	freezeData fd = {0, nullptr};
+	if (GSfreeze(FREEZE_SIZE, &fd) == 0 && fd.size > 0)
+	{
+		gs.resize(fd.size);
+		fd.data = gs.data();
+		if (GSfreeze(FREEZE_SAVE, &fd) == 0)
+			sections.push_back({"gs", (const u8*)gs.data(), gs.size()});
+	}
+
+	std::vector<s8> spu2;
+	{
+		ScopedLock lock(mtx_SPU2Status);
+		fd = {0, nullptr};
+		if (SPU2freeze(FREEZE_SIZE, &fd) == 0 && fd.size > 0)
+		{
+			spu2.resize(fd.size);
+			fd.data = spu2.data();
+			if (SPU2freeze(FREEZE_SAVE, &fd) == 0)
+				sections.push_back({"spu2", (const u8*)spu2.data(), spu2.size()});
+		}
+	}
+
+	u64 raw = 0;
+	for (const StateSection& section : sections)
+		raw += section.size;
+
+	log_cb(RETRO_LOG_INFO, "Savestate benchmark: %llu bytes in %u sections, freezing the non-memory ones took %.1f ms\n",
+		(unsigned long long)raw, (uint)sections.size(), ms(start));
+
+	const StateCodec codecs[] = {
+		StateCodec::Deflate,
+#ifdef PCSX2_ZSTD
+		StateCodec::Zstd,
+#endif
+	};
+	const uint thread_counts[] = {1, std::max<uint>(std::thread::hardware_concurrency(), 1)};
+
+	for (StateCodec codec : codecs)
+	{
+		for (uint threads : thread_counts)
+		{
+			u64 packed;
+			double pack_ms, unpack_ms;
+			const bool ok = RunStateCodec(codec, threads, sections, packed, pack_ms, unpack_ms);
+
+			log_cb(ok ? RETRO_LOG_INFO : RETRO_LOG_ERROR,
+				"Savestate benchmark: %-7s %2u thread(s), %llu -> %llu bytes (%.1f%%), compress %.1f ms (%.0f MB/s), decompress %.1f ms (%.0f MB/s)%s\n",
+				codec == StateCodec::Deflate ? "deflate" : "zstd", threads, (unsigned long long)raw, (unsigned long long)packed, 100.0 * packed / raw,
+				pack_ms, raw / 1048576.0 / (pack_ms / 1000.0), unpack_ms, raw / 1048576.0 / (unpack_ms / 1000.0), ok ? "" : ", MISMATCH");
+		}
+	}
+}
@@ -0,0 +1,651 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "IopCommon.h"
+#include "SaveState.h"
+#include "SaveStateSnapshot.h"
+
+#include "GS.h"
+#include "COP0.h"
+#include "VUmicro.h"
+#include "MTVU.h"
+#include "SPU2/spu2.h"
+
+#include "Utilities/SafeArray.inl"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------------------
+//  Lockstep
+// --------------------------------------------------------------------------------------
+// The EE parks at the start of a vsync until the frontend hands out a permit for the frame.
+// Parked there the ring holds no vsync the MTGS still has to present, recompiled code is
+// not on the EE's stack and everything the vsync does is read from the state after the
+// EE wakes up, so the state can be captured and replaced under it.
+
+static std::atomic<bool> s_lockstep(false);
+static std::mutex s_park_lock;
+static std::condition_variable s_park_cv;
+static bool s_parked = false;
+static bool s_permit = false;
+
+void SetSnapshotLockstep(bool enabled)
+{
+	if (s_lockstep.exchange(enabled) == enabled)
+		return;
+
+	if (!enabled)
+	{
+		std::lock_guard<std::mutex> lock(s_park_lock);
+		s_park_cv.notify_all();
+	}
+	log_cb(RETRO_LOG_INFO, "Run-ahead snapshots: %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool GetSnapshotLockstep()
+{
+	return s_lockstep.load(std::memory_order_relaxed);
+}
+
+void SnapshotVsyncInThread()
+{
+	if (!s_lockstep.load(std::memory_order_relaxed))
+		return;
+
+	std::unique_lock<std::mutex> lock(s_park_lock);
+	s_parked = true;
+	s_park_cv.notify_all();
+
+	// Polled so a suspend or shutdown never has to know about us.
+	while (!s_permit && s_lockstep.load(std::memory_order_relaxed) && !GetCoreThread().HasPendingStateChangeRequest())
+		s_park_cv.wait_for(lock, std::chrono::milliseconds(1));
+
+	s_permit = false;
+	s_parked = false;
+}
+
+void SnapshotBeginFrame()
+{
+	if (!s_lockstep.load(std::memory_order_relaxed))
+		return;
+
+	// One vsync per frame: with one already queued (lockstep was just enabled) the MTGS
+	// presents that one, and the EE stays where it is.
+	std::lock_guard<std::mutex> lock(s_park_lock);
+	if (GetMTGS().m_QueuedFrameCount.load(std::memory_order_acquire) == 0)
+	{
+		s_permit = true;
+		s_park_cv.notify_all();
+	}
+}
+
+// Waits for the EE to park and has the GS and VU1 catch up with it.  The MTGS has to keep
+// draining meanwhile, the EE might be stalled on a full ring on its way to the vsync.
+bool SnapshotHoldMachine()
+{
+	if (!s_lockstep.load(std::memory_order_relaxed))
+		return false;
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+	for (;;)
+	{
+		GetMTGS().DrainInThread();
+		{
+			std::unique_lock<std::mutex> lock(s_park_lock);
+			if (s_park_cv.wait_for(lock, std::chrono::milliseconds(1), [] { return s_parked; }))
+				break;
+		}
+
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			log_cb(RETRO_LOG_WARN, "Run-ahead snapshots: the EE did not stop at a vsync\n");
+			return false;
+		}
+	}
+
+	// MTVU kicks are handed to the GS by the MTGS, so it has to drain while VU1 finishes.
+	while (!vu1Thread.IsDone())
+	{
+		GetMTGS().DrainInThread();
+		std::this_thread::yield();
+	}
+	vu1Thread.WaitVU();
+	GetMTGS().DrainInThread();
+
+	SysMtgsThread& mtgs = GetMTGS();
+	return mtgs.m_QueuedFrameCount.load(std::memory_order_acquire) == 0 &&
+		mtgs.m_ReadPos.load(std::memory_order_relaxed) == mtgs.m_WritePos.load(std::memory_order_acquire);
+}
+
+// --------------------------------------------------------------------------------------
+//  Written page tracking
+// --------------------------------------------------------------------------------------
+// Soft-dirty bits: clearing them write protects every page of the process, and the first
+// write to a page afterwards marks it in /proc/self/pagemap.  Clearing is process wide, so
+// a single epoch counter tells whether the bits still describe changes since a snapshot
+// was last in sync with memory.
+
+static u64 s_dirty_epoch = 0;
+
+#if defined(__linux__)
+
+static int s_pagemap_fd = -1;
+static int s_clear_refs_fd = -1;
+static uptr s_host_pagesize = 0;
+
+static const u64 PagemapSoftDirty = 1ull << 55;
+
+static bool ClearSoftDirty()
+{
+	if (write(s_clear_refs_fd, "4", 1) != 1)
+		return false;
+	s_dirty_epoch++;
+	return true;
+}
+
+// One entry per host page overlapping [ptr, ptr + size).
+static bool ReadPagemap(const void* ptr, size_t size, std::vector<u64>& entries)
+{
+	const uptr first = (uptr)ptr / s_host_pagesize;
+	const uptr last = ((uptr)ptr + size - 1) / s_host_pagesize;
+	entries.resize(last - first + 1);
+
+	const size_t bytes = entries.size() * sizeof(u64);
+	return pread(s_pagemap_fd, entries.data(), bytes, first * sizeof(u64)) == (ssize_t)bytes;
+}
+
+static bool ProbeSoftDirty()
+{
+	s_host_pagesize = sysconf(_SC_PAGESIZE);
+	s_pagemap_fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+	s_clear_refs_fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+	if (s_pagemap_fd < 0 || s_clear_refs_fd < 0)
+		return false;
+
+	// Kernels without CONFIG_MEM_SOFT_DIRTY accept the clear but never set the bit.
+	volatile u8* page = (volatile u8*)mmap(NULL, s_host_pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (page == MAP_FAILED)
+		return false;
+
+	std::vector<u64> entry;
+	page[0] = 1;
+	bool works = ClearSoftDirty() && ReadPagemap((void*)page, 1, entry) && !(entry[0] & PagemapSoftDirty);
+	page[0] = 2;
+	works = works && ReadPagemap((void*)page, 1, entry) && (entry[0] & PagemapSoftDirty);
+	munmap((void*)page, s_host_pagesize);
+
+	return works;
+}
+
+static std::vector<u64> s_view_pagemap;
+
+// Writes through the fastmem window mark the window's pages, not the reserve's: ORs the bits
+// of every view of [ptr, ptr + size) into its entries, as read by ReadPagemap.
+static bool MergeFastmemPagemap(const u8* ptr, u32 size, std::vector<u64>& entries)
+{
+	const uptr first = (uptr)ptr / s_host_pagesize;
+	const uptr base = ptr - (u8*)eeMem;
+	for (const vtlbFastmemView& view : vtlb_GetFastmemViews())
+	{
+		const uptr start = std::max<uptr>(view.offset, base);
+		const uptr end = std::min<uptr>((uptr)view.offset + view.size, base + size);
+		if (start >= end)
+			continue;
+
+		const u8* window = vtlb_private::vtlbdata.fastmem_base + view.vaddr + (start - view.offset);
+		const u8* target = ptr + (start - base);
+		if ((uptr)window % s_host_pagesize != (uptr)target % s_host_pagesize || !ReadPagemap(window, end - start, s_view_pagemap))
+			return false;
+
+		const uptr dest = (uptr)target / s_host_pagesize - first;
+		for (size_t i = 0; i < s_view_pagemap.size(); i++)
+			entries[dest + i] |= s_view_pagemap[i] & PagemapSoftDirty;
+	}
+	return true;
+}
+
+#else
+
+static bool ClearSoftDirty()
+{
+	return false;
+}
+
+static bool ReadPagemap(const void* ptr, size_t size, std::vector<u64>& entries)
+{
+	return false;
+}
+
+static bool MergeFastmemPagemap(const u8* ptr, u32 size, std::vector<u64>& entries)
+{
+	return false;
+}
+
+static bool ProbeSoftDirty()
+{
+	return false;
+}
+
+#endif
+
+static bool SoftDirtyAvailable()
+{
+	static const bool available = ProbeSoftDirty();
+	return available;
+}
+
+// --------------------------------------------------------------------------------------
+//  Snapshot
+// --------------------------------------------------------------------------------------
+
+static const uint SnapshotPageSize = __pagesize;
+
+enum class SnapshotInvalidate
+{
+	None,
+	EERam,
+	Scratch,
+	IopRam,
+	VU0Micro,
+	VU1Micro,
+};
+
+struct SnapshotRegion
+{
+	u8* ptr;
+	u32 size;
+	bool fastmem; // also mapped in the fastmem window, whose writes mark the window's pages
+	SnapshotInvalidate invalidate;
+};
+
+// Same memory as FreezeMainMemory.
+static std::vector<SnapshotRegion> GetSnapshotRegions()
+{
+	return {
+		{eeMem->Main, Ps2MemSize::MainRam, true, SnapshotInvalidate::EERam},
+		{eeMem->Scratch, Ps2MemSize::Scratch, true, SnapshotInvalidate::Scratch},
+		{eeHw, Ps2MemSize::Hardware, false, SnapshotInvalidate::None},
+		{iopMem->Main, Ps2MemSize::IopRam, false, SnapshotInvalidate::IopRam},
+		{iopHw, Ps2MemSize::IopHardware, false, SnapshotInvalidate::None},
+		{vuRegs[0].Micro, VU0_PROGSIZE, false, SnapshotInvalidate::VU0Micro},
+		{vuRegs[0].Mem, VU0_MEMSIZE, false, SnapshotInvalidate::None},
+		{vuRegs[1].Micro, VU1_PROGSIZE, false, SnapshotInvalidate::VU1Micro},
+		{vuRegs[1].Mem, VU1_MEMSIZE, false, SnapshotInvalidate::None},
+	};
+}
+
+// Snapshot memory is written behind the back of the cpus, any code they compiled from a
+// page that changes has to go.
+static void InvalidatePage(const SnapshotRegion& region, u32 offset)
+{
+	switch (region.invalidate)
+	{
+		case SnapshotInvalidate::EERam:
+			mmap_ClearRamPage(offset);
+			break;
+		case SnapshotInvalidate::Scratch:
+			Cpu->Clear(0x70000000 + offset, SnapshotPageSize / 4);
+			break;
+		case SnapshotInvalidate::IopRam:
+			psxCpu->Clear(offset, SnapshotPageSize / 4);
+			break;
+		case SnapshotInvalidate::VU0Micro:
+			CpuVU0->Clear(offset, SnapshotPageSize);
+			break;
+		case SnapshotInvalidate::VU1Micro:
+			CpuVU1->Clear(offset, SnapshotPageSize);
+			break;
+		default:
+			break;
+	}
+}
+
+// Restored on top of the running machine: FreezeInternals skips the recompiler reset.
+class snapshotLoadingState : public memLoadingState
+{
+public:
+	snapshotLoadingState(const VmStateBuffer& load_from)
+		: memLoadingState(load_from)
+	{
+	}
+
+	bool IsSnapshot() const { return true; }
+};
+
+struct SaveStateSnapshot
+{
+	std::vector<std::vector<u8>> memory; // one copy per region of GetSnapshotRegions
+	std::unique_ptr<VmStateBuffer> internals;
+	uint internals_size;
+	std::vector<s8> gs;
+	std::vector<s8> spu2;
+	u8 gs_regs[Ps2MemSize::GSregs];
+
+	u64 id;
+	u64 epoch; // soft-dirty epoch at which memory matched the machine, 0 for never
+};
+
+static SaveStateSnapshot s_snapshot = {};
+static u64 s_snapshot_next_id = 1;
+static std::vector<u64> s_pagemap;
+static uint s_pages_copied = 0;
+static double s_clear_ms = 0;
+static double s_pagemap_ms = 0;
+
+// The snapshot is now in sync with memory.  The clear walks the page tables of the whole
+// process, and afterwards the first write of any thread to any page takes a fault.
+static void ResyncDirtyEpoch()
+{
+	const auto start = std::chrono::steady_clock::now();
+	s_snapshot.epoch = (SoftDirtyAvailable() && ClearSoftDirty()) ? s_dirty_epoch : 0;
+	s_clear_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Calls func(offset) for every page of region that may differ from a copy which was in
+// sync at epoch; every page unless the soft-dirty bits go back that far.
+template <typename Func>
+static void ForEachCandidatePage(const SnapshotRegion& region, u64 epoch, Func func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const bool tracked = epoch != 0 && epoch == s_dirty_epoch &&
+		ReadPagemap(region.ptr, region.size, s_pagemap) &&
+		(!region.fastmem || MergeFastmemPagemap(region.ptr, region.size, s_pagemap));
+	s_pagemap_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (!tracked)
+	{
+		for (u32 offset = 0; offset < region.size; offset += SnapshotPageSize)
+			func(offset);
+		return;
+	}
+
+#if defined(__linux__)
+	const uptr first = (uptr)region.ptr / s_host_pagesize;
+	for (u32 offset = 0; offset < region.size; offset += SnapshotPageSize)
+	{
+		const uptr start = (uptr)region.ptr + offset;
+		const uptr end = start + std::min(SnapshotPageSize, region.size - offset) - 1;
+		for (uptr page = start / s_host_pagesize; page <= end / s_host_pagesize; page++)
+		{
+			if (s_pagemap[page - first] & PagemapSoftDirty)
+			{
+				func(offset);
+				break;
+			}
+		}
+	}
+#endif
+}
+
+// Only EE memory has views in the fastmem window, and only while it is on.
+static void UpdateFastmemTracking(std::vector<SnapshotRegion>& regions)
+{
+	if (!vtlb_private::vtlbdata.fastmem_base)
+	{
+		for (SnapshotRegion& region : regions)
+			region.fastmem = false;
+	}
+}
+
+static void CaptureMemory()
+{
+	std::vector<SnapshotRegion> regions = GetSnapshotRegions();
+	UpdateFastmemTracking(regions);
+
+	if (s_snapshot.memory.size() != regions.size())
+	{
+		s_snapshot.memory.resize(regions.size());
+		s_snapshot.epoch = 0;
+	}
+
+	s_pages_copied = 0;
+	s_pagemap_ms = 0;
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		const SnapshotRegion& region = regions[i];
+		std::vector<u8>& copy = s_snapshot.memory[i];
+		if (copy.size() != region.size)
+		{
+			copy.resize(region.size);
+			s_snapshot.epoch = 0;
+		}
+
+		ForEachCandidatePage(region, s_snapshot.epoch, [&](u32 offset) {
+			memcpy(&copy[offset], region.ptr + offset, std::min(SnapshotPageSize, region.size - offset));
+			s_pages_copied++;
+		});
+	}
+
+	ResyncDirtyEpoch();
+}
+
+static void RestoreMemory()
+{
+	std::vector<SnapshotRegion> regions = GetSnapshotRegions();
+	UpdateFastmemTracking(regions);
+
+	s_pages_copied = 0;
+	s_pagemap_ms = 0;
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		const SnapshotRegion& region = regions[i];
+		const std::vector<u8>& copy = s_snapshot.memory[i];
+
+		// A page written with what it already held needs neither the copy nor the clear.
+		ForEachCandidatePage(region, s_snapshot.epoch, [&](u32 offset) {
+			const u32 size = std::min(SnapshotPageSize, region.size - offset);
+			if (memcmp(region.ptr + offset, &copy[offset], size) == 0)
+				return;
+			InvalidatePage(region, offset);
+			memcpy(region.ptr + offset, &copy[offset], size);
+			s_pages_copied++;
+		});
+	}
+
+	ResyncDirtyEpoch();
+}
+
+u64 CaptureSnapshot()
+{
+	if (!SnapshotHoldMachine())
+		return 0;
+
+	s_snapshot.id = 0;
+	CaptureMemory();
+
+	// WaitGS syncs the MTGS copy of the GS registers from the EE's, which would show
+	// up on screen before the next vsync mails them in.
+	memcpy(s_snapshot.gs_regs, RingBuffer.Regs, sizeof(s_snapshot.gs_regs));
+	{
+		if (!s_snapshot.internals)
+			s_snapshot.internals = std::make_unique<VmStateBuffer>(L"Snapshot internals");
+		memSavingState state(*s_snapshot.internals);
+		state.MakeRoomForData();
+		state.FreezeInternals();
+		s_snapshot.internals_size = state.GetCurrentPos();
+	}
+	memcpy(RingBuffer.Regs, s_snapshot.gs_regs, sizeof(s_snapshot.gs_regs));
+
+	// The MTGS is this thread, the GS is frozen directly instead of through the ring.
+	freezeData fd = {0, nullptr};
+	if (GSfreeze(FREEZE_SIZE, &fd) != 0 || fd.size <= 0)
+		return 0;
+	s_snapshot.gs.resize(fd.size);
+	fd.data = s_snapshot.gs.data();
+	if (GSfreeze(FREEZE_SAVE, &fd) != 0)
+	{
+		log_cb(RETRO_LOG_ERROR, "GS: Error saving snapshot!\n");
+		return 0;
+	}
+
+	{
+		ScopedLock lock(mtx_SPU2Status);
+		fd = {0, nullptr};
+		if (SPU2freeze(FREEZE_SIZE, &fd) != 0 || fd.size <= 0)
+			return 0;
+		s_snapshot.spu2.resize(fd.size);
+		fd.data = s_snapshot.spu2.data();
+		if (SPU2freeze(FREEZE_SAVE, &fd) != 0)
+		{
+			log_cb(RETRO_LOG_ERROR, "SPU2: Error saving snapshot!\n");
+			return 0;
+		}
+	}
+
+	s_snapshot.id = s_snapshot_next_id++;
+	return s_snapshot.id;
+}
+
+bool RestoreSnapshot(u64 id)
+{
+	if (!id || id != s_snapshot.id || !SnapshotHoldMachine())
+		return false;
+
+	// PostLoadPrep maps the restored TLB, what the current one maps has to go first.
+	for (int i = 0; i < 48; i++)
+		UnmapTLB(i);
+
+	RestoreMemory();
+
+	{
+		snapshotLoadingState state(*s_snapshot.internals);
+		state.FreezeInternals();
+	}
+	memcpy(RingBuffer.Regs, s_snapshot.gs_regs, sizeof(s_snapshot.gs_regs));
+
+	freezeData fd = {(int)s_snapshot.gs.size(), s_snapshot.gs.data()};
+	if (GSfreeze(FREEZE_LOAD, &fd) != 0)
+		log_cb(RETRO_LOG_ERROR, "GS: Error loading snapshot!\n");
+
+	{
+		ScopedLock lock(mtx_SPU2Status);
+		fd = {(int)s_snapshot.spu2.size(), s_snapshot.spu2.data()};
+		if (SPU2freeze(FREEZE_LOAD, &fd) != 0)
+			log_cb(RETRO_LOG_ERROR, "SPU2: Error loading snapshot!\n");
+	}
+
+	return true;
+}
+
+void DiscardSnapshot()
+{
+	s_snapshot.id = 0;
+	s_snapshot.epoch = 0;
+}
+
+void SaveStateSnapshotBenchmark(int iterations)
+{
+	typedef std::chrono::steady_clock clock;
+	auto ms = [](clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+
+	const bool tracking = SoftDirtyAvailable();
+	log_cb(RETRO_LOG_INFO, "Snapshot benchmark: soft-dirty tracking %s, fastmem %s\n",
+		tracking ? "available" : "unavailable (Linux with CONFIG_MEM_SOFT_DIRTY only)", vtlb_private::vtlbdata.fastmem_base ? "enabled" : "disabled");
+
+	// Back to back, so tracked rounds only copy what capturing and restoring touch
+	// themselves; a frame of run-ahead adds the pages the frame wrote.  Compare rounds
+	// forget the bits before restoring, which is the cost without tracking.
+	const char* names[] = {"tracked", "compare"};
+	for (int mode = tracking ? 0 : 1; mode < 2; mode++)
+	{
+		double capture_total = 0, restore_total = 0, capture_worst = 0, restore_worst = 0, clear_total = 0, pagemap_total = 0;
+		u64 capture_pages = 0, restore_pages = 0;
+		int done = 0;
+
+		for (int i = 0; i <= iterations; i++)
+		{
+			auto start = clock::now();
+			const u64 id = CaptureSnapshot();
+			const double capture_ms = ms(start);
+			const uint captured = s_pages_copied;
+			double clear_ms = s_clear_ms;
+			double pagemap_ms = s_pagemap_ms;
+
+			if (mode == 1)
+				s_snapshot.epoch = 0;
+
+			start = clock::now();
+			if (!id || !RestoreSnapshot(id))
+			{
+				log_cb(RETRO_LOG_WARN, "Snapshot benchmark: could not stop the machine (lockstep off?)\n");
+				return;
+			}
+			const double restore_ms = ms(start);
+			clear_ms += s_clear_ms;
+			pagemap_ms += s_pagemap_ms;
+
+			// The first capture copies everything.
+			if (i == 0)
+			{
+				log_cb(RETRO_LOG_INFO, "Snapshot benchmark: %s, first capture %.3f ms, %u pages\n", names[mode], capture_ms, captured);
+				continue;
+			}
+
+			capture_total += capture_ms;
+			restore_total += restore_ms;
+			capture_worst = std::max(capture_worst, capture_ms);
+			restore_worst = std::max(restore_worst, restore_ms);
+			capture_pages += captured;
+			restore_pages += s_pages_copied;
+			clear_total += clear_ms;
+			pagemap_total += pagemap_ms;
+			done++;
+		}
+
+		log_cb(RETRO_LOG_INFO, "Snapshot benchmark: %s, %d rounds, capture mean %.3f ms worst %.3f ms (%llu pages), restore mean %.3f ms worst %.3f ms (%llu pages), soft-dirty clears %.3f ms and pagemap reads %.3f ms per round\n",
+			names[mode], done, capture_total / done, capture_worst, (unsigned long long)(capture_pages / done),
+			restore_total / done, restore_worst, (unsigned long long)(restore_pages / done), clear_total / done, pagemap_total / done);
+	}
+
+#if defined(__linux__)
+	// The rest of the cost of a clear lands on whoever writes next: the first write to every
+	// page faults.  Timed on a buffer the size of EE ram, written once before and after one.
+	if (tracking)
+	{
+		std::unique_ptr<u8[]> buffer(new u8[Ps2MemSize::MainRam]());
+		volatile u8* bytes = buffer.get();
+		auto write_pages = [&]() {
+			const auto start = clock::now();
+			for (u32 offset = 0; offset < Ps2MemSize::MainRam; offset += s_host_pagesize)
+				bytes[offset]++;
+			return ms(start);
+		};
+
+		write_pages();
+		const double warm_ms = write_pages();
+		ClearSoftDirty();
+		const double faulting_ms = write_pages();
+		const u32 pages = Ps2MemSize::MainRam / s_host_pagesize;
+		log_cb(RETRO_LOG_INFO, "Snapshot benchmark: first write to a page after a clear %.3f us (%.3f us before it), %u pages\n",
+			faulting_ms * 1000 / pages, warm_ms * 1000 / pages, pages);
+	}
+#endif
+
+	DiscardSnapshot();
+}
@@ -0,0 +1,55 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// --------------------------------------------------------------------------------------
+//  In-process snapshots
+// --------------------------------------------------------------------------------------
+// A copy of the running machine kept in memory for the frontend's run-ahead, which saves
+// and restores every frame.  Emulated memory is copied a page at a time and only pages
+// that changed are copied back; where the kernel tracks written pages (soft-dirty, Linux)
+// only those are looked at.  Internals, GS and SPU2 go through their freeze functions.
+//
+// A snapshot can only be taken while the EE is stopped at a vsync, which needs lockstep:
+// the EE then waits at every vsync until the frontend runs the next frame.  Everything
+// but SnapshotVsyncInThread is called from the frontend (MTGS) thread.
+
+extern void SetSnapshotLockstep(bool enabled);
+extern bool GetSnapshotLockstep();
+
+// Called by the EE at the start of every vsync, before anything of the vsync is done.
+extern void SnapshotVsyncInThread();
+
+// Lets the EE run up to its next vsync.  Called once per frame before the MTGS runs.
+extern void SnapshotBeginFrame();
+
+// Waits for the EE to park at its vsync and has the GS and VU1 catch up, so the machine can
+// be read or replaced from the frontend thread until the next SnapshotBeginFrame.  Returns
+// false if lockstep is off or the EE did not stop.
+extern bool SnapshotHoldMachine();
+
+// Returns an id for the snapshot, or 0 if the machine could not be stopped.  There is one
+// snapshot, taking a new one replaces it.
+extern u64 CaptureSnapshot();
+
+// Returns false if id isn't the current snapshot (or the machine could not be stopped).
+extern bool RestoreSnapshot(u64 id);
+
+extern void DiscardSnapshot();
+
+// Captures and restores the running machine a number of times and logs how long each took,
+// how many pages were copied and what clearing the soft-dirty bits cost.  Needs lockstep.
+extern void SaveStateSnapshotBenchmark(int iterations = 60);
@@ -27,6 +27,10 @@
 
 #include "Utilities/MemsetFast.inl"
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 // --------------------------------------------------------------------------------------
 //  RecompiledCodeReserve  (implementations)
 // --------------------------------------------------------------------------------------
@@ -290,6 +294,7 @@ SysMainMemory::~SysMainMemory()
 
 void SysMainMemory::ReserveAll()
 {
+	ScopedBootPhase phase("VM reservation");
 	pxInstallSignalHandler();
 
 #ifndef NDEBUG
@@ -305,6 +310,7 @@ void SysMainMemory::CommitAll()
 	vtlb_Core_Alloc();
 	if (m_ee.IsCommitted() && m_iop.IsCommitted() && m_vu.IsCommitted()) return;
 
+	ScopedBootPhase phase("VM commit");
 #ifndef NDEBUG
 	log_cb(RETRO_LOG_DEBUG, "Allocating host memory for virtual systems...\n" );
 #endif
@@ -375,6 +381,7 @@ void SysMainMemory::ReleaseAll()
 SysCpuProviderPack::SysCpuProviderPack()
 {
 	log_cb(RETRO_LOG_INFO, "Reserving memory for recompilers...\n" );
+	ScopedBootPhase phase("Recompiler reservation");
 
 	CpuProviders = std::make_unique<CpuInitializerSet>();
 
@@ -411,6 +418,8 @@ bool SysCpuProviderPack::IsRecAvailable_MicroVU0() const { return CpuProviders->
 bool SysCpuProviderPack::IsRecAvailable_MicroVU1() const { return CpuProviders->microVU1.IsAvailable(); }
 BaseException* SysCpuProviderPack::GetException_MicroVU0() const { return CpuProviders->microVU0.ExThrown.get(); }
 BaseException* SysCpuProviderPack::GetException_MicroVU1() const { return CpuProviders->microVU1.ExThrown.get(); }
+BaseVUmicroCPU* SysCpuProviderPack::GetInterpVU0() const { return (BaseVUmicroCPU*)CpuProviders->interpVU0; }
+BaseVUmicroCPU* SysCpuProviderPack::GetMicroVU0() const { return (BaseVUmicroCPU*)CpuProviders->microVU0; }
 
 void SysCpuProviderPack::CleanupMess() noexcept
 {
@@ -470,18 +479,29 @@ void SysClearExecutionCache()
 {
 	GetCpuProviders().ApplyConfig();
 
-	Cpu->Reset();
-	psxCpu->Reset();
+	{
+		ScopedBootPhase phase("EE recompiler reset");
+		Cpu->Reset();
+	}
+	{
+		ScopedBootPhase phase("IOP recompiler reset");
+		psxCpu->Reset();
+	}
 
-	// mVU's VU0 needs to be properly initialized for macro mode even if it's not used for micro mode!
-	if (CHECK_EEREC)
-		((BaseVUmicroCPU*)GetCpuProviders().CpuProviders->microVU0)->Reset();
+	{
+		ScopedBootPhase phase("VU recompiler reset");
 
-	CpuVU0->Reset();
-	CpuVU1->Reset();
+		// mVU's VU0 needs to be properly initialized for macro mode even if it's not used for micro mode!
+		if (CHECK_EEREC)
+			((BaseVUmicroCPU*)GetCpuProviders().CpuProviders->microVU0)->Reset();
+
+		CpuVU0->Reset();
+		CpuVU1->Reset();
+	}
 
 	if (newVifDynaRec)
 	{
+		ScopedBootPhase phase("VIF recompiler reset");
 		dVifReset(0);
 		dVifReset(1);
 	}
@@ -542,3 +562,118 @@ wxString SysGetDiscID()
 
 	return pxsFmt( L"%08x", ElfCRC );
 }
+
+struct BootPhaseRecord
+{
+	const char* name;
+	double start;    // ms since SysMarkBootStart()
+	double duration; // ms
+	bool worker;
+};
+
+static u64 s_boot_start;
+static std::atomic<bool> s_boot_timing{false};
+static std::mutex s_boot_mutex;
+static std::vector<BootPhaseRecord> s_boot_phases;
+static std::vector<std::thread> s_boot_tasks;
+static thread_local bool s_boot_worker = false;
+
+static u64 BootClock()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double BootClockToMs(u64 ns)
+{
+	return ns / 1000000.0;
+}
+
+ScopedBootPhase::ScopedBootPhase(const char* name)
+	: m_name(name)
+	, m_start(BootClock())
+{
+}
+
+ScopedBootPhase::~ScopedBootPhase()
+{
+	if (!s_boot_timing)
+		return;
+
+	const double duration = BootClockToMs(BootClock() - m_start);
+	log_cb(RETRO_LOG_INFO, "(Boot) %s took %.1f ms%s\n", m_name, duration, s_boot_worker ? " (worker)" : "");
+
+	std::lock_guard<std::mutex> lock(s_boot_mutex);
+	if (m_start >= s_boot_start)
+		s_boot_phases.push_back({m_name, BootClockToMs(m_start - s_boot_start), duration, s_boot_worker});
+}
+
+void SysStartBootTask(const char* name, std::function<void()> task)
+{
+	std::lock_guard<std::mutex> lock(s_boot_mutex);
+	s_boot_tasks.emplace_back([name, task = std::move(task)]() {
+		s_boot_worker = true;
+		try
+		{
+			ScopedBootPhase phase(name);
+			task();
+		}
+		catch (BaseException& ex)
+		{
+			log_cb(RETRO_LOG_ERROR, "(Boot) %s failed: %s\n", name, WX_STR(ex.FormatDiagnosticMessage()));
+		}
+		catch (std::exception& ex)
+		{
+			log_cb(RETRO_LOG_ERROR, "(Boot) %s failed: %s\n", name, ex.what());
+		}
+	});
+}
+
+void SysWaitBootTasks()
+{
+	std::vector<std::thread> tasks;
+	{
+		std::lock_guard<std::mutex> lock(s_boot_mutex);
+		tasks.swap(s_boot_tasks);
+	}
+	for (std::thread& task : tasks)
+		task.join();
+}
+
+void SysMarkBootStart()
+{
+	SysWaitBootTasks();
+
+	std::lock_guard<std::mutex> lock(s_boot_mutex);
+	s_boot_phases.clear();
+	s_boot_start = BootClock();
+	s_boot_timing = true;
+}
+
+void SysLogBootTime(const char* milestone, bool done)
+{
+	if (!s_boot_timing)
+		return;
+
+	const double now = BootClockToMs(BootClock() - s_boot_start);
+	log_cb(RETRO_LOG_INFO, "(Boot) %s after %.1f ms\n", milestone, now);
+
+	if (!done)
+		return;
+
+	SysWaitBootTasks();
+
+	std::lock_guard<std::mutex> lock(s_boot_mutex);
+	s_boot_timing = false;
+
+	std::sort(s_boot_phases.begin(), s_boot_phases.end(), [](const BootPhaseRecord& a, const BootPhaseRecord& b) {
+		return a.start < b.start;
+	});
+
+	log_cb(RETRO_LOG_INFO, "(Boot) Phase summary:\n");
+	for (const BootPhaseRecord& phase : s_boot_phases)
+	{
+		log_cb(RETRO_LOG_INFO, "(Boot)   %-28s at %8.1f ms, took %7.1f ms%s\n",
+			phase.name, phase.start, phase.duration, phase.worker ? " (worker)" : "");
+	}
+	s_boot_phases.clear();
+}
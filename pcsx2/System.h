@@ -23,6 +23,8 @@
 
 #include "vtlb.h"
 
+#include <functional>
+
 typedef SafeArray<u8> VmStateBuffer;
 
 class BaseVUmicroCPU;
@@ -148,6 +150,10 @@ public:
 	BaseException* GetException_MicroVU0() const;
 	BaseException* GetException_MicroVU1() const;
 
+	// The VU0 providers whichever of them is configured, for running both (CoreBenchmark).
+	BaseVUmicroCPU* GetInterpVU0() const;
+	BaseVUmicroCPU* GetMicroVU0() const;
+
 protected:
 	void CleanupMess() noexcept;
 };
@@ -165,6 +171,28 @@ extern void NTFS_CompressFile( const wxString& file, bool compressStatus=true );
 extern wxString SysGetBiosDiscID();
 extern wxString SysGetDiscID();
 
+// Boot timing: the frontend marks the start of loading content, milestones are logged relative
+// to it until the game's entry point is reached.
+extern void SysMarkBootStart();
+extern void SysLogBootTime(const char* milestone, bool done = false);
+
+// Times the enclosing scope as one phase of starting up.  While a boot is being timed, phases
+// are logged as they end and listed again in the summary logged at the game's entry point.
+class ScopedBootPhase
+{
+	const char* m_name;
+	u64 m_start;
+
+public:
+	ScopedBootPhase(const char* name);
+	~ScopedBootPhase();
+};
+
+// Runs a phase of starting up that does not depend on the others on a worker thread.  Phases
+// handed here must synchronise with their consumers themselves; SysWaitBootTasks() only joins.
+extern void SysStartBootTask(const char* name, std::function<void()> task);
+extern void SysWaitBootTasks();
+
 extern SysMainMemory& GetVmMemory();
 
 // --------------------------------------------------------------------------------------
@@ -26,9 +26,13 @@
 #include "Patch.h"
 #include "SysThreads.h"
 #include "MTVU.h"
+#include "newVif.h"
 #include "IPC.h"
 #include "FW.h"
 #include "SPU2/spu2.h"
+#include "Utilities/ThreadPlacement.h"
+#include "FrameTelemetry.h"
+#include "Benchmarks.h"
 
 #include "../DebugTools/MIPSAnalyst.h"
 #include "../DebugTools/SymbolMap.h"
@@ -267,6 +271,13 @@ void SysCoreThread::_reset_stuff_as_needed()
 	{
 		DoCpuReset();
 
+		// Benchmarks want a machine fresh from reset, and may leave it needing another.
+		if (RunBootBenchmark())
+		{
+			SysClearExecutionCache();
+			DoCpuReset();
+		}
+
 		m_resetVirtualMachine = false;
 		m_resetVsyncTimers = false;
 
@@ -305,6 +316,9 @@ void SysCoreThread::GameStartingInThread()
 {
 	GetMTGS().SendGameCRC(ElfCRC);
 
+	if (newVifDynaRec)
+		dVifLoadCache(ElfCRC);
+
 	MIPSAnalyst::ScanForFunctions(ElfTextRange.first, ElfTextRange.first + ElfTextRange.second, true);
 	symbolMap.UpdateActiveSymbols();
 
@@ -331,6 +345,9 @@ bool SysCoreThread::StateCheckInThread()
 // "exception-type boundary" problem (can't mix SEH and C++ exceptions in the same function).
 void SysCoreThread::DoCpuExecute()
 {
+	if (!m_hasActiveMachine)
+		SysLogBootTime("First EE instruction");
+
 	m_hasActiveMachine = true;
 	Cpu->Execute();
 }
@@ -339,6 +356,8 @@ void SysCoreThread::ExecuteTaskInThread()
 {
 	m_sem_event.WaitWithoutYield();
 
+	Threading::PlaceCurrentThread(Threading::ThreadRole::EE);
+	FrameTelemetryRegisterEEThread();
 	m_mxcsr_saved.bitmask = _mm_getcsr();
 
 	PCSX2_PAGEFAULT_PROTECT
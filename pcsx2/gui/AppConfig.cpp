@@ -77,6 +77,12 @@ namespace PathDefs
 			static const wxDirName retval(L"cheats_ws");
 			return retval;
 		}
+
+		const wxDirName& Cache()
+		{
+			static const wxDirName retval(L"cache");
+			return retval;
+		}
 	};
 
 	const wxDirName& LibretroPcsx2Root()
@@ -103,6 +109,11 @@ namespace PathDefs
 
 		return LibretroPcsx2Root() + Base::CheatsWS();
 	}
+
+	wxDirName GetCache()
+	{
+		return LibretroPcsx2Root() + Base::Cache();
+	}
 	
 	wxDirName GetSavestates()
 	{
@@ -129,6 +140,7 @@ namespace PathDefs
 			case FolderId_MemoryCards:	return GetMemoryCards();
 			case FolderId_Cheats:		return GetCheats();
 			case FolderId_CheatsWS:		return GetCheatsWS();
+			case FolderId_Cache:		return GetCache();
 
 			case FolderId_Documents:	return CustomDocumentsFolder;
 
@@ -148,6 +160,7 @@ wxDirName& AppConfig::FolderOptions::operator[]( FoldersEnum_t folderidx )
 		case FolderId_MemoryCards:	return MemoryCards;
 		case FolderId_Cheats:		return Cheats;
 		case FolderId_CheatsWS:		return CheatsWS;
+		case FolderId_Cache:		return Cache;
 
 		case FolderId_Documents:	return CustomDocumentsFolder;
 
@@ -219,6 +232,11 @@ wxDirName GetCheatsWsFolder()
 	return GetResolvedFolder(FolderId_CheatsWS);
 }
 
+wxDirName GetCacheFolder()
+{
+	return GetResolvedFolder(FolderId_Cache);
+}
+
 wxDirName GetSettingsFolder()
 {
 	if( wxGetApp().Overrides.SettingsFolder.IsOk() )
@@ -311,6 +329,7 @@ void AppConfig::FolderOptions::LoadSave()
 	MemoryCards = PathDefs::GetMemoryCards();
 	Cheats = PathDefs::GetCheats();
 	CheatsWS = PathDefs::GetCheatsWS();
+	Cache = PathDefs::GetCache();
 
 
 	//ApplyDefaults();
@@ -26,6 +26,7 @@ extern wxDirName GetSettingsFolder();
 
 extern wxDirName GetCheatsFolder();
 extern wxDirName GetCheatsWsFolder();
+extern wxDirName GetCacheFolder();
 
 enum MemoryCardType
 {
@@ -49,7 +50,8 @@ public:
 			Savestates,
 			MemoryCards,
 			Cheats,
-			CheatsWS;
+			CheatsWS,
+			Cache;
 
 		wxFileName RunDisc; // last used location for Disc loading.
 
@@ -453,6 +453,7 @@ static void _ApplySettings(const Pcsx2Config& src, Pcsx2Config& fixup)
 //       and later might be too late since the code was already recompiled
 void LoadAllPatchesAndStuff(const Pcsx2Config& cfg)
 {
+	ScopedBootPhase phase("GameDB and patch loading");
 	Pcsx2Config dummy;
 	PatchesVerboseReset();
 	_ApplySettings(cfg, dummy);
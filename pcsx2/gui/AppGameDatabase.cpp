@@ -21,10 +21,10 @@
 
 AppGameDatabase& AppGameDatabase::Load()
 {
-	std::string game_index(reinterpret_cast<const char*>(&GameIndex_yaml), GameIndex_yaml_len);
-	std::istringstream stream(game_index);
-
-	if (!this->initDatabase(stream))
+	ScopedBootPhase phase("GameDB index");
+	// The GameIndex is linked into the binary, so index it in place and only parse the
+	// entries that are actually looked up.
+	if (!this->initDatabase(reinterpret_cast<const char*>(GameIndex_yaml), GameIndex_yaml_len))
 	{
 		log_cb(RETRO_LOG_ERROR, "[GameDB] Database could not be loaded successfully\n");
 		return *this;
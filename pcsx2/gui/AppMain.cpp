@@ -101,6 +101,7 @@ void AppApplySettings()
 
 	g_Conf->Folders.Cheats.Mkdir();
 	g_Conf->Folders.CheatsWS.Mkdir();
+	g_Conf->Folders.Cache.Mkdir();
 
 	//g_Conf->EmuOptions.BiosFilename = g_Conf->FullpathToBios();
 
@@ -261,6 +261,7 @@ static void LoadIrx( const wxString& filename, u8* dest )
 void LoadBIOS()
 {
 	pxAssertDev( eeMem->ROM != NULL, "PS2 system memory has not been initialized yet." );
+	ScopedBootPhase phase("BIOS load");
 
 	try
 	{
@@ -318,6 +319,23 @@ void LoadBIOS()
 	}
 }
 
+// Reads the BIOS image through once so that LoadBIOS() is served from the host's file cache
+// instead of waiting on the disk.  Meant to run on a boot task while the VM is being set up;
+// any failure is left for LoadBIOS() to report.
+void PrefetchBIOS(const wxString& filename)
+{
+	if (Path::GetFileSize(filename) <= 0)
+		return;
+
+	wxFFile fp(filename, "rb");
+	if (!fp.IsOpened())
+		return;
+
+	std::unique_ptr<u8[]> buffer(new u8[_256kb]);
+	while (fp.Read(buffer.get(), _256kb) == _256kb)
+		;
+}
+
 bool IsBIOS(const wxString& filename, wxString& description)
 {
 	wxFileName Bios( g_Conf->Folders.Bios + filename );
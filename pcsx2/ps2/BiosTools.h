@@ -41,5 +41,6 @@ extern wxString BiosDescription;
 extern const BiosDebugInformation* CurrentBiosInformation;
 
 extern void LoadBIOS();
+extern void PrefetchBIOS(const wxString& filename);
 extern bool IsBIOS(const wxString& filename, wxString& description);
 extern bool IsBIOSlite(const wxString& filename, wxString& description);
@@ -38,6 +38,8 @@
 
 #include "Utilities/MemsetFast.inl"
 
+#include <unordered_map>
+
 using namespace R5900;
 using namespace vtlb_private;
 
@@ -575,6 +577,242 @@ __fi u32 vtlb_V2P(u32 vaddr)
 	return paddr;
 }
 
+// --------------------------------------------------------------------------------------
+//  Fastmem
+// --------------------------------------------------------------------------------------
+// The fastmem window is a 4GB reserve in which every EE virtual page that vmap resolves to
+// the EE main memory reserve is mapped to the same shared memory pages.  Recompiled code can
+// then access [fastmem_base + addr] without a vmap lookup; handler pages, and pages that point
+// anywhere else (IOP ram, VU memory, ...), stay inaccessible and fault on first access, after
+// which the recompiler backpatches the site to the regular vtlb path (see recVTLB.cpp).
+//
+// Main ram sits at the start of the reserve, so a backing offset below MainRam is a ram page.
+// Ram pages that are write protected for the recompiler's block checking are mirrored read-only,
+// so writes through the window still raise the expected page faults.
+
+static const u32 FASTMEM_UNMAPPED = 0xFFFFFFFF;
+
+static VirtualMemoryManagerPtr s_fastmem_area;
+static void* s_fastmem_shm = NULL;
+static uptr s_fastmem_backing = 0;
+static size_t s_fastmem_backing_size = 0;
+
+// Backing offset mirrored at each virtual page of the window (FASTMEM_UNMAPPED if none), and
+// the reverse mapping from ram pages to the virtual pages mirroring them.
+static u32* s_fastmem_vmap = NULL;
+static std::unordered_multimap<u32, u32> s_fastmem_ram_views;
+static bool s_fastmem_ram_readonly[Ps2MemSize::MainRam >> VTLB_PAGE_BITS];
+static std::vector<vtlbFastmemView> s_fastmem_views;
+static bool s_fastmem_views_stale = true;
+
+static u32 vtlb_GetFastmemBackingOffset(u32 vpage)
+{
+	const u32 vaddr = vpage << VTLB_PAGE_BITS;
+	const VTLBVirtual vmv = vtlbdata.vmap[vpage];
+	if (vmv.isHandler(vaddr))
+		return FASTMEM_UNMAPPED;
+
+	const uptr offset = vmv.assumePtr(vaddr) - s_fastmem_backing;
+	if (offset >= s_fastmem_backing_size || (offset & VTLB_PAGE_MASK))
+		return FASTMEM_UNMAPPED;
+
+	return offset;
+}
+
+static bool vtlb_IsFastmemReadOnly(u32 offset)
+{
+	return offset < Ps2MemSize::MainRam && s_fastmem_ram_readonly[offset >> VTLB_PAGE_BITS];
+}
+
+static void vtlb_SetFastmemPage(u32 vpage, u32 offset)
+{
+	const u32 prev = s_fastmem_vmap[vpage];
+	if (prev < Ps2MemSize::MainRam)
+	{
+		auto range = s_fastmem_ram_views.equal_range(prev >> VTLB_PAGE_BITS);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == vpage)
+			{
+				s_fastmem_ram_views.erase(it);
+				break;
+			}
+		}
+	}
+
+	s_fastmem_vmap[vpage] = offset;
+	if (offset < Ps2MemSize::MainRam)
+		s_fastmem_ram_views.emplace(offset >> VTLB_PAGE_BITS, vpage);
+	s_fastmem_views_stale = true;
+}
+
+// Brings the fastmem window in line with vmap for the given range.  Runs of pages that mirror
+// consecutive backing pages are mapped with a single call, and runs that are already mapped
+// the same way are skipped.
+static void vtlb_UpdateFastmemView(u32 vaddr, u32 size)
+{
+	if (!vtlbdata.fastmem_base)
+		return;
+
+	u32 vpage = vaddr >> VTLB_PAGE_BITS;
+	const u32 end = vpage + (size >> VTLB_PAGE_BITS);
+
+	while (vpage < end)
+	{
+		const u32 offset = vtlb_GetFastmemBackingOffset(vpage);
+		const bool readonly = vtlb_IsFastmemReadOnly(offset);
+		const bool unmapped = (offset == FASTMEM_UNMAPPED);
+
+		u32 count = 1;
+		bool changed = (s_fastmem_vmap[vpage] != offset);
+		for (; vpage + count < end; count++)
+		{
+			const u32 next = vtlb_GetFastmemBackingOffset(vpage + count);
+			const u32 expected = unmapped ? FASTMEM_UNMAPPED : offset + count * VTLB_PAGE_SIZE;
+			if (next != expected || vtlb_IsFastmemReadOnly(next) != readonly)
+				break;
+			changed |= (s_fastmem_vmap[vpage + count] != next);
+		}
+
+		if (changed)
+		{
+			u8* view = vtlbdata.fastmem_base + ((uptr)vpage << VTLB_PAGE_BITS);
+			bool mapped = false;
+			if (!unmapped)
+				mapped = HostSys::MapSharedMemory(s_fastmem_shm, offset, view, count * VTLB_PAGE_SIZE,
+					readonly ? PageAccess_ReadOnly() : PageAccess_ReadWrite());
+			if (!mapped)
+				HostSys::MmapResetPtr(view, count * VTLB_PAGE_SIZE);
+
+			for (u32 i = 0; i < count; i++)
+				vtlb_SetFastmemPage(vpage + i, mapped ? offset + i * VTLB_PAGE_SIZE : FASTMEM_UNMAPPED);
+		}
+
+		vpage += count;
+	}
+}
+
+// Clears the window and turns fastmem on or off for the next run of the recompiler.  The whole
+// window is unmapped first; vtlb_Init remaps it as it rebuilds vmap.  When the window or the
+// shared memory backing can't be had, the recompiler keeps using the regular vtlb lookups.
+static void vtlb_ResetFastmem()
+{
+	if (vtlbdata.fastmem_base)
+		HostSys::MmapResetPtr(vtlbdata.fastmem_base, _4gb);
+	s_fastmem_ram_views.clear();
+	s_fastmem_views_stale = true;
+	vtlbdata.fastmem_base = NULL;
+
+	if (!EmuConfig.Cpu.Recompiler.EnableEE || !EmuConfig.Cpu.Recompiler.EnableFastmem)
+		return;
+
+	if (!s_fastmem_shm)
+	{
+		log_cb(RETRO_LOG_WARN, "(vtlb) EE memory isn't backed by shared memory, fastmem disabled\n");
+		return;
+	}
+
+	// Reserve only, the pages are mapped by vtlb_UpdateFastmemView.
+	if (!s_fastmem_area)
+		s_fastmem_area = std::make_shared<VirtualMemoryManager>("EE Fastmem Window", 0, _4gb);
+	if (!s_fastmem_area->IsOk())
+	{
+		log_cb(RETRO_LOG_WARN, "(vtlb) Couldn't reserve 4GB of address space, fastmem disabled\n");
+		s_fastmem_area.reset();
+		return;
+	}
+
+	if (!s_fastmem_vmap)
+	{
+		s_fastmem_vmap = (u32*)_aligned_malloc( VTLB_VMAP_ITEMS * sizeof(*s_fastmem_vmap), 16 );
+		if (!s_fastmem_vmap)
+			return;
+	}
+
+	memset(s_fastmem_vmap, 0xFF, VTLB_VMAP_ITEMS * sizeof(*s_fastmem_vmap));
+	vtlbdata.fastmem_base = (u8*)s_fastmem_area->GetBase();
+}
+
+// Called by eeMemoryReserve once its pages are backed by a shared memory object (or with a
+// NULL handle when they no longer are).
+void vtlb_SetFastmemBacking(void* handle, void* base, size_t size)
+{
+	s_fastmem_shm = handle;
+	s_fastmem_backing = handle ? (uptr)base : 0;
+	s_fastmem_backing_size = handle ? size : 0;
+
+	if (!handle)
+		vtlb_ResetFastmem();
+}
+
+// Applies a protection change of eeMem->Main pages to their views in the window.
+void vtlb_UpdateFastmemProtection(u32 offset, u32 size, const PageProtectionMode& mode)
+{
+	const u32 end = (offset + size) >> VTLB_PAGE_BITS;
+
+	for (u32 rampage = offset >> VTLB_PAGE_BITS; rampage < end; rampage++)
+	{
+		s_fastmem_ram_readonly[rampage] = !mode.CanWrite();
+
+		if (!vtlbdata.fastmem_base)
+			continue;
+
+		auto range = s_fastmem_ram_views.equal_range(rampage);
+		for (auto it = range.first; it != range.second; ++it)
+			HostSys::MemProtect(vtlbdata.fastmem_base + ((uptr)it->second << VTLB_PAGE_BITS), __pagesize, mode);
+	}
+}
+
+const std::vector<vtlbFastmemView>& vtlb_GetFastmemViews()
+{
+	if (!s_fastmem_views_stale)
+		return s_fastmem_views;
+
+	s_fastmem_views.clear();
+	s_fastmem_views_stale = false;
+	if (!vtlbdata.fastmem_base)
+		return s_fastmem_views;
+
+	for (u32 vpage = 0; vpage < VTLB_VMAP_ITEMS; vpage++)
+	{
+		const u32 offset = s_fastmem_vmap[vpage];
+		if (offset == FASTMEM_UNMAPPED)
+			continue;
+
+		if (!s_fastmem_views.empty())
+		{
+			vtlbFastmemView& last = s_fastmem_views.back();
+			if (last.vaddr + last.size == vpage << VTLB_PAGE_BITS && last.offset + last.size == offset)
+			{
+				last.size += VTLB_PAGE_SIZE;
+				continue;
+			}
+		}
+		s_fastmem_views.push_back({offset, vpage << VTLB_PAGE_BITS, VTLB_PAGE_SIZE});
+	}
+
+	return s_fastmem_views;
+}
+
+// Translates a host address inside the window back to an offset into eeMem->Main.
+// Returns false if the address isn't a view of main ram.
+bool vtlb_GetFastmemRamOffset(uptr hostaddr, uptr& offset)
+{
+	if (!vtlbdata.fastmem_base)
+		return false;
+
+	const uptr vaddr = hostaddr - (uptr)vtlbdata.fastmem_base;
+	if (vaddr >= (uptr)_4gb)
+		return false;
+
+	const u32 page = s_fastmem_vmap[vaddr >> VTLB_PAGE_BITS];
+	if (page >= Ps2MemSize::MainRam)
+		return false;
+
+	offset = page + (vaddr & VTLB_PAGE_MASK);
+	return true;
+}
+
 //virtual mappings
 //TODO: Add invalid paddr checks
 void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
@@ -583,6 +821,8 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 	verify(0==(paddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	const u32 view_vaddr = vaddr, view_size = size;
+
 	while (size > 0)
 	{
 		VTLBVirtual vmv;
@@ -605,6 +845,8 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 		paddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
+
+	vtlb_UpdateFastmemView(view_vaddr, view_size);
 }
 
 void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
@@ -612,6 +854,7 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	verify(0==(vaddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	const u32 view_vaddr = vaddr, view_size = size;
 	uptr bu8 = (uptr)buffer;
 	while (size > 0)
 	{
@@ -620,6 +863,8 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 		bu8 += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
+
+	vtlb_UpdateFastmemView(view_vaddr, view_size);
 }
 
 void vtlb_VMapUnmap(u32 vaddr,u32 size)
@@ -627,6 +872,7 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 	verify(0==(vaddr&VTLB_PAGE_MASK));
 	verify(0==(size&VTLB_PAGE_MASK) && size>0);
 
+	const u32 view_vaddr = vaddr, view_size = size;
 	while (size > 0)
 	{
 
@@ -641,6 +887,8 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 		vaddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
+
+	vtlb_UpdateFastmemView(view_vaddr, view_size);
 }
 
 // vtlb_Init -- Clears vtlb handlers and memory mappings.
@@ -671,6 +919,8 @@ void vtlb_Init()
 
 	//done !
 
+	vtlb_ResetFastmem();
+
 	//Setup the initial mappings
 	vtlb_MapHandler(DefaultPhyHandler,0,VTLB_PMAP_SZ);
 
@@ -742,6 +992,14 @@ void vtlb_Alloc_Ppmap()
 
 void vtlb_Core_Free()
 {
+	if (vtlbdata.fastmem_base)
+		HostSys::MmapResetPtr(vtlbdata.fastmem_base, _4gb);
+	vtlbdata.fastmem_base = NULL;
+	s_fastmem_ram_views.clear();
+	s_fastmem_views_stale = true;
+	safe_aligned_free( s_fastmem_vmap );
+	s_fastmem_area.reset();
+
 	if (vtlbdata.vmap) {
 		HostSys::MmapResetPtr(vtlbdata.vmap, VMAP_SIZE);
 		vtlbdata.vmap = nullptr;
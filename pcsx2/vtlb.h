@@ -103,6 +103,28 @@ extern void vtlb_DynGenWrite_Const( u32 bits, u32 addr_const );
 extern void vtlb_DynGenRead64_Const( u32 bits, u32 addr_const );
 extern void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const );
 
+// Fastmem: a 4GB host window mirroring the EE virtual address space.  Pages that resolve to
+// the (shared memory backed) EE main memory reserve are mapped into it, everything else is
+// left inaccessible.  Recompiled loads and stores access the window directly, and sites that
+// fault are backpatched to the regular vtlb lookup.
+extern void vtlb_SetFastmemBacking(void* handle, void* base, size_t size);
+extern void vtlb_UpdateFastmemProtection(u32 offset, u32 size, const PageProtectionMode& mode);
+extern bool vtlb_GetFastmemRamOffset(uptr hostaddr, uptr& offset);
+
+// A run of window pages mirroring consecutive pages of the EE memory reserve.
+struct vtlbFastmemView
+{
+	u32 offset; // into the reserve
+	u32 vaddr;  // of the first page in the window
+	u32 size;
+};
+
+// Every run of the window, in window order; empty while fastmem is off.  Rebuilt on the
+// first call after the window changed.
+extern const std::vector<vtlbFastmemView>& vtlb_GetFastmemViews();
+extern bool vtlb_BackpatchFastmem(uptr pc);
+extern void vtlb_DynGenResetFastmem();
+
 // --------------------------------------------------------------------------------------
 //  VtlbMemoryReserve
 // --------------------------------------------------------------------------------------
@@ -130,6 +152,10 @@ class eeMemoryReserve : public VtlbMemoryReserve
 {
 	typedef VtlbMemoryReserve _parent;
 
+	// Shared memory object backing the reserve, so that the vtlb can mirror it into the
+	// fastmem window (NULL if the host doesn't support it).
+	void* m_shm;
+
 public:
 	eeMemoryReserve();
 	~eeMemoryReserve();
@@ -252,10 +278,13 @@ namespace vtlb_private
 
 		u32* ppmap;               //4MB (allocated by vtlb_init) // PS2 virtual to PS2 physical
 
+		u8* fastmem_base;         // 4GB fastmem window, NULL when fastmem is disabled
+
 		MapData()
 		{
 			vmap = NULL;
 			ppmap = NULL;
+			fastmem_base = NULL;
 		}
 	};
 
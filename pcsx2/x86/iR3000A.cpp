@@ -34,6 +34,7 @@
 #include "iCore.h"
 
 #include "AppConfig.h"
+#include "FrameTelemetry.h"
 
 using namespace x86Emitter;
 
@@ -111,6 +112,25 @@ static DynGenFunc* iopJITCompileInBlock		= NULL;
 static DynGenFunc* iopEnterRecompiledCode	= NULL;
 static DynGenFunc* iopExitRecompiledCode	= NULL;
 
+#ifdef PCSX2_DEVBUILD
+// Indirect jump counters, logged and reset every 64M jumps. Without the inline caches every
+// indirect jump went through iopDispatcherReg, so dispatched + inlined is the old count.
+static struct
+{
+	u32 dispatched; // lookups done by iopDispatcherReg
+	u32 inlined; // indirect jumps that hit their site's cached target
+	u32 linked; // sites that got a cached target
+} s_dispatchStats;
+#endif
+
+// Data emitted after each indirect jump site, read by iopRecLinkIndirect.
+struct IopIndirectSite
+{
+	u32* pc; // imm32 of the cmp against psxRegs.pc
+	s32* miss; // rel32 of the jne taken when the pc doesn't match
+	s32* jump; // rel32 of the jmp to the cached block
+};
+
 static void recEventTest()
 {
 	_cpuEventTest_Shared();
@@ -147,6 +167,9 @@ static DynGenFunc* _DynGen_DispatcherReg()
 {
 	u8* retval = xGetPtr();
 
+#ifdef PCSX2_DEVBUILD
+	xADD( ptr32[&s_dispatchStats.dispatched], 1 );
+#endif
 	xMOV( eax, ptr[&psxRegs.pc] );
 	xMOV( ebx, eax );
 	xSHR( eax, 16 );
@@ -460,7 +483,11 @@ static void psxRecompileIrxImport()
 	if (hle) {
 		xFastCall((void *)hle);
 		xTEST(eax, eax);
-		xJNZ(iopDispatcherReg);
+		xForwardJZ32 nohle;
+		// The HLE function returned to the caller, the return address is usually the same
+		// for a given import so the jump is cached like a JR.
+		psxEmitIndirectJump();
+		nohle.SetTarget();
 	}
 }
 
@@ -652,6 +679,9 @@ void recResetIOP()
 
 	recBlocks.Reset();
 	g_psxMaxRecMem = 0;
+#ifdef PCSX2_DEVBUILD
+	s_dispatchStats = {};
+#endif
 
 	recPtr = *recMem;
 	psxbranch = 0;
@@ -707,6 +737,16 @@ static __noinline s32 recExecuteBlock( s32 eeCycles )
 
 	iopEnterRecompiledCode();
 
+#ifdef PCSX2_DEVBUILD
+	if (s_dispatchStats.dispatched + s_dispatchStats.inlined >= (1u << 26))
+	{
+		const u32 before = s_dispatchStats.dispatched + s_dispatchStats.inlined;
+		log_cb(RETRO_LOG_DEBUG, "(iR3000A) %u dispatcher lookups, %u without inline caches (%.1f%% chained, %u sites linked)\n",
+			s_dispatchStats.dispatched, before, 100.0 * s_dispatchStats.inlined / before, s_dispatchStats.linked);
+		s_dispatchStats = {};
+	}
+#endif
+
 	return iopBreak + iopCycleEE;
 }
 
@@ -808,6 +848,50 @@ void psxSetBranchReg(u32 reg)
 	_psxFlushCall(FLUSH_EVERYTHING);
 	iPsxBranchTest(0xffffffff, 1);
 
+	psxEmitIndirectJump();
+}
+
+// Called the first time an indirect jump site misses: the current pc becomes the site's cached
+// target, the jump to it is linked like an immediate branch (and relinked by recBlocks when the
+// target block is cleared or recompiled). Later misses go straight to the dispatcher.
+static void __fastcall iopRecLinkIndirect(IopIndirectSite* site)
+{
+	const u32 pc = psxRegs.pc;
+
+	*site->pc = pc;
+	*site->miss = (s32)((uptr)iopDispatcherReg - (uptr)(site->miss + 1));
+	recBlocks.Link(HWADDR(pc), site->jump);
+
+#ifdef PCSX2_DEVBUILD
+	s_dispatchStats.linked++;
+#endif
+}
+
+// Jumps to the block at psxRegs.pc with a monomorphic inline cache instead of a dispatcher
+// lookup. Registers must be flushed.
+void psxEmitIndirectJump()
+{
+	xMOV(eax, ptr32[&psxRegs.pc]);
+
+	// cmp eax, imm32: pcs are word aligned, so 1 never matches until the site is linked
+	xWrite8(0x3d);
+	u32* pc = (u32*)xGetPtr();
+	xWrite32(1);
+
+	s32* miss = xJcc32(Jcc_NotEqual);
+#ifdef PCSX2_DEVBUILD
+	xADD(ptr32[&s_dispatchStats.inlined], 1);
+#endif
+	s32* jump = xJcc32();
+
+	IopIndirectSite* site = (IopIndirectSite*)xGetPtr();
+	site->pc = pc;
+	site->miss = miss;
+	site->jump = jump;
+	xAdvancePtr(sizeof(IopIndirectSite));
+
+	*miss = (s32)(xGetPtr() - (u8*)(miss + 1));
+	xFastCall((void*)iopRecLinkIndirect, (void*)site);
 	JMP32((uptr)iopDispatcherReg - ( (uptr)x86Ptr + 5 ));
 }
 
@@ -963,6 +1047,7 @@ void psxRecompileNextInstruction(int delayslot)
 
 static void __fastcall iopRecRecompile( const u32 startpc )
 {
+	ScopedFrameTimer jit_time(FrameTimer_JIT);
 	u32 i;
 	u32 willbranch3 = 0;
 
@@ -63,6 +63,7 @@ void psxLoadBranchState();
 
 extern void psxSetBranchReg(u32 reg);
 extern void psxSetBranchImm( u32 imm );
+extern void psxEmitIndirectJump();
 extern void psxRecompileNextInstruction(int delayslot);
 
 ////////////////////////////////////////////////////////////////////
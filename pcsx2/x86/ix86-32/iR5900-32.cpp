@@ -33,6 +33,7 @@
 
 #include "../DebugTools/Breakpoints.h"
 #include "Patch.h"
+#include "FrameTelemetry.h"
 
 #if !PCSX2_SEH
 #	include <csetjmp>
@@ -598,6 +599,7 @@ static void recResetRaw()
 
 	recBlocks.Reset();
 	mmap_ResetBlockTracking();
+	vtlb_DynGenResetFastmem();
 
 	x86SetPtr(*recMem);
 
@@ -1594,6 +1596,7 @@ void doPlace0Patches()
 
 static void __fastcall recRecompile( const u32 startpc )
 {
+	ScopedFrameTimer jit_time(FrameTimer_JIT);
 	u32 i = 0;
 	u32 willbranch3 = 0;
 	u32 usecop2;
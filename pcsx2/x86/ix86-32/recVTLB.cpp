@@ -22,6 +22,8 @@
 #include "iCore.h"
 #include "iR5900.h"
 
+#include <unordered_map>
+
 using namespace vtlb_private;
 using namespace x86Emitter;
 
@@ -230,6 +232,163 @@ namespace vtlb_private
 			break;
 		}
 	}
+
+	// ------------------------------------------------------------------------
+	// Fastmem versions of DynGen_DirectRead/Write: same registers, but the address is taken
+	// relative to the fastmem window (held in rax).  A faulting window access continues in
+	// the slow path, so nothing emitted before it may touch state the slow path depends on;
+	// that's why 128 bit accesses need a free temp xmm register instead of spilling one.
+	// Returns the address of the instruction that accesses the window.
+
+	static bool DynGen_UseFastmem( u32 bits )
+	{
+		return vtlbdata.fastmem_base && (bits != 128 || _hasFreeXMMreg());
+	}
+
+	static u8* DynGen_FastmemRead( u32 bits, bool sign )
+	{
+		u8* access = xGetPtr();
+		switch( bits )
+		{
+			case 8:
+				if( sign )
+					xMOVSX( eax, ptr8[rax + arg1reg] );
+				else
+					xMOVZX( eax, ptr8[rax + arg1reg] );
+			break;
+
+			case 16:
+				if( sign )
+					xMOVSX( eax, ptr16[rax + arg1reg] );
+				else
+					xMOVZX( eax, ptr16[rax + arg1reg] );
+			break;
+
+			case 32:
+				xMOV( eax, ptr32[rax + arg1reg] );
+			break;
+
+			case 64:
+				xMOV( rax, ptr64[rax + arg1reg] );
+				xMOV( ptr64[arg2reg], rax );
+			break;
+
+			case 128:
+			{
+				xRegisterSSE reg( _allocTempXMMreg( XMMT_INT, -1 ) );
+				access = xGetPtr();
+				xMOVDQA( reg, ptr128[rax + arg1reg] );
+				xMOVDQA( ptr128[arg2reg], reg );
+				_freeXMMreg( reg.Id );
+			}
+			break;
+
+			jNO_DEFAULT
+		}
+		return access;
+	}
+
+	static u8* DynGen_FastmemWrite( u32 bits )
+	{
+		u8* access = NULL;
+		switch( bits )
+		{
+			case 8:
+				xMOV( edx, arg2regd );
+				access = xGetPtr();
+				xMOV( ptr[rax + arg1reg], dl );
+			break;
+
+			case 16:
+				access = xGetPtr();
+				xMOV( ptr[rax + arg1reg], xRegister16(arg2reg.Id) );
+			break;
+
+			case 32:
+				access = xGetPtr();
+				xMOV( ptr[rax + arg1reg], arg2regd );
+			break;
+
+			case 64:
+				xMOV( arg3reg, ptr64[arg2reg] );
+				access = xGetPtr();
+				xMOV( ptr64[rax + arg1reg], arg3reg );
+			break;
+
+			case 128:
+			{
+				xRegisterSSE reg( _allocTempXMMreg( XMMT_INT, -1 ) );
+				xMOVDQA( reg, ptr128[arg2reg] );
+				access = xGetPtr();
+				xMOVDQA( ptr128[rax + arg1reg], reg );
+				_freeXMMreg( reg.Id );
+			}
+			break;
+
+			jNO_DEFAULT
+		}
+		return access;
+	}
+}
+
+// ------------------------------------------------------------------------
+// Every fastmem access, keyed by the address of the instruction that touches the window,
+// along with the code to overwrite if it faults: the fast path up to the slow path behind it.
+//
+struct FastmemSite
+{
+	u8* start;
+	u8* slowpath;
+};
+
+static std::unordered_map<uptr, FastmemSite> s_fastmem_sites;
+
+// Emits a fastmem access followed by the regular vtlb access, which the fast path jumps over.
+// FastPath returns the address of its window access (see DynGen_FastmemRead).
+template< typename FastPath, typename SlowPath >
+static void DynGen_Fastmem( const FastPath& fastpath, const SlowPath& slowpath )
+{
+	u8* start = xGetPtr();
+#ifdef __M_X86_64
+	xMOV64( rax, (sptr)vtlbdata.fastmem_base );
+#else
+	xMOV( rax, (sptr)vtlbdata.fastmem_base );
+#endif
+	u8* access = fastpath();
+	xForwardJump8 skip;
+
+	u8* slow = xGetPtr();
+	slowpath();
+	skip.SetTarget();
+
+	pxAssertMsg( slow - start < 128, "Fastmem fast path too long to backpatch" );
+	s_fastmem_sites[(uptr)access] = { start, slow };
+}
+
+// Called from the page fault handler when a fastmem access hits a page the window doesn't
+// mirror.  The start of the fast path becomes a jump to the slow path, and the rest of it is
+// filled with nops, so execution (which resumes at the faulting instruction) slides into the
+// slow path right away and takes the jump from then on.
+//
+bool vtlb_BackpatchFastmem( uptr pc )
+{
+	auto it = s_fastmem_sites.find( pc );
+	if (it == s_fastmem_sites.end()) return false;
+
+	u8* start = it->second.start;
+	u8* slow = it->second.slowpath;
+
+	start[0] = 0xeb;	// jmp rel8
+	start[1] = (u8)(slow - (start + 2));
+	memset( start + 2, 0x90, slow - (start + 2) );
+
+	return true;
+}
+
+// Forgets all fastmem sites; called whenever the recompiler's code cache is reset.
+void vtlb_DynGenResetFastmem()
+{
+	s_fastmem_sites.clear();
 }
 
 // ------------------------------------------------------------------------
@@ -369,12 +528,20 @@ void vtlb_DynGenRead64(u32 bits)
 {
 	pxAssume( bits == 64 || bits == 128 );
 
-	u32* writeback = DynGen_PrepRegs();
+	auto slowpath = [&]()
+	{
+		u32* writeback = DynGen_PrepRegs();
+
+		DynGen_IndirectDispatch( 0, bits );
+		DynGen_DirectRead( bits, false );
 
-	DynGen_IndirectDispatch( 0, bits );
-	DynGen_DirectRead( bits, false );
+		vtlb_SetWriteback(writeback);		// return target for indirect's call/ret
+	};
 
-	vtlb_SetWriteback(writeback);		// return target for indirect's call/ret
+	if (DynGen_UseFastmem(bits))
+		DynGen_Fastmem( [&]() { return DynGen_FastmemRead( bits, false ); }, slowpath );
+	else
+		slowpath();
 }
 
 // ------------------------------------------------------------------------
@@ -385,12 +552,20 @@ void vtlb_DynGenRead32(u32 bits, bool sign)
 {
 	pxAssume( bits <= 32 );
 
-	u32* writeback = DynGen_PrepRegs();
+	auto slowpath = [&]()
+	{
+		u32* writeback = DynGen_PrepRegs();
+
+		DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
+		DynGen_DirectRead( bits, sign );
 
-	DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
-	DynGen_DirectRead( bits, sign );
+		vtlb_SetWriteback(writeback);
+	};
 
-	vtlb_SetWriteback(writeback);
+	if (DynGen_UseFastmem(bits))
+		DynGen_Fastmem( [&]() { return DynGen_FastmemRead( bits, sign ); }, slowpath );
+	else
+		slowpath();
 }
 
 // ------------------------------------------------------------------------
@@ -515,12 +690,20 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 
 void vtlb_DynGenWrite(u32 sz)
 {
-	u32* writeback = DynGen_PrepRegs();
+	auto slowpath = [&]()
+	{
+		u32* writeback = DynGen_PrepRegs();
 
-	DynGen_IndirectDispatch( 1, sz );
-	DynGen_DirectWrite( sz );
+		DynGen_IndirectDispatch( 1, sz );
+		DynGen_DirectWrite( sz );
 
-	vtlb_SetWriteback(writeback);
+		vtlb_SetWriteback(writeback);
+	};
+
+	if (DynGen_UseFastmem(sz))
+		DynGen_Fastmem( [&]() { return DynGen_FastmemWrite( sz ); }, slowpath );
+	else
+		slowpath();
 }
 
 
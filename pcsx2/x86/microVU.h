@@ -25,6 +25,7 @@ using namespace x86Emitter;
 #include "MTVU.h"
 #include "GS.h"
 #include "Gif_Unit.h"
+#include "FrameTelemetry.h"
 #include "iR5900.h"
 #include "R5900OpcodeTables.h"
 #include "System/RecTypes.h"
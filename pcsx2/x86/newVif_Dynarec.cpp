@@ -20,8 +20,59 @@
 #include "PrecompiledHeader.h"
 #include "newVif_UnpackSSE.h"
 #include "MTVU.h"
+#include "AppConfig.h"
+
+#include <wx/ffile.h>
+
+// Unpack routine cache - The keys of every block compiled while a game runs are
+// saved to the cache folder (one file per VIF and per game CRC), and compiled
+// back in one go when the same game boots again.
+#define VIFCACHE_ID "PCSX2.vifcache.v1|"
+#define VIFCACHE_ID_LEN (sizeof(VIFCACHE_ID) - 1)
+#define VIFCACHE_MAX_BLOCKS 8192
+
+static u32  s_cacheCRC[2];		// game the blocks of each VIF are recorded for (0 = none)
+static bool s_cacheDirty[2];	// new blocks were compiled since the cache was loaded
+
+static wxString dVifCacheFilename(int idx, u32 crc) {
+	return (g_Conf->Folders.Cache + pxsFmt(L"%08X.vif%d", crc, idx)).GetFullPath();
+}
+
+static void dVifSaveCache(int idx) {
+	const u32 crc = s_cacheCRC[idx];
+	if (!crc || !s_cacheDirty[idx])
+		return;
+
+	s_cacheDirty[idx] = false;
+
+	std::vector<u32> keys;
+	nVif[idx].vifBlocks.for_each([&keys](const nVifBlock& block) {
+		keys.push_back(block.hash_key);
+		keys.push_back(block.key0);
+		keys.push_back(block.key1);
+	});
+
+	if (keys.empty())
+		return;
+
+	if (keys.size() > VIFCACHE_MAX_BLOCKS * 3)
+		keys.resize(VIFCACHE_MAX_BLOCKS * 3);
+
+	g_Conf->Folders.Cache.Mkdir();
+
+	const wxString filename = dVifCacheFilename(idx, crc);
+	wxFFile fp(filename, L"wb");
+	if (!fp.IsOpened() || fp.Write(VIFCACHE_ID, VIFCACHE_ID_LEN) != VIFCACHE_ID_LEN
+		|| fp.Write(keys.data(), keys.size() * sizeof(u32)) != keys.size() * sizeof(u32)) {
+		log_cb(RETRO_LOG_WARN, "nVif%d: Can't write unpack cache file: '%s'\n", idx, WX_STR(filename));
+		return;
+	}
+
+	log_cb(RETRO_LOG_DEBUG, "nVif%d: Saved %u unpack routine keys to '%s'\n", idx, (u32)(keys.size() / 3), WX_STR(filename));
+}
 
 static void recReset(int idx) {
+	nVif[idx].vifBlocks.print_stats(idx ? "nVif1" : "nVif0");
 	nVif[idx].vifBlocks.reset();
 
 	nVif[idx].recReserve->Reset();
@@ -40,10 +91,16 @@ void dVifReserve(int idx) {
 void dVifReset(int idx) {
 	pxAssertDev(nVif[idx].recReserve, "Dynamic VIF recompiler reserve must be created prior to VIF use or reset!");
 
+	dVifSaveCache(idx);
+	s_cacheCRC[idx] = 0;
+
 	recReset(idx);
 }
 
 void dVifClose(int idx) {
+	dVifSaveCache(idx);
+	s_cacheCRC[idx] = 0;
+
 	if (nVif[idx].recReserve)
 		nVif[idx].recReserve->Reset();
 }
@@ -299,10 +356,82 @@ _vifT __fi nVifBlock* dVifCompile(nVifBlock& block, bool isFill) {
 	VifUnpackSSE_Dynarec(v, block).CompileRoutine();
 
 	v.recWritePtr = xGetPtr();
+	s_cacheDirty[idx] = true;
 
 	return &block;
 }
 
+// Compiles all the blocks recorded in a previous session of the game, so the first
+// occurrence of each unpack doesn't stall on the recompiler.
+_vifT static void dVifPrecompile(u32 crc) {
+	nVifStruct& v = nVif[idx];
+
+	s_cacheCRC[idx]   = crc;
+	s_cacheDirty[idx] = false;
+
+	const wxString filename = dVifCacheFilename(idx, crc);
+	if (!wxFileName::FileExists(filename))
+		return;
+
+	wxFFile fp(filename, L"rb");
+	if (!fp.IsOpened())
+		return;
+
+	char fileId[VIFCACHE_ID_LEN] = {0};
+	const s64 size = (s64)fp.Length() - (s64)VIFCACHE_ID_LEN;
+	if (fp.Read(fileId, VIFCACHE_ID_LEN) != VIFCACHE_ID_LEN || memcmp(fileId, VIFCACHE_ID, VIFCACHE_ID_LEN)
+		|| size <= 0 || size % (3 * sizeof(u32)) || size > (s64)(VIFCACHE_MAX_BLOCKS * 3 * sizeof(u32))) {
+		log_cb(RETRO_LOG_WARN, "nVif%d: Ignoring incompatible unpack cache file: '%s'\n", idx, WX_STR(filename));
+		return;
+	}
+
+	std::vector<u32> keys(size / sizeof(u32));
+	if (fp.Read(keys.data(), size) != (size_t)size)
+		return;
+
+	u32 compiled = 0;
+	for (size_t i = 0; i < keys.size(); i += 3) {
+		nVifBlock block;
+		block.hash_key = keys[i] & 0xFFFF;
+		block._pad0    = 0;
+		block.key0     = keys[i + 1];
+		block.key1     = keys[i + 2];
+
+		// Invalid unpack types would assert in the recompiler
+		const u8 upkNum = block.upkType & 0xf;
+		if (upkNum == 3 || upkNum == 7 || upkNum == 11)
+			continue;
+
+		if (v.vifBlocks.find(block))
+			continue;
+
+		// Leave room for the blocks of the current session
+		if (v.recWritePtr > (v.recReserve->GetPtrEnd() - 2 * _1mb))
+			break;
+
+		const int wl = block.wl ? block.wl : 256;
+		dVifCompile<idx>(block, block.cl < wl);
+		compiled++;
+	}
+
+	// Lookups done above are not game lookups
+	v.vifBlocks.reset_stats();
+	s_cacheDirty[idx] = false;
+
+	log_cb(RETRO_LOG_INFO, "nVif%d: Precompiled %u unpack routines from '%s'\n", idx, compiled, WX_STR(filename));
+}
+
+void dVifLoadCache(u32 crc) {
+	if (!crc)
+		return;
+
+	// VIF1 blocks are compiled on the MTVU thread, it must be idle.
+	vu1Thread.WaitVU();
+
+	dVifPrecompile<0>(crc);
+	dVifPrecompile<1>(crc);
+}
+
 _vifT __fi void dVifUnpack(const u8* data, bool isFill) {
 
 	nVifStruct&   v       = nVif[idx];
@@ -58,9 +58,15 @@ class HashBucket {
 protected:
 	std::array<nVifBlock*, hSize> m_bucket;
 
+	// Statistics, used to spot pathological collisions of the 16 bits hash_key
+	std::array<u32, hSize> m_hits;	// per bucket number of successful lookups
+	u64 m_misses;					// lookups that required a compilation
+	u64 m_probes;					// chain cells skipped over by all lookups
+
 public:
 	HashBucket() {
 		m_bucket.fill(nullptr);
+		reset_stats();
 	}
 
 	~HashBucket() { clear(); }
@@ -69,14 +75,26 @@ public:
 		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
 
 		while (true) {
-			if (chainpos->key0 == dataPtr.key0 && chainpos->key1 == dataPtr.key1)
+			if (chainpos->key0 == dataPtr.key0 && chainpos->key1 == dataPtr.key1) {
+				// The empty cell is zeroed, so a key of all zeroes lands on it and
+				// has to be accounted as a miss.
+				if (chainpos->startPtr == 0)
+					break;
+
+				m_hits[dataPtr.hash_key]++;
+				m_probes += chainpos - m_bucket[dataPtr.hash_key];
 				return chainpos;
+			}
 
 			if (chainpos->startPtr == 0)
-				return nullptr;
+				break;
 
 			chainpos++;
 		}
+
+		m_misses++;
+		m_probes += chainpos - m_bucket[dataPtr.hash_key];
+		return nullptr;
 	}
 
 	void add(const nVifBlock& dataPtr) {
@@ -118,6 +136,73 @@ public:
 	void clear() {
 		for (auto& bucket : m_bucket)
 			safe_aligned_free(bucket);
+
+		reset_stats();
+	}
+
+	void reset_stats() {
+		m_hits.fill(0);
+		m_misses = 0;
+		m_probes = 0;
+	}
+
+	// Calls func(const nVifBlock&) for every block stored in the container.
+	template< typename T >
+	void for_each(T func) const {
+		for (const nVifBlock* chainpos : m_bucket) {
+			if (!chainpos)
+				continue;
+
+			for (; chainpos->startPtr != 0; chainpos++)
+				func(*chainpos);
+		}
+	}
+
+	// Logs the chain length distribution and the lookup hit ratio. The longest chains
+	// are reported with their hit counts, so a hot bucket which degenerates into a
+	// linear search is easy to spot.
+	void print_stats(const char* name) const {
+		u32 histogram[6] = {0}; // 1, 2, 3, 4, 5-8, >8 blocks per bucket
+		u32 used = 0, blocks = 0, longest = 0, longestKey = 0;
+		u64 hits = 0;
+
+		for (u32 b = 0; b < hSize; b++) {
+			hits += m_hits[b];
+
+			if (!m_bucket[b])
+				continue;
+
+			u32 size = 0;
+			while (m_bucket[b][size].startPtr != 0)
+				size++;
+
+			if (!size)
+				continue;
+
+			used++;
+			blocks += size;
+			histogram[size <= 4 ? size - 1 : (size <= 8 ? 4 : 5)]++;
+
+			if (size > longest) {
+				longest    = size;
+				longestKey = b;
+			}
+		}
+
+		if (!blocks)
+			return;
+
+		const u64 lookups = hits + m_misses;
+
+		log_cb(RETRO_LOG_DEBUG, "%s: %u blocks in %u buckets, chains [1:%u 2:%u 3:%u 4:%u 5-8:%u >8:%u]\n",
+			name, blocks, used, histogram[0], histogram[1], histogram[2], histogram[3], histogram[4], histogram[5]);
+		log_cb(RETRO_LOG_DEBUG, "%s: %llu lookups, %.2f%% hits, %.3f probes/lookup\n",
+			name, (unsigned long long)lookups, lookups ? 100.0 * hits / lookups : 0.0,
+			lookups ? (double)m_probes / lookups : 0.0);
+
+		if (longest > 8)
+			log_cb(RETRO_LOG_WARN, "%s: bucket 0x%04x holds %u micro-programs (%u hits), hash_key collisions are degrading lookups\n",
+				name, longestKey, longest, m_hits[longestKey]);
 	}
 
 	void reset() {
@@ -16,6 +16,8 @@
 #include "PrecompiledHeader.h"
 #include "newVif_UnpackSSE.h"
 
+#include <mutex>
+
 #define xMOV8(regX, loc)	xMOVSSZX(regX, loc)
 #define xMOV16(regX, loc)	xMOVSSZX(regX, loc)
 #define xMOV32(regX, loc)	xMOVSSZX(regX, loc)
@@ -32,6 +34,8 @@ static const __aligned16 u32 SSEXYZWMask[4][4] =
 
 //static __pagealigned u8 nVifUpkExec[__pagesize*4];
 static RecompiledCodeReserve* nVifUpkExec = NULL;
+// The unpackers may be generated by a boot task ahead of the first hwReset().
+static std::mutex nVifUpkMutex;
 
 // Merges xmm vectors without modifying source reg
 void mergeVectors(xRegisterSSE dest, xRegisterSSE src, xRegisterSSE temp, int xyzw) {
@@ -420,8 +424,11 @@ static void nVifGen(int usn, int mask, int curCycle) {
 
 void VifUnpackSSE_Init()
 {
+	std::lock_guard<std::mutex> lock(nVifUpkMutex);
 	if (nVifUpkExec) return;
 
+	ScopedBootPhase phase("VIF unpack generation");
+
 #ifndef NDEBUG
 	log_cb(RETRO_LOG_DEBUG, "Generating SSE-optimized unpacking functions for VIF interpreters...\n" );
 #endif
@@ -454,5 +461,6 @@ void VifUnpackSSE_Init()
 
 void VifUnpackSSE_Destroy()
 {
+	std::lock_guard<std::mutex> lock(nVifUpkMutex);
 	safe_delete( nVifUpkExec );
 }
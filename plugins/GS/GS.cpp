@@ -36,6 +36,8 @@
 #include "Window/GSWndRetro.h"
 #include "options_tools.h"
 
+#include <chrono>
+
 static GSRenderer* s_gs = NULL;
 static void (*s_irq)() = NULL;
 static uint8* s_basemem = NULL;
@@ -200,6 +202,7 @@ static int _GSopen(const char* title, GSRendererType renderer, int threads = -1)
 				s_gs = (GSRenderer*)new GSRendererOGL();
 				break;
 			case GSRendererType::OGL_SW:
+				theApp.SetConfig("extrathreads_tiles", option_value(BOOL_PCSX2_OPT_SW_TILE_BINNING, KeyOptionBool::return_type));
 				s_gs = new GSRendererSW(threads);
 				break;
 			case GSRendererType::Null:
@@ -462,3 +465,315 @@ EXPORT_C GSsetFrameSkip(int frameskip)
 EXPORT_C GSsetExclusive(int enabled)
 {
 }
+
+static int BenchmarkRate(double units, clock_t ticks)
+{
+	return (int)(units * CLOCKS_PER_SEC / std::max<clock_t>(ticks, 1) / 1000000);
+}
+
+// Times the local memory transfer and texture unswizzle paths for every format.
+// Needs GSinit() for the vector tables, results are MB/s and Mpixels/s.
+
+EXPORT_C GSBenchmark()
+{
+	GSLocalMemory* mem = new GSLocalMemory();
+
+	static struct {int psm; const char* name;} s_format[] =
+	{
+		{PSM_PSMCT32, "32"},
+		{PSM_PSMCT24, "24"},
+		{PSM_PSMCT16, "16"},
+		{PSM_PSMCT16S, "16S"},
+		{PSM_PSMT8, "8"},
+		{PSM_PSMT4, "4"},
+		{PSM_PSMT8H, "8H"},
+		{PSM_PSMT4HL, "4HL"},
+		{PSM_PSMT4HH, "4HH"},
+		{PSM_PSMZ32, "32Z"},
+		{PSM_PSMZ24, "24Z"},
+		{PSM_PSMZ16, "16Z"},
+		{PSM_PSMZ16S, "16ZS"},
+	};
+
+	uint8* ptr = (uint8*)_aligned_malloc(1024 * 1024 * 4, 32);
+
+	for(int i = 0; i < 1024 * 1024 * 4; i++) ptr[i] = (uint8)i;
+
+	for(int tbw = 5; tbw <= 10; tbw++)
+	{
+		int n = 256 << ((10 - tbw) * 2);
+
+		int w = 1 << tbw;
+		int h = 1 << tbw;
+
+		log_cb(RETRO_LOG_INFO, "GSBenchmark: %d x %d, %d iterations\n", w, h, n);
+
+		for(size_t i = 0; i < countof(s_format); i++)
+		{
+			const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[s_format[i].psm];
+
+			GIFRegBITBLTBUF BITBLTBUF;
+
+			BITBLTBUF.SBP = 0;
+			BITBLTBUF.SBW = w / 64;
+			BITBLTBUF.SPSM = s_format[i].psm;
+			BITBLTBUF.DBP = 0;
+			BITBLTBUF.DBW = w / 64;
+			BITBLTBUF.DPSM = s_format[i].psm;
+
+			GIFRegTRXPOS TRXPOS;
+
+			TRXPOS.SSAX = 0;
+			TRXPOS.SSAY = 0;
+			TRXPOS.DSAX = 0;
+			TRXPOS.DSAY = 0;
+
+			GIFRegTRXREG TRXREG;
+
+			TRXREG.RRW = w;
+			TRXREG.RRH = h;
+
+			GSVector4i r(0, 0, w, h);
+
+			GIFRegTEXA TEXA;
+
+			TEXA.AEM = 0;
+			TEXA.TA0 = 0;
+			TEXA.TA1 = 0x80;
+
+			int trlen = w * h * psm.trbpp / 8;
+
+			const GSOffset* off = mem->GetOffset(0, w / 64, s_format[i].psm);
+
+			clock_t start, end;
+			int wr, rd, tx, txp = 0;
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				int x = 0;
+				int y = 0;
+
+				(mem->*psm.wi)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			end = clock();
+
+			wr = BenchmarkRate((double)trlen * n, end - start);
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				int x = 0;
+				int y = 0;
+
+				(mem->*psm.ri)(x, y, ptr, trlen, BITBLTBUF, TRXPOS, TRXREG);
+			}
+
+			end = clock();
+
+			rd = BenchmarkRate((double)trlen * n, end - start);
+
+			start = clock();
+
+			for(int j = 0; j < n; j++)
+			{
+				(mem->*psm.rtx)(off, r, ptr, w * 4, TEXA);
+			}
+
+			end = clock();
+
+			tx = BenchmarkRate((double)(w * h) * n, end - start);
+
+			if(psm.pal > 0)
+			{
+				start = clock();
+
+				for(int j = 0; j < n; j++)
+				{
+					(mem->*psm.rtxP)(off, r, ptr, w, TEXA);
+				}
+
+				end = clock();
+
+				txp = BenchmarkRate((double)(w * h) * n, end - start);
+			}
+
+			log_cb(RETRO_LOG_INFO, "GSBenchmark: [%4s] wi %6d ri %6d rtx %6d rtxP %6d\n", s_format[i].name, wr, rd, tx, txp);
+		}
+	}
+
+	_aligned_free(ptr);
+
+	delete mem;
+}
+
+// Stand-in for GSDrawScanline: blends a flat colour into a 2048x2048 frame buffer, so the
+// rasterizer threads do per-pixel memory work without needing a GS context.
+
+class GSBenchDrawScanline : public IDrawScanline
+{
+	static uint32* s_fb;
+
+	static void SetupPrimStub(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan)
+	{
+	}
+
+	static void __fastcall DrawScanlineStub(int pixels, int left, int top, const GSVertexSW& scan)
+	{
+		uint32* RESTRICT dst = &s_fb[top * 2048 + left];
+		const uint32 c = (uint32)(int)scan.c.x;
+
+		for(int i = 0; i < pixels; i++)
+		{
+			dst[i] = ((dst[i] >> 1) & 0x7f7f7f7f) + c;
+		}
+	}
+
+public:
+	GSBenchDrawScanline()
+	{
+		m_sp = SetupPrimStub;
+		m_ds = DrawScanlineStub;
+	}
+
+	static void SetFrameBuffer(uint32* fb) {s_fb = fb;}
+
+	void BeginDraw(const GSRasterizerData* data) {}
+	void EndDraw(uint64 frame, uint64 ticks, int actual, int total) {}
+};
+
+uint32* GSBenchDrawScanline::s_fb = NULL;
+
+// A frame of the synthetic stream: a full screen layer, a few large overlapping sprites
+// (overdraw), then batches of small ones (particles, UI).  Every 16th draw reads back one
+// queued 8 draws earlier, which waits on its fence like a target used as a source would.
+
+static void GSRasterizerBenchmarkFrame(IRasterizer* r, uint64& fence, uint32& seed)
+{
+	auto random = [&seed](int lo, int hi) {
+		seed = seed * 1103515245 + 12345;
+		return lo + (int)((seed >> 8) % (uint32)(hi - lo + 1));
+	};
+
+	const GSVector4i scissor(0, 0, 640, 448);
+
+	for(int draw = 0; draw < 160; draw++)
+	{
+		int count, lo, hi;
+
+		if(draw == 0) {count = 1; lo = hi = 0;}
+		else if(draw < 16) {count = 4; lo = 128; hi = 320;}
+		else {count = 32; lo = 8; hi = 64;}
+
+		std::shared_ptr<GSRasterizerData> data(new GSRasterizerData());
+
+		data->buff = (uint8*)_aligned_malloc(sizeof(GSVertexSW) * 2 * count, 32);
+		data->vertex = (GSVertexSW*)data->buff;
+		data->vertex_count = 2 * count;
+		data->primclass = GS_SPRITE_CLASS;
+		data->scissor = scissor;
+		data->fence = ++fence;
+
+		GSVector4i bbox = GSVector4i(INT_MAX, INT_MAX, INT_MIN, INT_MIN);
+
+		for(int i = 0; i < count; i++)
+		{
+			GSVector4i rect = draw == 0 ? scissor : GSVector4i(random(-32, 600), random(-32, 420), 0, 0);
+
+			if(draw != 0)
+			{
+				rect.z = rect.x + random(lo, hi);
+				rect.w = rect.y + random(lo, hi);
+			}
+
+			GSVertexSW* v = &data->vertex[i * 2];
+
+			memset(v, 0, sizeof(GSVertexSW) * 2);
+			v[0].p = GSVector4(rect.xyxy());
+			v[1].p = GSVector4(rect.zwzw());
+			v[0].c = GSVector4((float)random(0, 0x7f7f7f));
+			v[1].c = v[0].c;
+
+			bbox = bbox.runion(rect);
+		}
+
+		data->bbox = bbox.rintersect(scissor);
+
+		if(data->bbox.rempty())
+		{
+			continue;
+		}
+
+		r->Queue(data);
+
+		if(draw % 16 == 15)
+		{
+			r->Wait(fence - 8);
+		}
+	}
+
+	r->Sync();
+}
+
+// Runs the stream through the SW rasterizer threads split by scanline bands and by tiles.
+
+EXPORT_C GSRasterizerBenchmark()
+{
+	static const int frames = 120;
+
+	const int threads = std::max<int>(theApp.GetConfigI("extrathreads"), 2);
+	const bool tiles = theApp.GetConfigB("extrathreads_tiles");
+
+	uint32* fb = (uint32*)_aligned_malloc(2048 * 2048 * sizeof(uint32), 64);
+
+	memset(fb, 0, 2048 * 2048 * sizeof(uint32));
+
+	GSBenchDrawScanline::SetFrameBuffer(fb);
+
+	GSPerfMon perfmon;
+
+	log_cb(RETRO_LOG_INFO, "GSRasterizerBenchmark: %d threads, %d frames of 160 sprite draws at 640x448\n", threads, frames);
+
+	for(int mode = 0; mode < 2; mode++)
+	{
+		theApp.SetConfig("extrathreads_tiles", mode);
+
+		IRasterizer* r = GSRasterizerList::Create<GSBenchDrawScanline>(threads, &perfmon);
+
+		uint64 fence = 0;
+		uint32 seed = 1;
+
+		GSRasterizerBenchmarkFrame(r, fence, seed); // warm up
+
+		r->GetPixels(true);
+
+		double worst = 0;
+		double pixels = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for(int i = 0; i < frames; i++)
+		{
+			auto frame_start = std::chrono::steady_clock::now();
+
+			GSRasterizerBenchmarkFrame(r, fence, seed);
+
+			pixels += r->GetPixels(true);
+			worst = std::max(worst, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count());
+		}
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		log_cb(RETRO_LOG_INFO, "GSRasterizerBenchmark: [%5s] %.3f ms/frame (worst %.3f), %.0f pixels/frame, %.1f Mpixels/s\n",
+			mode ? "tiles" : "bands", ms / frames, worst, pixels / frames, pixels / ms / 1000);
+
+		delete r;
+	}
+
+	theApp.SetConfig("extrathreads_tiles", tiles);
+
+	_aligned_free(fb);
+}
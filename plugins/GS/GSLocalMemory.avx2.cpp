@@ -0,0 +1,369 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ *	Special Notes:
+ *
+ *	AVX2 builds of the block swizzle paths of GSLocalMemory. This file is
+ *	compiled with AVX2 enabled while the rest of GSdx targets the baseline
+ *	instruction set, the constructor only installs these when the host cpu
+ *	reports AVX2.
+ *
+ *	GSBlock is renamed so that its 256-bit statics and inlined kernels do not
+ *	collide with the baseline copies linked from the other objects.
+ *
+ */
+
+#if defined(__AVX2__)
+#define _M_SSE 0x501
+#endif
+
+#define GSBlock GSBlockAVX2
+
+#include "stdafx.h"
+#include "GSLocalMemory.h"
+
+#if _M_SSE >= 0x501
+
+#include "GSBlock.cpp"
+
+#define ASSERT_BLOCK(r, w, h) \
+	ASSERT((r).width() >= (w) && (r).height() >= (h) && !((r).left & ((w) - 1)) && !((r).top & ((h) - 1)) && !((r).right & ((w) - 1)) && !((r).bottom & ((h) - 1))); \
+
+#define FOREACH_BLOCK_START(r, w, h, bpp) \
+	ASSERT_BLOCK(r, w, h); \
+	GSVector4i _r = (r) >> 3; \
+	uint8* _dst = dst - _r.left * (bpp); \
+	int _offset = dstpitch * (h); \
+	for(int y = _r.top; y < _r.bottom; y += (h) >> 3, _dst += _offset) \
+	{ \
+		uint32 _base = off->block.row[y]; \
+		for(int x = _r.left; x < _r.right; x += (w) >> 3) \
+		{ \
+			const uint8* src = BlockPtr(_base + off->block.col[x]); \
+			uint8* read_dst = &_dst[x * (bpp)]; \
+
+#define FOREACH_BLOCK_END }}
+
+static bool IsTopLeftAligned(int dsax, int tx, int ty, int bw, int bh)
+{
+	return ((dsax & (bw-1)) == 0 && (tx & (bw-1)) == 0 && dsax == tx && (ty & (bh-1)) == 0);
+}
+
+void GSLocalMemory::InitVectorsAVX2()
+{
+	GSBlock::InitVectors();
+}
+
+void GSLocalMemory::WriteImage24AVX2(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemory::WriteImage8HAVX2(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock8H(src + (x - tx), srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemory::WriteImage4HLAVX2(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HL(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemory::WriteImage4HHAVX2(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW / 2;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock4HH(src + (x - tx) / 2, srcpitch, BlockPtr32(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+void GSLocalMemory::WriteImage24ZAVX2(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
+{
+	if(TRXREG.RRW == 0) return;
+
+	uint32 bp = BITBLTBUF.DBP;
+	uint32 bw = BITBLTBUF.DBW;
+
+	int tw = TRXPOS.DSAX + TRXREG.RRW, srcpitch = TRXREG.RRW * 3;
+	int th = len / srcpitch;
+
+	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
+
+	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
+	{
+		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
+	}
+	else
+	{
+		th += ty;
+
+		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
+		{
+			for(int x = tx; x < tw; x += 8)
+			{
+				GSBlock::UnpackAndWriteBlock24(src + (x - tx) * 3, srcpitch, BlockPtr32Z(x, y, bp, bw));
+			}
+		}
+
+		ty = th;
+	}
+}
+
+///////////////////
+
+void GSLocalMemory::ReadTexture32AVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlock::ReadBlock32(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemory::ReadTexture24AVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if(TEXA.AEM)
+	{
+		FOREACH_BLOCK_START(r, 8, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock24<true>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+	else
+	{
+		FOREACH_BLOCK_START(r, 8, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock24<false>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+}
+
+void GSLocalMemory::ReadTexture16AVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if(TEXA.AEM)
+	{
+		FOREACH_BLOCK_START(r, 16, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock16<true>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+	else
+	{
+		FOREACH_BLOCK_START(r, 16, 8, 32)
+		{
+			GSBlock::ReadAndExpandBlock16<false>(src, read_dst, dstpitch, TEXA);
+		}
+		FOREACH_BLOCK_END
+	}
+}
+
+void GSLocalMemory::ReadTexture8HPAVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock8HP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemory::ReadTexture4HLPAVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock4HLP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemory::ReadTexture4HHPAVX2(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 8)
+	{
+		GSBlock::ReadBlock4HHP(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+///////////////////
+
+void GSLocalMemory::ReadTextureBlock32AVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock32(BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemory::ReadTextureBlock24AVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	if(TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock24<true>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock24<false>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+void GSLocalMemory::ReadTextureBlock16AVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	if(TEXA.AEM)
+	{
+		GSBlock::ReadAndExpandBlock16<true>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+	else
+	{
+		GSBlock::ReadAndExpandBlock16<false>(BlockPtr(bp), dst, dstpitch, TEXA);
+	}
+}
+
+void GSLocalMemory::ReadTextureBlock8HPAVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock8HP(BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemory::ReadTextureBlock4HLPAVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HLP(BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemory::ReadTextureBlock4HHPAVX2(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	ALIGN_STACK(32);
+
+	GSBlock::ReadBlock4HHP(BlockPtr(bp), dst, dstpitch);
+}
+
+#endif
@@ -27,6 +27,9 @@
 #include "stdafx.h"
 #include "GSLocalMemory.h"
 #include "GSdx.h"
+#ifdef GSDX_RUNTIME_AVX2
+#include "xbyak/xbyak_util.h"
+#endif
 
 #define ASSERT_BLOCK(r, w, h) \
 	ASSERT((r).width() >= (w) && (r).height() >= (h) && !((r).left & ((w) - 1)) && !((r).top & ((h) - 1)) && !((r).right & ((w) - 1)) && !((r).bottom & ((h) - 1))); \
@@ -418,6 +421,49 @@ GSLocalMemory::GSLocalMemory()
 	m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
 	m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
 
+#ifdef GSDX_RUNTIME_AVX2
+	if(Xbyak::util::Cpu().has(Xbyak::util::Cpu::tAVX2))
+	{
+		// the aligned block paths have 256-bit versions in GSLocalMemory.avx2.cpp
+
+		InitVectorsAVX2();
+
+		m_psm[PSM_PSMCT24].wi = &GSLocalMemory::WriteImage24AVX2;
+		m_psm[PSM_PSMT8H].wi = &GSLocalMemory::WriteImage8HAVX2;
+		m_psm[PSM_PSMT4HL].wi = &GSLocalMemory::WriteImage4HLAVX2;
+		m_psm[PSM_PSMT4HH].wi = &GSLocalMemory::WriteImage4HHAVX2;
+		m_psm[PSM_PSMZ24].wi = &GSLocalMemory::WriteImage24ZAVX2;
+
+		for(size_t i = 0; i < countof(m_psm); i++)
+		{
+			if(m_psm[i].rtx == &GSLocalMemory::ReadTexture32) m_psm[i].rtx = &GSLocalMemory::ReadTexture32AVX2;
+			if(m_psm[i].rtxP == &GSLocalMemory::ReadTexture32) m_psm[i].rtxP = &GSLocalMemory::ReadTexture32AVX2;
+			if(m_psm[i].rtxb == &GSLocalMemory::ReadTextureBlock32) m_psm[i].rtxb = &GSLocalMemory::ReadTextureBlock32AVX2;
+			if(m_psm[i].rtxbP == &GSLocalMemory::ReadTextureBlock32) m_psm[i].rtxbP = &GSLocalMemory::ReadTextureBlock32AVX2;
+		}
+
+		m_psm[PSM_PSMCT24].rtx = m_psm[PSM_PSMCT24].rtxP = &GSLocalMemory::ReadTexture24AVX2;
+		m_psm[PSM_PSMZ24].rtx = m_psm[PSM_PSMZ24].rtxP = &GSLocalMemory::ReadTexture24AVX2;
+		m_psm[PSM_PSMCT16].rtx = m_psm[PSM_PSMCT16].rtxP = &GSLocalMemory::ReadTexture16AVX2;
+		m_psm[PSM_PSMCT16S].rtx = m_psm[PSM_PSMCT16S].rtxP = &GSLocalMemory::ReadTexture16AVX2;
+		m_psm[PSM_PSMZ16].rtx = m_psm[PSM_PSMZ16].rtxP = &GSLocalMemory::ReadTexture16AVX2;
+		m_psm[PSM_PSMZ16S].rtx = m_psm[PSM_PSMZ16S].rtxP = &GSLocalMemory::ReadTexture16AVX2;
+		m_psm[PSM_PSMT8H].rtxP = &GSLocalMemory::ReadTexture8HPAVX2;
+		m_psm[PSM_PSMT4HL].rtxP = &GSLocalMemory::ReadTexture4HLPAVX2;
+		m_psm[PSM_PSMT4HH].rtxP = &GSLocalMemory::ReadTexture4HHPAVX2;
+
+		m_psm[PSM_PSMCT24].rtxb = m_psm[PSM_PSMCT24].rtxbP = &GSLocalMemory::ReadTextureBlock24AVX2;
+		m_psm[PSM_PSMZ24].rtxb = m_psm[PSM_PSMZ24].rtxbP = &GSLocalMemory::ReadTextureBlock24AVX2;
+		m_psm[PSM_PSMCT16].rtxb = m_psm[PSM_PSMCT16].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX2;
+		m_psm[PSM_PSMCT16S].rtxb = m_psm[PSM_PSMCT16S].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX2;
+		m_psm[PSM_PSMZ16].rtxb = m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX2;
+		m_psm[PSM_PSMZ16S].rtxb = m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX2;
+		m_psm[PSM_PSMT8H].rtxbP = &GSLocalMemory::ReadTextureBlock8HPAVX2;
+		m_psm[PSM_PSMT4HL].rtxbP = &GSLocalMemory::ReadTextureBlock4HLPAVX2;
+		m_psm[PSM_PSMT4HH].rtxbP = &GSLocalMemory::ReadTextureBlock4HHPAVX2;
+	}
+#endif
+
 	m_psm[PSM_PSGPU24].bpp = 16;
 	m_psm[PSM_PSMCT16].bpp = m_psm[PSM_PSMCT16S].bpp = 16;
 	m_psm[PSM_PSMT8].bpp = 8;
@@ -28,6 +28,7 @@ GSPerfMon::GSPerfMon()
 	memset(m_stats, 0, sizeof(m_stats));
 	memset(m_total, 0, sizeof(m_total));
 	memset(m_begin, 0, sizeof(m_begin));
+	memset(&m_sync, 0, sizeof(m_sync));
 }
 
 void GSPerfMon::Put(counter_t c, double val)
@@ -38,6 +39,18 @@ void GSPerfMon::Update()
 {
 }
 
+GSPerfMon::SyncStats GSPerfMon::GetSync(bool reset)
+{
+	SyncStats stats = m_sync;
+
+	if(reset)
+	{
+		memset(&m_sync, 0, sizeof(m_sync));
+	}
+
+	return stats;
+}
+
 void GSPerfMon::Start(int timer)
 {
 }
@@ -39,10 +39,23 @@ public:
 		CounterLast,
 	};
 
+	enum sync_t
+	{
+		SyncReset, SyncVSync, SyncOutput, SyncSource, SyncTarget, SyncVideoMem, SyncLocalMem,
+		SyncLast,
+	};
+
+	struct SyncStats
+	{
+		uint32 full[SyncLast]; // waited for every queued draw
+		uint32 fence[SyncLast]; // waited only for the draws touching the conflicting pages
+	};
+
 protected:
 	double m_stats[CounterLast];
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
 	uint64 m_frame;
+	SyncStats m_sync;
 
 	friend class GSPerfMonAutoTimer;
 
@@ -56,6 +69,9 @@ public:
 	double Get(counter_t c) {return m_stats[c];}
 	void Update();
 
+	void PutSync(sync_t reason, bool fence) {(fence ? m_sync.fence : m_sync.full)[reason]++;}
+	SyncStats GetSync(bool reset = true);
+
 	void Start(int timer = Main);
 	void Stop(int timer = Main);
 	int CPU(int timer = Main, bool reset = true);
@@ -29,6 +29,7 @@ template<class T, int CAPACITY> class GSJobQueue final
 private:
 	std::thread m_thread;
 	std::function<void(T&)> m_func;
+	std::function<void()> m_init;
 	bool m_exit;
 	ringbuffer_base<T, CAPACITY> m_queue;
 
@@ -36,8 +37,12 @@ private:
 	std::mutex m_wait_lock;
 	std::condition_variable m_empty;
 	std::condition_variable m_notempty;
+	std::atomic<int> m_waiters; // in WaitUntil, m_empty is then signalled after every job
 
 	void ThreadProc() {
+		if (m_init)
+			m_init();
+
 		std::unique_lock<std::mutex> l(m_lock);
 
 		while (true) {
@@ -51,22 +56,33 @@ private:
 
 			l.unlock();
 
-			while (m_queue.consume_one(*this))
-				;
+			while (m_queue.consume_one(*this)) {
+				// pairs with the one in WaitUntil: either we see the waiter or it sees the job done
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (m_waiters.load(std::memory_order_relaxed) > 0) {
+					{
+						std::lock_guard<std::mutex> wait_guard(m_wait_lock);
+					}
+					m_empty.notify_all();
+				}
+			}
 
 			{
 				std::lock_guard<std::mutex> wait_guard(m_wait_lock);
 			}
-			m_empty.notify_one();
+			m_empty.notify_all();
 
 			l.lock();
 		}
 	}
 
 public:
-	GSJobQueue(std::function<void(T&)> func) :
+	// init runs on the worker thread before it takes any job.
+	GSJobQueue(std::function<void(T&)> func, std::function<void()> init = nullptr) :
 		m_func(func),
-		m_exit(false)
+		m_init(init),
+		m_exit(false),
+		m_waiters(0)
 	{
 		m_thread = std::thread(&GSJobQueue::ThreadProc, this);
 	}
@@ -109,6 +125,21 @@ public:
 		assert(IsEmpty());
 	}
 
+	// Blocks until done() holds or the queue ran dry.  done() must only change as jobs
+	// finish.
+	template<class Pred> void WaitUntil(Pred done)
+	{
+		if (IsEmpty() || done())
+			return;
+
+		std::unique_lock<std::mutex> l(m_wait_lock);
+		m_waiters++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (!IsEmpty() && !done())
+			m_empty.wait(l);
+		m_waiters--;
+	}
+
 	void operator() (T& item) {
 		m_func(item);
 	}
@@ -45,12 +45,12 @@ public:
 
 	static void InitVectors();
 
-	__forceinline GSVector4i()
+	// constexpr so that default constructed statics are constant initialized
+	// and do not need a dynamic initializer built for the translation unit's isa
+
+	constexpr GSVector4i()
+		: u64{0, 0}
 	{
-		x = 0;
-		y = 0;
-		z = 0;
-		w = 0;
 	}
 
 	__forceinline GSVector4i(int x, int y, int z, int w)
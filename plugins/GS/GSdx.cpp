@@ -69,6 +69,7 @@ void GSdxApp::Init()
 	m_current_configuration["dump"]                                       = "0";
 	m_current_configuration["extrathreads"]                               = "2";
 	m_current_configuration["extrathreads_height"]                        = "4";
+	m_current_configuration["extrathreads_tiles"]                         = "0";
 	m_current_configuration["filter"]                                     = std::to_string(static_cast<int8>(BiFiltering::PS2));
 	m_current_configuration["force_texture_clear"]                        = "0";
 	m_current_configuration["fxaa"]                                       = "0";
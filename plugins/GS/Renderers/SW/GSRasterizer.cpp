@@ -39,11 +39,33 @@ static int compute_best_thread_height(int threads) {
 		return 4;
 }
 
+// Tile binning splits the 2048x2048 address space into 64x64 tiles and hands each
+// worker a fixed set of them, so a worker keeps revisiting the same frame/z pages.
+// Tiles are dealt out diagonally, neighbours never belong to the same worker.
+
+#define TILE_SHIFT 6
+#define TILE_SIZE (1 << TILE_SHIFT)
+#define TILE_ROW (2048 >> TILE_SHIFT)
+
+// GSRasterizerList::Queue keeps the owners of a draw in a 32-bit mask with room for "all".
+
+static bool use_tile_binning(int threads)
+{
+	return threads > 1 && threads < 32 && theApp.GetConfigB("extrathreads_tiles");
+}
+
+static int tile_owner(int x, int y, int threads)
+{
+	return (x + y) % threads;
+}
+
 GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* perfmon)
 	: m_perfmon(perfmon)
 	, m_ds(ds)
 	, m_id(id)
 	, m_threads(threads)
+	, m_tile(NULL)
+	, m_fence(0)
 {
 	memset(&m_pixels, 0, sizeof(m_pixels));
 
@@ -55,6 +77,25 @@ GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* pe
 	int rows = (2048 >> m_thread_height) + 16;
 	m_scanline = (uint8*)_aligned_malloc(rows, 64);
 
+	if(use_tile_binning(threads))
+	{
+		// every scanline may cross one of our tiles, DrawScanline does the horizontal split
+
+		memset(m_scanline, 1, rows);
+
+		m_tile = (uint8*)_aligned_malloc(TILE_ROW * TILE_ROW, 64);
+
+		for(int y = 0; y < TILE_ROW; y++)
+		{
+			for(int x = 0; x < TILE_ROW; x++)
+			{
+				m_tile[y * TILE_ROW + x] = tile_owner(x, y, threads) == id ? 1 : 0;
+			}
+		}
+
+		return;
+	}
+
 	int row = 0;
 
 	while(row < rows)
@@ -70,6 +111,8 @@ GSRasterizer::~GSRasterizer()
 {
 	_aligned_free(m_scanline);
 
+	if(m_tile != NULL) _aligned_free(m_tile);
+
 	if(m_edge.buff != NULL) vmfree(m_edge.buff, sizeof(GSVertexSW) * 2048);
 
 	delete m_ds;
@@ -250,7 +293,7 @@ void GSRasterizer::DrawPoint(const GSVertexSW* vertex, int vertex_count, const u
 			{
 				if(IsOneOfMyScanlines(p.y))
 				{
-					m_ds->SetupPrim(vertex, index, GSVertexSW::zero());
+					SetupPrim(vertex, index, GSVertexSW::zero());
 
 					DrawScanline(1, p.x, p.y, v);
 				}
@@ -271,7 +314,7 @@ void GSRasterizer::DrawPoint(const GSVertexSW* vertex, int vertex_count, const u
 			{
 				if(IsOneOfMyScanlines(p.y))
 				{
-					m_ds->SetupPrim(vertex, tmp_index, GSVertexSW::zero());
+					SetupPrim(vertex, tmp_index, GSVertexSW::zero());
 
 					DrawScanline(1, p.x, p.y, v);
 				}
@@ -337,7 +380,7 @@ void GSRasterizer::DrawLine(const GSVertexSW* vertex, const uint32* index)
 
 					scan += dscan * (l - scan.p).xxxx();
 
-					m_ds->SetupPrim(vertex, index, dscan);
+					SetupPrim(vertex, index, dscan);
 
 					DrawScanline(pixels, left, p.y, scan);
 				}
@@ -810,6 +853,28 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const uint32* index)
 			m_pixels.actual += pixels;
 			m_pixels.total += pixels;
 		}
+		else if(m_tile != NULL)
+		{
+			for(int y = r.top & ~(TILE_SIZE - 1); y < r.bottom; y += TILE_SIZE)
+			{
+				const uint8* RESTRICT tile = &m_tile[(y >> TILE_SHIFT) * TILE_ROW];
+
+				for(int x = r.left & ~(TILE_SIZE - 1); x < r.right; x += TILE_SIZE)
+				{
+					if(tile[x >> TILE_SHIFT])
+					{
+						GSVector4i tr = r.rintersect(GSVector4i(x, y, x + TILE_SIZE, y + TILE_SIZE));
+
+						m_ds->DrawRect(tr, scan);
+
+						int pixels = tr.width() * tr.height();
+
+						m_pixels.actual += pixels;
+						m_pixels.total += pixels;
+					}
+				}
+			}
+		}
 		else
 		{
 			int top = FindMyNextScanline(r.top);
@@ -842,7 +907,9 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const uint32* index)
 	GSVertexSW dscan;
 
 	dedge.t = GSVector4::zero().insert32<1, 1>(dt);
+	dscan.p = GSVector4::zero();
 	dscan.t = GSVector4::zero().insert32<0, 0>(dt);
+	dscan.c = GSVector4::zero();
 
 	GSVector4 prestep = GSVector4(r.left, r.top) - scan.p;
 
@@ -851,7 +918,7 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const uint32* index)
 	if((m & 2) == 0) scan.t += dedge.t * prestep.yyyy();
 	if((m & 1) == 0) scan.t += dscan.t * prestep.xxxx();
 
-	m_ds->SetupPrim(vertex, index, dscan);
+	SetupPrim(vertex, index, dscan);
 
 	while(1)
 	{
@@ -1057,6 +1124,13 @@ void GSRasterizer::DrawEdge(const GSVertexSW& v0, const GSVertexSW& v1, const GS
 	m_edge.count += e - &m_edge.buff[m_edge.count];
 }
 
+void GSRasterizer::SetupPrim(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan)
+{
+	m_dscan = dscan;
+
+	m_ds->SetupPrim(vertex, index, dscan);
+}
+
 void GSRasterizer::AddScanline(GSVertexSW* e, int pixels, int left, int top, const GSVertexSW& scan)
 {
 	*e = scan;
@@ -1074,7 +1148,7 @@ void GSRasterizer::Flush(const GSVertexSW* vertex, const uint32* index, const GS
 
 	if(count > 0)
 	{
-		m_ds->SetupPrim(vertex, index, dscan);
+		SetupPrim(vertex, index, dscan);
 
 		const GSVertexSW* RESTRICT e = m_edge.buff;
 		const GSVertexSW* RESTRICT ee = e + count;
@@ -1115,6 +1189,41 @@ void GSRasterizer::Flush(const GSVertexSW* vertex, const uint32* index, const GS
 #endif
 
 void GSRasterizer::DrawScanline(int pixels, int left, int top, const GSVertexSW& scan)
+{
+	if(m_tile == NULL)
+	{
+		DrawScanlineSpan(pixels, left, top, scan);
+
+		return;
+	}
+
+	// cut the span at tile boundaries and only draw the parts in our tiles
+
+	const uint8* RESTRICT tile = &m_tile[(top >> TILE_SHIFT) * TILE_ROW];
+
+	int right = left + pixels;
+
+	for(int x = left; x < right; )
+	{
+		int next = std::min<int>((x + TILE_SIZE) & ~(TILE_SIZE - 1), right);
+
+		if(tile[x >> TILE_SHIFT])
+		{
+			if(x == left)
+			{
+				DrawScanlineSpan(next - x, x, top, scan);
+			}
+			else
+			{
+				DrawScanlineSpan(next - x, x, top, scan + m_dscan * GSVector4((float)(x - left)));
+			}
+		}
+
+		x = next;
+	}
+}
+
+void GSRasterizer::DrawScanlineSpan(int pixels, int left, int top, const GSVertexSW& scan)
 {
 	m_pixels.actual += pixels;
 	m_pixels.total += ((left + pixels + (PIXELS_PER_LOOP - 1)) & ~(PIXELS_PER_LOOP - 1)) - (left & (PIXELS_PER_LOOP - 1));
@@ -1127,6 +1236,11 @@ void GSRasterizer::DrawScanline(int pixels, int left, int top, const GSVertexSW&
 
 void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& scan)
 {
+	if(m_tile != NULL && m_tile[(top >> TILE_SHIFT) * TILE_ROW + (left >> TILE_SHIFT)] == 0)
+	{
+		return;
+	}
+
 	m_pixels.actual += 1;
 	m_pixels.total += PIXELS_PER_LOOP - 1;
 
@@ -1139,9 +1253,23 @@ void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& sca
 
 GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 	: m_perfmon(perfmon)
+	, m_tile(NULL)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
+	if(use_tile_binning(threads))
+	{
+		m_tile = (uint8*)_aligned_malloc(TILE_ROW * TILE_ROW, 64);
+
+		for(int y = 0; y < TILE_ROW; y++)
+		{
+			for(int x = 0; x < TILE_ROW; x++)
+			{
+				m_tile[y * TILE_ROW + x] = (uint8)tile_owner(x, y, threads);
+			}
+		}
+	}
+
 	int rows = (2048 >> m_thread_height) + 16;
 	m_scanline = (uint8*)_aligned_malloc(rows, 64);
 
@@ -1159,6 +1287,8 @@ GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 GSRasterizerList::~GSRasterizerList()
 {
 	_aligned_free(m_scanline);
+
+	if(m_tile != NULL) _aligned_free(m_tile);
 }
 
 void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
@@ -1167,6 +1297,34 @@ void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 
 	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
 
+	if(m_tile != NULL)
+	{
+		// bin the draw: only the workers owning a tile under the bounding box get it
+
+		uint32 all = (1u << m_workers.size()) - 1;
+		uint32 mask = 0;
+
+		for(int y = r.top >> TILE_SHIFT; (y << TILE_SHIFT) < r.bottom && mask != all; y++)
+		{
+			const uint8* RESTRICT tile = &m_tile[y * TILE_ROW];
+
+			for(int x = r.left >> TILE_SHIFT; (x << TILE_SHIFT) < r.right && mask != all; x++)
+			{
+				mask |= 1u << tile[x];
+			}
+		}
+
+		for(size_t i = 0; i < m_workers.size(); i++)
+		{
+			if(mask & (1u << i))
+			{
+				m_workers[i]->Push(data);
+			}
+		}
+
+		return;
+	}
+
 	int top = r.top >> m_thread_height;
 	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
 
@@ -1189,6 +1347,20 @@ void GSRasterizerList::Sync()
 	}
 }
 
+void GSRasterizerList::Wait(uint64 fence)
+{
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		// the queue is drawn in order, the worker is past the fence when it drew a later one or ran dry
+
+		GSRasterizer* r = m_r[i].get();
+
+		m_workers[i]->WaitUntil([r, fence]() {return r->GetFence() >= fence;});
+	}
+
+	m_perfmon->Put(GSPerfMon::SyncPoint, 1);
+}
+
 bool GSRasterizerList::IsSynced() const
 {
 	for(size_t i = 0; i < m_workers.size(); i++)
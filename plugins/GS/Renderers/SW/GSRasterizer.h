@@ -26,6 +26,7 @@
 #include "GSAlignedClass.h"
 #include "GSPerfMon.h"
 #include "GSThread_CXX11.h"
+#include "Utilities/ThreadPlacement.h"
 
 class alignas(32) GSRasterizerData : public GSAlignedClass<32>
 {
@@ -44,6 +45,7 @@ public:
 	uint64 start;
 	int pixels;
 	int counter;
+	uint64 fence; // queue order of the draw, see IRasterizer::Wait
 
 	GSRasterizerData() 
 		: scissor(GSVector4i::zero())
@@ -57,6 +59,7 @@ public:
 		, frame(0)
 		, start(0)
 		, pixels(0)
+		, fence(0)
 	{
 		counter = s_counter++;
 	}
@@ -114,6 +117,7 @@ public:
 
 	virtual void Queue(const std::shared_ptr<GSRasterizerData>& data) = 0;
 	virtual void Sync() = 0;
+	virtual void Wait(uint64 fence) = 0; // until every draw queued with a fence at or below this one has finished
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 };
@@ -127,11 +131,14 @@ protected:
 	int m_threads;
 	int m_thread_height;
 	uint8* m_scanline;
+	uint8* m_tile; // tile binning: non-zero for the tiles owned by this rasterizer, NULL when splitting by scanline bands
 	GSVector4i m_scissor;
 	GSVector4 m_fscissor_x;
 	GSVector4 m_fscissor_y;
+	GSVertexSW m_dscan;
 	struct {GSVertexSW* buff; int count;} m_edge;
 	struct {int sum, actual, total;} m_pixels;
+	std::atomic<uint64> m_fence; // last fence drawn by this rasterizer
 
 	typedef void (GSRasterizer::*DrawPrimPtr)(const GSVertexSW* v, int count);
 
@@ -149,10 +156,12 @@ protected:
 
 	void DrawEdge(const GSVertexSW& v0, const GSVertexSW& v1, const GSVertexSW& dv, int orientation, int side);
 
+	__forceinline void SetupPrim(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan);
 	__forceinline void AddScanline(GSVertexSW* e, int pixels, int left, int top, const GSVertexSW& scan);
 	__forceinline void Flush(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan, bool edge = false);
 
 	__forceinline void DrawScanline(int pixels, int left, int top, const GSVertexSW& scan);
+	__forceinline void DrawScanlineSpan(int pixels, int left, int top, const GSVertexSW& scan);
 	__forceinline void DrawEdge(int pixels, int left, int top, const GSVertexSW& scan);
 
 public:
@@ -165,10 +174,14 @@ public:
 
 	void Draw(GSRasterizerData* data);
 
+	void SetFence(uint64 fence) {m_fence.store(fence, std::memory_order_release);}
+	uint64 GetFence() const {return m_fence.load(std::memory_order_acquire);}
+
 	// IRasterizer
 
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync() {}
+	void Wait(uint64 fence) {}
 	bool IsSynced() const {return true;}
 	int GetPixels(bool reset);
 };
@@ -183,6 +196,7 @@ protected:
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
 	std::vector<std::unique_ptr<GSWorker>> m_workers;
 	uint8* m_scanline;
+	uint8* m_tile; // tile binning: worker index of each tile, NULL when splitting by scanline bands
 	int m_thread_height;
 
 	GSRasterizerList(int threads, GSPerfMon* perfmon);
@@ -206,7 +220,8 @@ public:
 			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
 			auto &r = *rl->m_r[i];
 			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
+				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); r.SetFence(item->fence); },
+				[i]() { Threading::PlaceCurrentThread(Threading::ThreadRole::GSWorker, i); })));
 		}
 
 		return rl;
@@ -216,6 +231,7 @@ public:
 
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync();
+	void Wait(uint64 fence);
 	bool IsSynced() const;
 	int GetPixels(bool reset);
 };
@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "GSRendererSW.h"
+#include "options_tools.h"
 
 GSVector4 GSRendererSW::m_pos_scale;
 #if _M_SSE >= 0x501
@@ -38,6 +39,8 @@ void GSRendererSW::InitVectors()
 
 GSRendererSW::GSRendererSW(int threads)
 	: m_fzb(NULL)
+	, m_fence(0)
+	, m_sync_ticks(0)
 {
 	m_nativeres = true; // ignore ini, sw is always native
 
@@ -56,6 +59,8 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(m_fence_pages, 0, sizeof(m_fence_pages));
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -95,7 +100,7 @@ GSRendererSW::~GSRendererSW()
 
 void GSRendererSW::Reset()
 {
-	Sync(-1);
+	Sync(GSPerfMon::SyncReset);
 
 	m_tc->RemoveAll();
 
@@ -104,7 +109,7 @@ void GSRendererSW::Reset()
 
 void GSRendererSW::VSync(int field)
 {
-	Sync(0); // IncAge might delete a cached texture in use
+	Sync(GSPerfMon::SyncVSync); // IncAge might delete a cached texture in use
 
 	/*
 	int draw[8], sum = 0;
@@ -125,6 +130,30 @@ void GSRendererSW::VSync(int field)
 
 	GSRenderer::VSync(field);
 
+	if((m_perfmon.GetFrame() % 60) == 0)
+	{
+		GSTextureCacheSW::Stats tcs = m_tc->GetStats();
+
+		log_cb(RETRO_LOG_DEBUG, "SW texture cache: lookup %llu invalidate %llu kticks/frame, %u lookups %u misses\n",
+			(unsigned long long)(tcs.lookup / 60000), (unsigned long long)(tcs.invalidate / 60000), tcs.lookups / 60, tcs.misses / 60);
+
+		log_cb(RETRO_LOG_DEBUG, "SW rasterizer (%s): sync %llu kticks/frame\n",
+			theApp.GetConfigB("extrathreads_tiles") ? "tiles" : "bands", (unsigned long long)(m_sync_ticks / 60000));
+
+		GSPerfMon::SyncStats ss = m_perfmon.GetSync();
+
+		log_cb(RETRO_LOG_DEBUG, "SW rasterizer syncs (full/fenced): reset %u/%u vsync %u/%u output %u/%u source %u/%u target %u/%u vmem %u/%u lmem %u/%u\n",
+			ss.full[GSPerfMon::SyncReset], ss.fence[GSPerfMon::SyncReset],
+			ss.full[GSPerfMon::SyncVSync], ss.fence[GSPerfMon::SyncVSync],
+			ss.full[GSPerfMon::SyncOutput], ss.fence[GSPerfMon::SyncOutput],
+			ss.full[GSPerfMon::SyncSource], ss.fence[GSPerfMon::SyncSource],
+			ss.full[GSPerfMon::SyncTarget], ss.fence[GSPerfMon::SyncTarget],
+			ss.full[GSPerfMon::SyncVideoMem], ss.fence[GSPerfMon::SyncVideoMem],
+			ss.full[GSPerfMon::SyncLocalMem], ss.fence[GSPerfMon::SyncLocalMem]);
+
+		m_sync_ticks = 0;
+	}
+
 	m_tc->IncAge();
 }
 
@@ -140,7 +169,7 @@ void GSRendererSW::ResetDevice()
 
 GSTexture* GSRendererSW::GetOutput(int i, int& y_offset)
 {
-	Sync(1);
+	Sync(GSPerfMon::SyncOutput);
 
 	const GSRegDISPFB& DISPFB = m_regs->DISP[i].DISPFB;
 
@@ -419,19 +448,15 @@ void GSRendererSW::Draw()
 
 	// check if there is an overlap between this and previous targets
 
-	if(CheckTargetPages(fb_pages, zb_pages, r))
-	{
-		sd->m_syncpoint = SharedData::SyncTarget;
-	}
+	sd->m_sync_target = CheckTargetPages(fb_pages, zb_pages, r);
 
 	// check if the texture is not part of a target currently in use
 
-	if(CheckSourcePages(sd))
-	{
-		sd->m_syncpoint = SharedData::SyncSource;
-	}
+	sd->m_sync_source = CheckSourcePages(sd);
+
+	// addref source and target pages, they are fenced by this draw from now on
 
-	// addref source and target pages
+	sd->fence = ++m_fence;
 
 	sd->UsePages(fb_pages, m_context->offset.fb->psm, zb_pages, m_context->offset.zb->psm);
 
@@ -446,18 +471,18 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 {
 	SharedData* sd = (SharedData*)item.get();
 
-	if(sd->m_syncpoint == SharedData::SyncSource) 
+	if(sd->m_sync_source != 0)
 	{
-		Sync(4);
+		Wait(GSPerfMon::SyncSource, sd->m_sync_source);
 	}
 
 	// update previously invalidated parts
 
 	sd->UpdateSource();
 
-	if(sd->m_syncpoint == SharedData::SyncTarget)
+	if(sd->m_sync_target > sd->m_sync_source)
 	{
-		Sync(5);
+		Wait(GSPerfMon::SyncTarget, sd->m_sync_target);
 	}
 
 	m_rl->Queue(item);
@@ -477,7 +502,7 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 	}
 }
 
-void GSRendererSW::Sync(int reason)
+void GSRendererSW::Sync(GSPerfMon::sync_t reason)
 {
 	//printf("sync %d\n", reason);
 
@@ -489,11 +514,32 @@ void GSRendererSW::Sync(int reason)
 
 	t = __rdtsc() - t;
 
+	m_sync_ticks += t;
+
+	m_perfmon.PutSync(reason, false);
+
 	int pixels = m_rl->GetPixels();
 
 	m_perfmon.Put(GSPerfMon::Fillrate, pixels);
 }
 
+void GSRendererSW::Wait(GSPerfMon::sync_t reason, uint64 fence)
+{
+	// only the draws up to the fence have to finish, the rest of the queue keeps running
+
+	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
+
+	uint64 t = __rdtsc();
+
+	m_rl->Wait(fence);
+
+	t = __rdtsc() - t;
+
+	m_sync_ticks += t;
+
+	m_perfmon.PutSync(reason, true);
+}
+
 void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r)
 {
 	GSOffset* off = m_mem.GetOffset(BITBLTBUF.DBP, BITBLTBUF.DBW, BITBLTBUF.DPSM);
@@ -504,18 +550,23 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 	if(!m_rl->IsSynced())
 	{
+		uint64 fence = 0;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
 			if(m_fzb_pages[*p] | m_tex_pages[*p])
 			{
-				Sync(6);
-
-				break;
+				fence = std::max<uint64>(fence, m_fence_pages[*p]);
 			}
 		}
+
+		if(fence != 0)
+		{
+			Wait(GSPerfMon::SyncVideoMem, fence);
+		}
 	}
 
-	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
+	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and the target wait happens then this must come later
 }
 
 void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut)
@@ -526,21 +577,27 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 		off->GetPages(r, m_tmp_pages);
 
+		uint64 fence = 0;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
 			if(m_fzb_pages[*p])
 			{
-				Sync(7);
-
-				break;
+				fence = std::max<uint64>(fence, m_fence_pages[*p]);
 			}
 		}
+
+		if(fence != 0)
+		{
+			Wait(GSPerfMon::SyncLocalMem, fence);
+		}
 	}
 }
 
 void GSRendererSW::UsePages(const uint32* pages, const int type)
 {
 	for(const uint32* p = pages; *p != GSOffset::EOP; p++) {
+		m_fence_pages[*p] = m_fence;
 		switch (type) {
 			case 0:
 				ASSERT((m_fzb_pages[*p] & 0xFFFF) < USHRT_MAX);
@@ -580,14 +637,14 @@ void GSRendererSW::ReleasePages(const uint32* pages, const int type)
 	}
 }
 
-bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
+uint64 GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
 {
 	bool synced = m_rl->IsSynced();
 
 	bool fb = fb_pages != NULL;
 	bool zb = zb_pages != NULL;
 
-	bool res = false;
+	uint64 res = 0;
 
 	if(m_fzb != m_context->offset.fzb4)
 	{
@@ -601,7 +658,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 		memset(m_fzb_cur_pages, 0, sizeof(m_fzb_cur_pages));
 
-		uint32 used = 0;
+		uint64 used = 0;
 
 		for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 		{
@@ -612,8 +669,8 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			if(m_fzb_pages[i] | m_tex_pages[i])
+				used = std::max<uint64>(used, m_fence_pages[i]);
 		}
 
 		for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
@@ -625,14 +682,13 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			if(m_fzb_pages[i] | m_tex_pages[i])
+				used = std::max<uint64>(used, m_fence_pages[i]);
 		}
 
 		if(!synced)
 		{
-			if(used)
-				res = true;
+			res = used;
 		}
 	}
 	else
@@ -652,7 +708,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			if(fb_pages == NULL) fb_pages = m_context->offset.fb->GetPages(r);
 			if(zb_pages == NULL) zb_pages = m_context->offset.zb->GetPages(r);
 
-			uint32 used = 0;
+			uint64 used = 0;
 
 			for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 			{
@@ -665,7 +721,8 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(m_fzb_pages[i])
+						used = std::max<uint64>(used, m_fence_pages[i]);
 				}
 			}
 
@@ -680,14 +737,14 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(m_fzb_pages[i])
+						used = std::max<uint64>(used, m_fence_pages[i]);
 				}
 			}
 
 			if(!synced)
 			{
-				if(used)
-					res = true;
+				res = used;
 			}
 		}
 
@@ -696,27 +753,24 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			// chross-check frame and z-buffer pages, they cannot overlap with eachother and with previous batches in queue,
 			// have to be careful when the two buffers are mutually enabled/disabled and alternating (Bully FBP/ZBP = 0x2300)
 
-			if(fb && !res)
+			if(fb)
 			{
 				for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0xffff0000)
 					{
-						res = true;
-						break;
+						res = std::max<uint64>(res, m_fence_pages[*p]);
 					}
 				}
 			}
 
-			if(zb && !res)
+			if(zb)
 			{
 				for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0x0000ffff)
 					{
-						res = true;
-
-						break;
+						res = std::max<uint64>(res, m_fence_pages[*p]);
 					}
 				}
 			}
@@ -729,8 +783,10 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 	return res;
 }
 
-bool GSRendererSW::CheckSourcePages(SharedData* sd)
+uint64 GSRendererSW::CheckSourcePages(SharedData* sd)
 {
+	uint64 res = 0;
+
 	if(!m_rl->IsSynced())
 	{
 		for(size_t i = 0; sd->m_tex[i].t != NULL; i++)
@@ -743,15 +799,15 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 			{
 				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-				if(m_fzb_pages[*p]) // currently being drawn to? => sync
+				if(m_fzb_pages[*p]) // currently being drawn to? => wait for the last draw using it
 				{
-					return true;
+					res = std::max<uint64>(res, m_fence_pages[*p]);
 				}
 			}
 		}
 	}
 
-	return false;
+	return res;
 }
 
 #include "GSTextureSW.h"
@@ -1231,7 +1287,8 @@ GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
 	, m_fpsm(0)
 	, m_zpsm(0)
 	, m_using_pages(false)
-	, m_syncpoint(SyncNone)
+	, m_sync_source(0)
+	, m_sync_target(0)
 {
 	m_tex[0].t = NULL;
 
@@ -47,7 +47,8 @@ class GSRendererSW : public GSRenderer
 		int m_zpsm;
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
-		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
+		uint64 m_sync_source; // fence to wait for before updating the textures, 0 if none
+		uint64 m_sync_target; // fence to wait for before drawing, 0 if none
 
 	public:
 		SharedData(GSRendererSW* parent);
@@ -78,6 +79,9 @@ protected:
 	std::atomic<uint32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<uint16> m_tex_pages[512];
 	uint32 m_tmp_pages[512 + 1];
+	uint64 m_fence_pages[512]; // fence of the last queued draw using the page
+	uint64 m_fence;
+	uint64 m_sync_ticks; // rdtsc ticks spent waiting on the rasterizer threads
 
 	void Reset();
 	void VSync(int field);
@@ -87,15 +91,16 @@ protected:
 
 	void Draw();
 	void Queue(std::shared_ptr<GSRasterizerData>& item);
-	void Sync(int reason);
+	void Sync(GSPerfMon::sync_t reason);
+	void Wait(GSPerfMon::sync_t reason, uint64 fence);
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
 	void UsePages(const uint32* pages, const int type);
 	void ReleasePages(const uint32* pages, const int type);
 
-	bool CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
-	bool CheckSourcePages(SharedData* sd);
+	uint64 CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
+	uint64 CheckSourcePages(SharedData* sd);
 
 	bool GetScanlineGlobalData(SharedData* data);
 
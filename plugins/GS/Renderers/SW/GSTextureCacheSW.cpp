@@ -25,6 +25,8 @@
 GSTextureCacheSW::GSTextureCacheSW(GSState* state)
 	: m_state(state)
 {
+	memset(m_resident, 0, sizeof(m_resident));
+	memset(&m_stats, 0, sizeof(m_stats));
 }
 
 GSTextureCacheSW::~GSTextureCacheSW()
@@ -34,19 +36,16 @@ GSTextureCacheSW::~GSTextureCacheSW()
 
 GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0)
 {
-	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
+	uint64 start = __rdtsc();
 
-	auto& m = m_map[TEX0.TBP0 >> 5];
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 
-	for(auto i = m.begin(); i != m.end(); ++i)
-	{
-		Texture* t = *i;
+	std::vector<Texture*>& v = m_index[GetKey(TEX0)];
 
-		if(((TEX0.u32[0] ^ t->m_TEX0.u32[0]) | ((TEX0.u32[1] ^ t->m_TEX0.u32[1]) & 3)) != 0) // TBP0 TBW PSM TW TH
-		{
-			continue;
-		}
+	m_stats.lookups++;
 
+	for(Texture* t : v)
+	{
 		if((psm.trbpp == 16 || psm.trbpp == 24) && TEX0.TCC && TEXA != t->m_TEXA)
 		{
 			continue;
@@ -58,8 +57,8 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 		}
 
 		// Lookup hit
-		m.MoveFront(i.Index());
 		t->m_age = 0;
+		m_stats.lookup += __rdtsc() - start;
 		return t;
 	}
 
@@ -68,21 +67,43 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 
 	m_textures.insert(t);
 
+	v.push_back(t);
+
 	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
 	{
 		const uint32 page = *p;
 		t->m_erase_it[page] = m_map[page].InsertFront(t);
 	}
 
+	// every page of the texture now has an entry in m_map
+
+	for(size_t i = 0; i < countof(m_resident); i += 4)
+	{
+		GSVector4i r = GSVector4i::load<true>(&m_resident[i]);
+		GSVector4i b = GSVector4i::load<false>(&t->m_pages.bm[i]);
+
+		GSVector4i::store<true>(&m_resident[i], r | b);
+	}
+
+	m_stats.misses++;
+	m_stats.lookup += __rdtsc() - start;
+
 	return t;
 }
 
 void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 {
+	uint64 start = __rdtsc();
+
 	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
 	{
 		const uint32 page = *p;
-		
+
+		if((m_resident[page >> 5] & (1u << (page & 31))) == 0)
+		{
+			continue;
+		}
+
 		for(Texture* t : m_map[page])
 		{
 			if(GSUtil::HasSharedBits(psm, t->m_sharedbits))
@@ -105,6 +126,45 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 			}
 		}
 	}
+
+	m_stats.invalidate += __rdtsc() - start;
+}
+
+void GSTextureCacheSW::Remove(Texture* t)
+{
+	auto i = m_index.find(GetKey(t->m_TEX0));
+
+	if(i != m_index.end())
+	{
+		std::vector<Texture*>& v = i->second;
+
+		auto j = std::find(v.begin(), v.end(), t);
+
+		if(j != v.end())
+		{
+			*j = v.back();
+			v.pop_back();
+		}
+
+		if(v.empty())
+		{
+			m_index.erase(i);
+		}
+	}
+
+	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+	{
+		const uint32 page = *p;
+
+		m_map[page].EraseIndex(t->m_erase_it[page]);
+
+		if(m_map[page].empty())
+		{
+			m_resident[page >> 5] &= ~(1u << (page & 31));
+		}
+	}
+
+	delete t;
 }
 
 void GSTextureCacheSW::RemoveAll()
@@ -113,10 +173,14 @@ void GSTextureCacheSW::RemoveAll()
 
 	m_textures.clear();
 
+	m_index.clear();
+
 	for(auto& l : m_map)
 	{
 		l.clear();
 	}
+
+	memset(m_resident, 0, sizeof(m_resident));
 }
 
 void GSTextureCacheSW::IncAge()
@@ -129,13 +193,7 @@ void GSTextureCacheSW::IncAge()
 		{
 			i = m_textures.erase(i);
 
-			for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-			{
-				const uint32 page = *p;
-				m_map[page].EraseIndex(t->m_erase_it[page]);
-			}
-
-			delete t;
+			Remove(t);
 		}
 		else
 		{
@@ -144,6 +202,18 @@ void GSTextureCacheSW::IncAge()
 	}
 }
 
+GSTextureCacheSW::Stats GSTextureCacheSW::GetStats(bool reset)
+{
+	Stats stats = m_stats;
+
+	if(reset)
+	{
+		memset(&m_stats, 0, sizeof(m_stats));
+	}
+
+	return stats;
+}
+
 //
 
 GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
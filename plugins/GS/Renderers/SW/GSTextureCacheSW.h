@@ -56,10 +56,25 @@ public:
 		bool Save(const std::string& fn, bool dds = false) const;
 	};
 
+	struct Stats
+	{
+		uint64 lookup; // rdtsc ticks spent in Lookup
+		uint64 invalidate; // rdtsc ticks spent in InvalidatePages
+		uint32 lookups;
+		uint32 misses;
+	};
+
 protected:
 	GSState* m_state;
 	std::unordered_set<Texture*> m_textures;
+	std::unordered_map<uint64, std::vector<Texture*>> m_index; // TBP0 TBW PSM TW TH => textures
 	std::array<FastList<Texture*>, MAX_PAGES> m_map;
+	alignas(16) uint32 m_resident[MAX_PAGES / 32]; // pages with a non-empty m_map entry
+	Stats m_stats;
+
+	static uint64 GetKey(const GIFRegTEX0& TEX0) {return (uint64)TEX0.u32[0] | ((uint64)(TEX0.u32[1] & 3) << 32);}
+
+	void Remove(Texture* t);
 
 public:
 	GSTextureCacheSW(GSState* state);
@@ -71,4 +86,6 @@ public:
 
 	void RemoveAll();
 	void IncAge();
+
+	Stats GetStats(bool reset = true);
 };
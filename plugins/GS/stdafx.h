@@ -228,7 +228,7 @@ typedef int64 sint64;
 #endif
 
 // sse
-#if defined(__GNUC__)
+#if defined(__GNUC__) && !defined(_M_SSE)
 
 // Convert gcc see define into GSdx (windows) define
 #if defined(__AVX2__)